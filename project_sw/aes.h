@@ -12,6 +12,37 @@ extern "C" {
 	CRYPTO_STATUS AES_encrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]);
 	CRYPTO_STATUS AES_decrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]);
 	CRYPTO_STATUS AES_CTR_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out, uint8_t nonce_counter[AES_BLOCK_SIZE]);
+	CRYPTO_STATUS AES_CTR_crypt_at(const AES_CTX* ctx, const uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t byte_offset, const uint8_t* in, size_t length, uint8_t* out);
+	CRYPTO_STATUS AES_ECB_encrypt_blocks(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out);
+	CRYPTO_STATUS AES_ECB_decrypt_blocks(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out);
+	CRYPTO_STATUS AES_CBC_encrypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out, uint8_t iv[AES_BLOCK_SIZE]);
+	CRYPTO_STATUS AES_CBC_decrypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out, uint8_t iv[AES_BLOCK_SIZE]);
+
+	// AES 구현(백엔드) 종류 - 런타임에 CPU 기능을 보고 자동 선택됨
+	typedef enum {
+		AES_IMPL_AUTO = 0,  // 자동 선택 (사용 가능한 가장 빠른 구현)
+		AES_IMPL_TABLE,     // T-tables 기반 포터블 구현
+		AES_IMPL_BITSLICE,  // 비트슬라이스 상수시간 포터블 구현 (CTR 전용, 단일 블록/ECB/CBC는 T-tables 사용)
+		AES_IMPL_VPAES,     // SSSE3 PSHUFB 벡터 순열 상수시간 구현 (AES-NI가 없는 x86)
+		AES_IMPL_AESNI,     // x86 AES-NI 하드웨어 명령어
+		AES_IMPL_VAES_AVX2, // VAES + AVX2 (256비트 레지스터, CTR 16블록 단위)
+		AES_IMPL_VAES_AVX512 // VAES + AVX-512 (512비트 레지스터, CTR 32블록 단위)
+	} AES_IMPL;
+
+	// 구현 강제 지정 (테스트/벤치마크용). 사용 불가능한 구현이면 CRYPTO_ERR_INVALID_ARGUMENT
+	CRYPTO_STATUS AES_set_impl(AES_IMPL impl);
+	AES_IMPL AES_get_impl(void);              // 현재 사용 중인 구현 (AUTO는 실제 구현으로 변환됨)
+	int AES_impl_available(AES_IMPL impl);    // 이 CPU에서 사용 가능하면 1
+	const char* AES_impl_name(AES_IMPL impl);
+
+	// 멀티스레드 CTR 설정: length >= threshold_bytes인 AES_CTR_crypt 호출은 여러 스레드로 나눠 처리
+	// workers: 0 = CPU 코어 수(기본값), 1 = 항상 직렬, N = 최대 N개 (64개로 제한). 기본 임계값은 256KB
+	// 결과와 nonce_counter 증가량은 직렬 처리와 동일. 음수 workers는 CRYPTO_ERR_INVALID_ARGUMENT
+	CRYPTO_STATUS AES_CTR_set_parallel(size_t threshold_bytes, int workers);
+
+	// AES_CTR_crypt_at과 같지만 길이와 관계없이 호출한 스레드에서만 처리
+	// 데이터를 이미 여러 스레드로 나눠 처리하는 호출자용 (작업 스레드 안에서 다시 스레드를 만들지 않도록)
+	CRYPTO_STATUS AES_CTR_crypt_at_serial(const AES_CTX* ctx, const uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t byte_offset, const uint8_t* in, size_t length, uint8_t* out);
 
 	// 테스트 함수 (aes.c 내부 구현)
 	int test_aes(void);
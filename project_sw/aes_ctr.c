@@ -15,6 +15,18 @@
 #endif
 
 #include "crypto_api.h"
+#include "aes.h"
+
+// x86/x64 빌드에서만 하드웨어 AES 백엔드를 포함 (ARM 등에서는 T-tables만 사용)
+#ifdef PLATFORM_X86
+#define AES_HAVE_AESNI 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define AES_TARGET(features)   // MSVC는 별도 컴파일 옵션 없이 intrinsic 사용 가능
+#else
+#define AES_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
 
 /*****************************************************
  * AES (Advanced Encryption Standard) 내부 헬퍼 함수들
@@ -28,7 +40,17 @@
  * 일반적인 곱셈과 달리, 최상위 비트(MSB)가 1이면 XOR 연산(0x1b)이 추가로 발생합니다.
  * 이는 곱셈 결과가 1바이트(8비트)를 넘어가지 않도록 보장하기 위함입니다.
  */
-#define xtimes(input) (((input) << 1) ^ (((input) >> 7) * 0x1b))
+#define xtimes(input) ((((input) << 1) ^ (((input) >> 7) * 0x1b)) & 0xff)
+
+// S-Box 값 목록을 X(값) 형태로 나열한 매크로에서 배열/테이블 원소를 만드는 헬퍼
+#define AES_BYTE(s) s,
+
+// T-tables를 캐시 라인(64바이트) 경계에 맞춰 테이블 하나가 최소 개수의 L1 라인만 차지하도록 함
+#if defined(_MSC_VER)
+#define AES_ALIGN64 __declspec(align(64))
+#else
+#define AES_ALIGN64 __attribute__((aligned(64)))
+#endif
 
 /**
  * @brief s_box: SubBytes 연산에 사용되는 치환 테이블.
@@ -36,47 +58,49 @@
  * 완전히 대체하여, 암호문이 원래 평문과 통계적 관계를 갖기 어렵게 만듭니다. (혼돈 효과)
  * 이 테이블 값은 특정 수학적 계산(역원 계산 + 아핀 변환)을 통해 설계되었습니다.
  */
-static const uint8_t s_box[256] = {
-    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
-    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
-    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
-    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
-    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
-    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
-    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
-    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
-    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
-    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
-    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
-    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
-    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
-    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
-    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
-    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
-};
+#define AES_SBOX_VALUES(X) \
+    X(0x63) X(0x7c) X(0x77) X(0x7b) X(0xf2) X(0x6b) X(0x6f) X(0xc5) X(0x30) X(0x01) X(0x67) X(0x2b) X(0xfe) X(0xd7) X(0xab) X(0x76) \
+    X(0xca) X(0x82) X(0xc9) X(0x7d) X(0xfa) X(0x59) X(0x47) X(0xf0) X(0xad) X(0xd4) X(0xa2) X(0xaf) X(0x9c) X(0xa4) X(0x72) X(0xc0) \
+    X(0xb7) X(0xfd) X(0x93) X(0x26) X(0x36) X(0x3f) X(0xf7) X(0xcc) X(0x34) X(0xa5) X(0xe5) X(0xf1) X(0x71) X(0xd8) X(0x31) X(0x15) \
+    X(0x04) X(0xc7) X(0x23) X(0xc3) X(0x18) X(0x96) X(0x05) X(0x9a) X(0x07) X(0x12) X(0x80) X(0xe2) X(0xeb) X(0x27) X(0xb2) X(0x75) \
+    X(0x09) X(0x83) X(0x2c) X(0x1a) X(0x1b) X(0x6e) X(0x5a) X(0xa0) X(0x52) X(0x3b) X(0xd6) X(0xb3) X(0x29) X(0xe3) X(0x2f) X(0x84) \
+    X(0x53) X(0xd1) X(0x00) X(0xed) X(0x20) X(0xfc) X(0xb1) X(0x5b) X(0x6a) X(0xcb) X(0xbe) X(0x39) X(0x4a) X(0x4c) X(0x58) X(0xcf) \
+    X(0xd0) X(0xef) X(0xaa) X(0xfb) X(0x43) X(0x4d) X(0x33) X(0x85) X(0x45) X(0xf9) X(0x02) X(0x7f) X(0x50) X(0x3c) X(0x9f) X(0xa8) \
+    X(0x51) X(0xa3) X(0x40) X(0x8f) X(0x92) X(0x9d) X(0x38) X(0xf5) X(0xbc) X(0xb6) X(0xda) X(0x21) X(0x10) X(0xff) X(0xf3) X(0xd2) \
+    X(0xcd) X(0x0c) X(0x13) X(0xec) X(0x5f) X(0x97) X(0x44) X(0x17) X(0xc4) X(0xa7) X(0x7e) X(0x3d) X(0x64) X(0x5d) X(0x19) X(0x73) \
+    X(0x60) X(0x81) X(0x4f) X(0xdc) X(0x22) X(0x2a) X(0x90) X(0x88) X(0x46) X(0xee) X(0xb8) X(0x14) X(0xde) X(0x5e) X(0x0b) X(0xdb) \
+    X(0xe0) X(0x32) X(0x3a) X(0x0a) X(0x49) X(0x06) X(0x24) X(0x5c) X(0xc2) X(0xd3) X(0xac) X(0x62) X(0x91) X(0x95) X(0xe4) X(0x79) \
+    X(0xe7) X(0xc8) X(0x37) X(0x6d) X(0x8d) X(0xd5) X(0x4e) X(0xa9) X(0x6c) X(0x56) X(0xf4) X(0xea) X(0x65) X(0x7a) X(0xae) X(0x08) \
+    X(0xba) X(0x78) X(0x25) X(0x2e) X(0x1c) X(0xa6) X(0xb4) X(0xc6) X(0xe8) X(0xdd) X(0x74) X(0x1f) X(0x4b) X(0xbd) X(0x8b) X(0x8a) \
+    X(0x70) X(0x3e) X(0xb5) X(0x66) X(0x48) X(0x03) X(0xf6) X(0x0e) X(0x61) X(0x35) X(0x57) X(0xb9) X(0x86) X(0xc1) X(0x1d) X(0x9e) \
+    X(0xe1) X(0xf8) X(0x98) X(0x11) X(0x69) X(0xd9) X(0x8e) X(0x94) X(0x9b) X(0x1e) X(0x87) X(0xe9) X(0xce) X(0x55) X(0x28) X(0xdf) \
+    X(0x8c) X(0xa1) X(0x89) X(0x0d) X(0xbf) X(0xe6) X(0x42) X(0x68) X(0x41) X(0x99) X(0x2d) X(0x0f) X(0xb0) X(0x54) X(0xbb) X(0x16)
+
+static const uint8_t s_box[256] = { AES_SBOX_VALUES(AES_BYTE) };
 
 /**
  * @brief inv_s_box: Inverse SubBytes 연산에 사용되는 역 치환 테이블.
  * * 복호화 시 S-Box의 역함수로 사용됩니다.
  */
-static const uint8_t inv_s_box[256] = {
-    0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
-    0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
-    0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
-    0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
-    0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
-    0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
-    0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
-    0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
-    0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
-    0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
-    0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
-    0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
-    0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
-    0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
-    0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
-    0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
-};
+#define AES_INV_SBOX_VALUES(X) \
+    X(0x52) X(0x09) X(0x6a) X(0xd5) X(0x30) X(0x36) X(0xa5) X(0x38) X(0xbf) X(0x40) X(0xa3) X(0x9e) X(0x81) X(0xf3) X(0xd7) X(0xfb) \
+    X(0x7c) X(0xe3) X(0x39) X(0x82) X(0x9b) X(0x2f) X(0xff) X(0x87) X(0x34) X(0x8e) X(0x43) X(0x44) X(0xc4) X(0xde) X(0xe9) X(0xcb) \
+    X(0x54) X(0x7b) X(0x94) X(0x32) X(0xa6) X(0xc2) X(0x23) X(0x3d) X(0xee) X(0x4c) X(0x95) X(0x0b) X(0x42) X(0xfa) X(0xc3) X(0x4e) \
+    X(0x08) X(0x2e) X(0xa1) X(0x66) X(0x28) X(0xd9) X(0x24) X(0xb2) X(0x76) X(0x5b) X(0xa2) X(0x49) X(0x6d) X(0x8b) X(0xd1) X(0x25) \
+    X(0x72) X(0xf8) X(0xf6) X(0x64) X(0x86) X(0x68) X(0x98) X(0x16) X(0xd4) X(0xa4) X(0x5c) X(0xcc) X(0x5d) X(0x65) X(0xb6) X(0x92) \
+    X(0x6c) X(0x70) X(0x48) X(0x50) X(0xfd) X(0xed) X(0xb9) X(0xda) X(0x5e) X(0x15) X(0x46) X(0x57) X(0xa7) X(0x8d) X(0x9d) X(0x84) \
+    X(0x90) X(0xd8) X(0xab) X(0x00) X(0x8c) X(0xbc) X(0xd3) X(0x0a) X(0xf7) X(0xe4) X(0x58) X(0x05) X(0xb8) X(0xb3) X(0x45) X(0x06) \
+    X(0xd0) X(0x2c) X(0x1e) X(0x8f) X(0xca) X(0x3f) X(0x0f) X(0x02) X(0xc1) X(0xaf) X(0xbd) X(0x03) X(0x01) X(0x13) X(0x8a) X(0x6b) \
+    X(0x3a) X(0x91) X(0x11) X(0x41) X(0x4f) X(0x67) X(0xdc) X(0xea) X(0x97) X(0xf2) X(0xcf) X(0xce) X(0xf0) X(0xb4) X(0xe6) X(0x73) \
+    X(0x96) X(0xac) X(0x74) X(0x22) X(0xe7) X(0xad) X(0x35) X(0x85) X(0xe2) X(0xf9) X(0x37) X(0xe8) X(0x1c) X(0x75) X(0xdf) X(0x6e) \
+    X(0x47) X(0xf1) X(0x1a) X(0x71) X(0x1d) X(0x29) X(0xc5) X(0x89) X(0x6f) X(0xb7) X(0x62) X(0x0e) X(0xaa) X(0x18) X(0xbe) X(0x1b) \
+    X(0xfc) X(0x56) X(0x3e) X(0x4b) X(0xc6) X(0xd2) X(0x79) X(0x20) X(0x9a) X(0xdb) X(0xc0) X(0xfe) X(0x78) X(0xcd) X(0x5a) X(0xf4) \
+    X(0x1f) X(0xdd) X(0xa8) X(0x33) X(0x88) X(0x07) X(0xc7) X(0x31) X(0xb1) X(0x12) X(0x10) X(0x59) X(0x27) X(0x80) X(0xec) X(0x5f) \
+    X(0x60) X(0x51) X(0x7f) X(0xa9) X(0x19) X(0xb5) X(0x4a) X(0x0d) X(0x2d) X(0xe5) X(0x7a) X(0x9f) X(0x93) X(0xc9) X(0x9c) X(0xef) \
+    X(0xa0) X(0xe0) X(0x3b) X(0x4d) X(0xae) X(0x2a) X(0xf5) X(0xb0) X(0xc8) X(0xeb) X(0xbb) X(0x3c) X(0x83) X(0x53) X(0x99) X(0x61) \
+    X(0x17) X(0x2b) X(0x04) X(0x7e) X(0xba) X(0x77) X(0xd6) X(0x26) X(0xe1) X(0x69) X(0x14) X(0x63) X(0x55) X(0x21) X(0x0c) X(0x7d)
+
+static const uint8_t inv_s_box[256] = { AES_INV_SBOX_VALUES(AES_BYTE) };
 
 /**
  * @brief Rcon: 라운드 상수(Round Constant). 키 스케줄링에서 사용됩니다.
@@ -86,199 +110,238 @@ static const uint8_t inv_s_box[256] = {
  */
 static const uint8_t Rcon[11] = { 0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36 };
 
+// GF(2^8) 상수 곱셈 (xtimes 조합, 컴파일 타임 상수식으로도 사용됨)
+#define xtimes_3(input) (xtimes(input) ^ (input))  // 3·a = 2·a ^ a
+#define xtimes_9(input) (xtimes(xtimes(xtimes(input))) ^ (input))  // 9·a
+#define xtimes_11(input) (xtimes(xtimes(xtimes(input))) ^ xtimes(input) ^ (input))  // 11·a
+#define xtimes_13(input) (xtimes(xtimes(xtimes(input))) ^ xtimes(xtimes(input)) ^ (input))  // 13·a
+#define xtimes_14(input) (xtimes(xtimes(xtimes(input))) ^ xtimes(xtimes(input)) ^ xtimes(input))  // 14·a
+
+// 4바이트 [b0, b1, b2, b3]를 하나의 uint32_t로 패킹 (b0가 최하위 바이트)
+#define AES_PACK(b0, b1, b2, b3) ((uint32_t)(b0) | ((uint32_t)(b1) << 8) | ((uint32_t)(b2) << 16) | ((uint32_t)(b3) << 24))
+
 /**
  * @brief T-tables: SubBytes와 MixColumns를 결합한 최적화 테이블 (암호화용)
  * * 각 테이블은 256개의 32비트 값을 포함하며, SubBytes와 MixColumns를 한 번에 수행합니다.
  * * T0, T1, T2, T3는 MixColumns 행렬의 각 열에 대응됩니다.
- * * 각 32비트 값은 [b0, b1, b2, b3] 4바이트를 하나의 uint32_t로 패킹한 것입니다.
+ * * S-Box 값 목록 매크로로부터 컴파일 타임에 생성되는 static const 데이터이므로
+ *   런타임 초기화나 초기화 플래그 검사가 없고, 여러 스레드에서 동시에 읽어도 안전합니다.
  */
-static uint32_t T0[256], T1[256], T2[256], T3[256];
-static int tables_initialized = 0;
+#define TE0_ENTRY(s) AES_PACK(xtimes(s), (s), (s), xtimes_3(s)),   // [2·S, 1·S, 1·S, 3·S]
+#define TE1_ENTRY(s) AES_PACK(xtimes_3(s), xtimes(s), (s), (s)),   // [3·S, 2·S, 1·S, 1·S]
+#define TE2_ENTRY(s) AES_PACK((s), xtimes_3(s), xtimes(s), (s)),   // [1·S, 3·S, 2·S, 1·S]
+#define TE3_ENTRY(s) AES_PACK((s), (s), xtimes_3(s), xtimes(s)),   // [1·S, 1·S, 3·S, 2·S]
+
+static const AES_ALIGN64 uint32_t T0[256] = { AES_SBOX_VALUES(TE0_ENTRY) };
+static const AES_ALIGN64 uint32_t T1[256] = { AES_SBOX_VALUES(TE1_ENTRY) };
+static const AES_ALIGN64 uint32_t T2[256] = { AES_SBOX_VALUES(TE2_ENTRY) };
+static const AES_ALIGN64 uint32_t T3[256] = { AES_SBOX_VALUES(TE3_ENTRY) };
 
 /**
  * @brief Inverse T-tables: Inverse SubBytes와 Inverse MixColumns를 결합한 최적화 테이블 (복호화용)
- * * 복호화 시 사용되는 T-tables입니다.
+ * * Inverse MixColumns 행렬 [14, 11, 13, 9]를 사용하며, T-tables와 같이 컴파일 타임에 생성됩니다.
  */
-static uint32_t IT0[256], IT1[256], IT2[256], IT3[256];
-static int inv_tables_initialized = 0;
+#define TD0_ENTRY(s) AES_PACK(xtimes_14(s), xtimes_9(s), xtimes_13(s), xtimes_11(s)),   // [14·S, 9·S, 13·S, 11·S]
+#define TD1_ENTRY(s) AES_PACK(xtimes_11(s), xtimes_14(s), xtimes_9(s), xtimes_13(s)),   // [11·S, 14·S, 9·S, 13·S]
+#define TD2_ENTRY(s) AES_PACK(xtimes_13(s), xtimes_11(s), xtimes_14(s), xtimes_9(s)),   // [13·S, 11·S, 14·S, 9·S]
+#define TD3_ENTRY(s) AES_PACK(xtimes_9(s), xtimes_13(s), xtimes_11(s), xtimes_14(s)),   // [9·S, 13·S, 11·S, 14·S]
+
+static const AES_ALIGN64 uint32_t IT0[256] = { AES_INV_SBOX_VALUES(TD0_ENTRY) };
+static const AES_ALIGN64 uint32_t IT1[256] = { AES_INV_SBOX_VALUES(TD1_ENTRY) };
+static const AES_ALIGN64 uint32_t IT2[256] = { AES_INV_SBOX_VALUES(TD2_ENTRY) };
+static const AES_ALIGN64 uint32_t IT3[256] = { AES_INV_SBOX_VALUES(TD3_ENTRY) };
+
+// --- 워드 단위 T-tables 코어 ---
+// state를 열(column) 워드 4개로 유지합니다. 워드의 최하위 바이트가 0행이며,
+// 이는 T-tables의 패킹 순서, 그리고 round_keys 배열을 리틀엔디언 워드로 읽은 값과 같습니다.
+// ShiftRows는 별도 연산 없이 T-table 인덱스를 고를 때 각 행을 다른 열에서 읽는 것으로 대신합니다.
+
+// 리틀엔디언 32비트 읽기/쓰기 (엔디언과 정렬에 무관, 컴파일러가 단일 load/store로 최적화)
+static uint32_t load32_le(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
 
-// xtimes의 역함수 (GF(2^8)에서 곱셈 연산)
-#define xtimes_3(input) (xtimes(input) ^ (input))  // 3·a = 2·a ^ a
-#define xtimes_9(input) (xtimes(xtimes(xtimes(input)))) ^ input  // 9·a
-#define xtimes_11(input) (xtimes(xtimes(xtimes(input)))) ^ xtimes(input) ^ input  // 11·a
-#define xtimes_13(input) (xtimes(xtimes(xtimes(input)))) ^ xtimes(xtimes(input)) ^ input  // 13·a
-#define xtimes_14(input) (xtimes(xtimes(xtimes(input)))) ^ xtimes(xtimes(input)) ^ xtimes(input)  // 14·a
-
-// T-tables 초기화 함수 (암호화용)
-static void init_tables(void) {
-    if (tables_initialized) return;
-    
-    for (int i = 0; i < 256; i++) {
-        uint8_t s = s_box[i];
-        uint8_t s2 = xtimes(s);      // 2·S[a]
-        uint8_t s3 = s2 ^ s;         // 3·S[a]
-        
-        // T0[a] = [2·S[a], 1·S[a], 1·S[a], 3·S[a]]
-        T0[i] = ((uint32_t)s2) | ((uint32_t)s << 8) | ((uint32_t)s << 16) | ((uint32_t)s3 << 24);
-        
-        // T1[a] = [3·S[a], 2·S[a], 1·S[a], 1·S[a]]
-        T1[i] = ((uint32_t)s3) | ((uint32_t)s2 << 8) | ((uint32_t)s << 16) | ((uint32_t)s << 24);
-        
-        // T2[a] = [1·S[a], 3·S[a], 2·S[a], 1·S[a]]
-        T2[i] = ((uint32_t)s) | ((uint32_t)s3 << 8) | ((uint32_t)s2 << 16) | ((uint32_t)s << 24);
-        
-        // T3[a] = [1·S[a], 1·S[a], 3·S[a], 2·S[a]]
-        T3[i] = ((uint32_t)s) | ((uint32_t)s << 8) | ((uint32_t)s3 << 16) | ((uint32_t)s2 << 24);
+static void store32_le(uint8_t* p, uint32_t x) {
+    p[0] = (uint8_t)x; p[1] = (uint8_t)(x >> 8); p[2] = (uint8_t)(x >> 16); p[3] = (uint8_t)(x >> 24);
+}
+
+// --- CTR 공통 헬퍼 ---
+// 128비트 big-endian 카운터는 (상위 64비트, 하위 64비트) 정수 두 개로 다루며,
+// 하위 64비트에서 자리올림이 날 때만 상위(nonce 쪽) 절반을 증가시킵니다.
+
+static void ctr_split(const uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t* hi, uint64_t* lo) {
+    uint64_t h = 0, l = 0;
+    for (int i = 0; i < 8; i++) {
+        h = (h << 8) | nonce_counter[i];
+        l = (l << 8) | nonce_counter[8 + i];
     }
-    
-    tables_initialized = 1;
+    *hi = h;
+    *lo = l;
 }
 
-// Inverse T-tables 초기화 함수 (복호화용)
-static void init_inv_tables(void) {
-    if (inv_tables_initialized) return;
-    
-    for (int i = 0; i < 256; i++) {
-        uint8_t s = inv_s_box[i];
-        uint8_t s9 = xtimes(xtimes(xtimes(s))) ^ s;      // 9·S[a]
-        uint8_t s11 = xtimes(xtimes(xtimes(s))) ^ xtimes(s) ^ s;  // 11·S[a]
-        uint8_t s13 = xtimes(xtimes(xtimes(s))) ^ xtimes(xtimes(s)) ^ s;  // 13·S[a]
-        uint8_t s14 = xtimes(xtimes(xtimes(s))) ^ xtimes(xtimes(s)) ^ xtimes(s);  // 14·S[a]
-        
-        // Inverse MixColumns 행렬: [14, 11, 13, 9]
-        // IT0[a] = [14·S[a], 9·S[a], 13·S[a], 11·S[a]]
-        IT0[i] = ((uint32_t)s14) | ((uint32_t)s9 << 8) | ((uint32_t)s13 << 16) | ((uint32_t)s11 << 24);
-        
-        // IT1[a] = [11·S[a], 14·S[a], 9·S[a], 13·S[a]]
-        IT1[i] = ((uint32_t)s11) | ((uint32_t)s14 << 8) | ((uint32_t)s9 << 16) | ((uint32_t)s13 << 24);
-        
-        // IT2[a] = [13·S[a], 11·S[a], 14·S[a], 9·S[a]]
-        IT2[i] = ((uint32_t)s13) | ((uint32_t)s11 << 8) | ((uint32_t)s14 << 16) | ((uint32_t)s9 << 24);
-        
-        // IT3[a] = [9·S[a], 13·S[a], 11·S[a], 14·S[a]]
-        IT3[i] = ((uint32_t)s9) | ((uint32_t)s13 << 8) | ((uint32_t)s11 << 16) | ((uint32_t)s14 << 24);
+static void ctr_join(uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t hi, uint64_t lo) {
+    for (int i = 7; i >= 0; i--) {
+        nonce_counter[i] = (uint8_t)hi; hi >>= 8;
+        nonce_counter[8 + i] = (uint8_t)lo; lo >>= 8;
     }
-    
-    inv_tables_initialized = 1;
 }
 
-// --- AES의 4가지 기본 연산 ---
-// AES는 16바이트(128비트) 데이터를 4x4 행렬(state)로 간주하고,
-// 이 4가지 연산을 여러 라운드에 걸쳐 반복적으로 적용합니다.
+// (hi, lo) + j 번째 카운터 블록을 big-endian 바이트로 기록
+static void ctr_make_block(uint8_t block[AES_BLOCK_SIZE], uint64_t hi, uint64_t lo, uint64_t j) {
+    uint64_t l = lo + j;
+    uint64_t h = hi + (l < lo); // 하위 64비트 자리올림
+    for (int i = 0; i < 8; i++) {
+        block[i] = (uint8_t)(h >> (56 - 8 * i));
+        block[8 + i] = (uint8_t)(l >> (56 - 8 * i));
+    }
+}
 
-/**
- * @brief SubBytes: state의 각 바이트를 S-Box를 이용해 치환합니다.
- * * T-tables 최적화: 단순히 S-Box를 사용합니다 (마지막 라운드에서만 사용).
- * @param state 4x4 크기의 데이터 블록
- */
-static void SubBytes(uint8_t state[4][4]) {
-    for (int i = 0; i < 4; i++) for (int j = 0; j < 4; j++) state[i][j] = s_box[state[i][j]];
+// (hi, lo) += blocks
+static void ctr_advance(uint64_t* hi, uint64_t* lo, uint64_t blocks) {
+    uint64_t prev = *lo;
+    *lo += blocks;
+    if (*lo < prev) (*hi)++;
 }
 
-/**
- * @brief InvSubBytes: state의 각 바이트를 Inverse S-Box를 이용해 역치환합니다 (복호화용).
- * @param state 4x4 크기의 데이터 블록
- */
-static void InvSubBytes(uint8_t state[4][4]) {
-    for (int i = 0; i < 4; i++) for (int j = 0; j < 4; j++) state[i][j] = inv_s_box[state[i][j]];
+// out = in ^ keystream. 8바이트 워드 단위로 처리하며 in == out(in-place)도 허용
+static void ctr_xor(uint8_t* out, const uint8_t* in, const uint8_t* keystream, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t d, k;
+        memcpy(&d, in + i, 8); // memcpy는 정렬/aliasing 문제 없이 단일 load/store로 컴파일됨
+        memcpy(&k, keystream + i, 8);
+        d ^= k;
+        memcpy(out + i, &d, 8);
+    }
+    for (; i < n; i++) out[i] = in[i] ^ keystream[i];
 }
 
-/**
- * @brief ShiftRows: state의 각 행을 정해진 규칙에 따라 왼쪽으로 이동시킵니다.
- * - 0행: 이동 없음
- * - 1행: 1칸 왼쪽 이동
- * - 2행: 2칸 왼쪽 이동
- * - 3행: 3칸 왼쪽 이동
- * 이 연산은 열(column) 단위로 묶여 있던 데이터들을 여러 열에 걸쳐 섞어주는 역할(확산 효과)을 합니다.
- * @param state 4x4 크기의 데이터 블록
- */
-static void ShiftRows(uint8_t state[4][4]) {
-    uint8_t temp;
-    // 1행
-    temp = state[1][0]; state[1][0] = state[1][1]; state[1][1] = state[1][2]; state[1][2] = state[1][3]; state[1][3] = temp;
-    // 2행
-    temp = state[2][0]; state[2][0] = state[2][2]; state[2][2] = temp;
-    temp = state[2][1]; state[2][1] = state[2][3]; state[2][3] = temp;
-    // 3행
-    temp = state[3][3]; state[3][3] = state[3][2]; state[3][2] = state[3][1]; state[3][1] = state[3][0]; state[3][0] = temp;
+// r번째 라운드 키의 c번째 열 워드
+#define RK(rk, r, c) load32_le((rk) + (r) * 16 + (c) * 4)
+
+#define TE_LOAD(s, in, rk) do { \
+        s##0 = load32_le((in) + 0) ^ RK(rk, 0, 0); s##1 = load32_le((in) + 4) ^ RK(rk, 0, 1); \
+        s##2 = load32_le((in) + 8) ^ RK(rk, 0, 2); s##3 = load32_le((in) + 12) ^ RK(rk, 0, 3); \
+    } while (0)
+
+// 암호화 한 라운드: ShiftRows(열 비틀어 읽기) + SubBytes + MixColumns(T-tables) + AddRoundKey
+#define TE_COL(a, b, c, d) (T0[(a) & 0xff] ^ T1[((b) >> 8) & 0xff] ^ T2[((c) >> 16) & 0xff] ^ T3[(d) >> 24])
+#define TE_ROUND(d, s, rk, r) do { \
+        d##0 = TE_COL(s##0, s##1, s##2, s##3) ^ RK(rk, r, 0); \
+        d##1 = TE_COL(s##1, s##2, s##3, s##0) ^ RK(rk, r, 1); \
+        d##2 = TE_COL(s##2, s##3, s##0, s##1) ^ RK(rk, r, 2); \
+        d##3 = TE_COL(s##3, s##0, s##1, s##2) ^ RK(rk, r, 3); \
+    } while (0)
+
+// 마지막 라운드: MixColumns 없이 S-Box만 적용
+#define TE_LAST_COL(a, b, c, d) ((uint32_t)s_box[(a) & 0xff] | ((uint32_t)s_box[((b) >> 8) & 0xff] << 8) | \
+                                 ((uint32_t)s_box[((c) >> 16) & 0xff] << 16) | ((uint32_t)s_box[(d) >> 24] << 24))
+#define TE_FINAL(out, s, rk, r) do { \
+        store32_le((out) + 0, TE_LAST_COL(s##0, s##1, s##2, s##3) ^ RK(rk, r, 0)); \
+        store32_le((out) + 4, TE_LAST_COL(s##1, s##2, s##3, s##0) ^ RK(rk, r, 1)); \
+        store32_le((out) + 8, TE_LAST_COL(s##2, s##3, s##0, s##1) ^ RK(rk, r, 2)); \
+        store32_le((out) + 12, TE_LAST_COL(s##3, s##0, s##1, s##2) ^ RK(rk, r, 3)); \
+    } while (0)
+
+// 키 길이별로 라운드를 모두 펼친 암호화 함수 (라운드마다 Nr 분기 없음)
+static void table_encrypt128(const uint8_t* rk, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+    TE_LOAD(s, in, rk);
+    TE_ROUND(t, s, rk, 1); TE_ROUND(s, t, rk, 2); TE_ROUND(t, s, rk, 3); TE_ROUND(s, t, rk, 4);
+    TE_ROUND(t, s, rk, 5); TE_ROUND(s, t, rk, 6); TE_ROUND(t, s, rk, 7); TE_ROUND(s, t, rk, 8);
+    TE_ROUND(t, s, rk, 9);
+    TE_FINAL(out, t, rk, 10);
 }
 
-/**
- * @brief InvShiftRows: state의 각 행을 정해진 규칙에 따라 오른쪽으로 이동시킵니다 (복호화용).
- * - 0행: 이동 없음
- * - 1행: 1칸 오른쪽 이동
- * - 2행: 2칸 오른쪽 이동
- * - 3행: 3칸 오른쪽 이동
- * @param state 4x4 크기의 데이터 블록
- */
-static void InvShiftRows(uint8_t state[4][4]) {
-    uint8_t temp;
-    // 1행: 1칸 오른쪽 이동
-    temp = state[1][3]; state[1][3] = state[1][2]; state[1][2] = state[1][1]; state[1][1] = state[1][0]; state[1][0] = temp;
-    // 2행: 2칸 오른쪽 이동
-    temp = state[2][0]; state[2][0] = state[2][2]; state[2][2] = temp;
-    temp = state[2][1]; state[2][1] = state[2][3]; state[2][3] = temp;
-    // 3행: 3칸 오른쪽 이동
-    temp = state[3][0]; state[3][0] = state[3][1]; state[3][1] = state[3][2]; state[3][2] = state[3][3]; state[3][3] = temp;
+static void table_encrypt192(const uint8_t* rk, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+    TE_LOAD(s, in, rk);
+    TE_ROUND(t, s, rk, 1); TE_ROUND(s, t, rk, 2); TE_ROUND(t, s, rk, 3); TE_ROUND(s, t, rk, 4);
+    TE_ROUND(t, s, rk, 5); TE_ROUND(s, t, rk, 6); TE_ROUND(t, s, rk, 7); TE_ROUND(s, t, rk, 8);
+    TE_ROUND(t, s, rk, 9); TE_ROUND(s, t, rk, 10); TE_ROUND(t, s, rk, 11);
+    TE_FINAL(out, t, rk, 12);
 }
 
-/**
- * @brief SubBytesAndMixColumns: T-tables를 사용하여 SubBytes와 MixColumns를 한 번에 수행합니다 (암호화용).
- * * T-tables 최적화: ShiftRows 후에 각 열에 대해 T-tables를 사용하여 SubBytes와 MixColumns를 동시에 수행합니다.
- * * 각 열 j에 대해: result = T0[s0] ^ T1[s1] ^ T2[s2] ^ T3[s3]
- * @param state 4x4 크기의 데이터 블록 (ShiftRows 후 상태)
- */
-static void SubBytesAndMixColumns(uint8_t state[4][4]) {
-    init_tables(); // T-tables 초기화 (최초 1회만 수행)
-    
-    for (int j = 0; j < 4; j++) {
-        uint32_t result = T0[state[0][j]] ^ T1[state[1][j]] ^ T2[state[2][j]] ^ T3[state[3][j]];
-        // 32비트 결과를 4바이트로 분리
-        state[0][j] = (uint8_t)(result & 0xFF);
-        state[1][j] = (uint8_t)((result >> 8) & 0xFF);
-        state[2][j] = (uint8_t)((result >> 16) & 0xFF);
-        state[3][j] = (uint8_t)((result >> 24) & 0xFF);
-    }
+static void table_encrypt256(const uint8_t* rk, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+    TE_LOAD(s, in, rk);
+    TE_ROUND(t, s, rk, 1); TE_ROUND(s, t, rk, 2); TE_ROUND(t, s, rk, 3); TE_ROUND(s, t, rk, 4);
+    TE_ROUND(t, s, rk, 5); TE_ROUND(s, t, rk, 6); TE_ROUND(t, s, rk, 7); TE_ROUND(s, t, rk, 8);
+    TE_ROUND(t, s, rk, 9); TE_ROUND(s, t, rk, 10); TE_ROUND(t, s, rk, 11); TE_ROUND(s, t, rk, 12);
+    TE_ROUND(t, s, rk, 13);
+    TE_FINAL(out, t, rk, 14);
 }
 
-/**
- * @brief InvSubBytesAndMixColumns: Inverse T-tables를 사용하여 InvSubBytes와 InvMixColumns를 한 번에 수행합니다 (복호화용).
- * * Inverse T-tables 최적화: InvShiftRows 후에 각 열에 대해 Inverse T-tables를 사용하여 InvSubBytes와 InvMixColumns를 동시에 수행합니다.
- * * 각 열 j에 대해: result = IT0[s0] ^ IT1[s1] ^ IT2[s2] ^ IT3[s3]
- * @param state 4x4 크기의 데이터 블록 (InvShiftRows 후 상태)
- */
-static void InvSubBytesAndMixColumns(uint8_t state[4][4]) {
-    init_inv_tables(); // Inverse T-tables 초기화 (최초 1회만 수행)
-    
-    for (int j = 0; j < 4; j++) {
-        uint32_t result = IT0[state[0][j]] ^ IT1[state[1][j]] ^ IT2[state[2][j]] ^ IT3[state[3][j]];
-        // 32비트 결과를 4바이트로 분리
-        state[0][j] = (uint8_t)(result & 0xFF);
-        state[1][j] = (uint8_t)((result >> 8) & 0xFF);
-        state[2][j] = (uint8_t)((result >> 16) & 0xFF);
-        state[3][j] = (uint8_t)((result >> 24) & 0xFF);
+// T-tables CTR 경로에서 한 번에 만드는 카운터 블록 수
+#define TABLE_CTR_PARALLEL 8
+
+// T-tables 암호화 진입점: 키 길이 분기는 블록당 한 번
+static void table_encrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    switch (ctx->Nr) {
+        case AES_ROUND_128: table_encrypt128(ctx->round_keys, in, out); break;
+        case AES_ROUND_192: table_encrypt192(ctx->round_keys, in, out); break;
+        default:            table_encrypt256(ctx->round_keys, in, out); break;
     }
 }
 
-/**
- * @brief MixColumns: state의 각 열을 GF(2^8) 상에서 특정 행렬과 곱셈 연산을 수행합니다.
- * * T-tables 최적화 버전으로 변경됨 (SubBytesAndMixColumns 사용)
- * @param state 4x4 크기의 데이터 블록
- * @note 이 함수는 더 이상 직접 호출되지 않으며, SubBytesAndMixColumns가 대신 사용됩니다.
- */
-static void MixColumns(uint8_t state[4][4]) {
-    // T-tables 최적화로 인해 이 함수는 사용되지 않음
-    // 호환성을 위해 유지하지만 실제로는 SubBytesAndMixColumns를 사용합니다.
-    SubBytesAndMixColumns(state);
+// 복호화 한 라운드: InvShiftRows(반대 방향으로 비틀어 읽기) + InvSubBytes + InvMixColumns + AddRoundKey
+// InvMixColumns가 키 덧셈보다 먼저 수행되므로 InvMixColumns를 미리 적용한 dec_round_keys를 더함 (동등 역암호)
+#define TD_COL(a, b, c, d) (IT0[(a) & 0xff] ^ IT1[((b) >> 8) & 0xff] ^ IT2[((c) >> 16) & 0xff] ^ IT3[(d) >> 24])
+#define TD_ROUND(d, s, rk, r) do { \
+        d##0 = TD_COL(s##0, s##3, s##2, s##1) ^ RK(rk, r, 0); \
+        d##1 = TD_COL(s##1, s##0, s##3, s##2) ^ RK(rk, r, 1); \
+        d##2 = TD_COL(s##2, s##1, s##0, s##3) ^ RK(rk, r, 2); \
+        d##3 = TD_COL(s##3, s##2, s##1, s##0) ^ RK(rk, r, 3); \
+    } while (0)
+
+#define TD_LOAD(s, in, rk, r) do { \
+        s##0 = load32_le((in) + 0) ^ RK(rk, r, 0); s##1 = load32_le((in) + 4) ^ RK(rk, r, 1); \
+        s##2 = load32_le((in) + 8) ^ RK(rk, r, 2); s##3 = load32_le((in) + 12) ^ RK(rk, r, 3); \
+    } while (0)
+
+#define TD_LAST_COL(a, b, c, d) ((uint32_t)inv_s_box[(a) & 0xff] | ((uint32_t)inv_s_box[((b) >> 8) & 0xff] << 8) | \
+                                 ((uint32_t)inv_s_box[((c) >> 16) & 0xff] << 16) | ((uint32_t)inv_s_box[(d) >> 24] << 24))
+#define TD_FINAL(out, s, rk) do { \
+        store32_le((out) + 0, TD_LAST_COL(s##0, s##3, s##2, s##1) ^ RK(rk, 0, 0)); \
+        store32_le((out) + 4, TD_LAST_COL(s##1, s##0, s##3, s##2) ^ RK(rk, 0, 1)); \
+        store32_le((out) + 8, TD_LAST_COL(s##2, s##1, s##0, s##3) ^ RK(rk, 0, 2)); \
+        store32_le((out) + 12, TD_LAST_COL(s##3, s##2, s##1, s##0) ^ RK(rk, 0, 3)); \
+    } while (0)
+
+static void table_decrypt128(const uint8_t* rk, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+    TD_LOAD(s, in, rk, 10);
+    TD_ROUND(t, s, rk, 9); TD_ROUND(s, t, rk, 8); TD_ROUND(t, s, rk, 7); TD_ROUND(s, t, rk, 6);
+    TD_ROUND(t, s, rk, 5); TD_ROUND(s, t, rk, 4); TD_ROUND(t, s, rk, 3); TD_ROUND(s, t, rk, 2);
+    TD_ROUND(t, s, rk, 1);
+    TD_FINAL(out, t, rk);
 }
 
-/**
- * @brief AddRoundKey: state와 현재 라운드 키를 XOR 연산합니다.
- * @param state 4x4 크기의 데이터 블록
- * @param round_key 현재 라운드에서 사용할 16바이트 라운드 키
- */
-static void AddRoundKey(uint8_t state[4][4], const uint8_t* round_key) {
-    for (int i = 0; i < 4; i++) for (int j = 0; j < 4; j++) state[j][i] ^= round_key[i * 4 + j];
+static void table_decrypt192(const uint8_t* rk, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+    TD_LOAD(s, in, rk, 12);
+    TD_ROUND(t, s, rk, 11); TD_ROUND(s, t, rk, 10); TD_ROUND(t, s, rk, 9); TD_ROUND(s, t, rk, 8);
+    TD_ROUND(t, s, rk, 7); TD_ROUND(s, t, rk, 6); TD_ROUND(t, s, rk, 5); TD_ROUND(s, t, rk, 4);
+    TD_ROUND(t, s, rk, 3); TD_ROUND(s, t, rk, 2); TD_ROUND(t, s, rk, 1);
+    TD_FINAL(out, t, rk);
+}
+
+static void table_decrypt256(const uint8_t* rk, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+    TD_LOAD(s, in, rk, 14);
+    TD_ROUND(t, s, rk, 13); TD_ROUND(s, t, rk, 12); TD_ROUND(t, s, rk, 11); TD_ROUND(s, t, rk, 10);
+    TD_ROUND(t, s, rk, 9); TD_ROUND(s, t, rk, 8); TD_ROUND(t, s, rk, 7); TD_ROUND(s, t, rk, 6);
+    TD_ROUND(t, s, rk, 5); TD_ROUND(s, t, rk, 4); TD_ROUND(t, s, rk, 3); TD_ROUND(s, t, rk, 2);
+    TD_ROUND(t, s, rk, 1);
+    TD_FINAL(out, t, rk);
+}
+
+static void table_decrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    switch (ctx->Nr) {
+        case AES_ROUND_128: table_decrypt128(ctx->dec_round_keys, in, out); break;
+        case AES_ROUND_192: table_decrypt192(ctx->dec_round_keys, in, out); break;
+        default:            table_decrypt256(ctx->dec_round_keys, in, out); break;
+    }
 }
 
 
@@ -361,6 +424,1291 @@ static void KeySchedule256(const uint8_t* key, AES_CTX* ctx) {
     }
 }
 
+/**
+ * @brief KeyScheduleInv: 복호화용 라운드 키(동등 역암호)를 round_keys로부터 만듭니다.
+ * * 0라운드와 마지막 라운드 키는 그대로, 나머지 라운드 키에는 InvMixColumns를 적용합니다.
+ * * 인덱스는 round_keys와 같으며(dec_round_keys[r]은 r라운드 키), 복호화는 Nr부터 0으로 내려가며 사용합니다.
+ * * xtimes 산술만 사용하므로 테이블 조회가 없어 상수시간 구현(bitslice/vpaes)에서도 그대로 씁니다.
+ */
+static void KeyScheduleInv(AES_CTX* ctx) {
+    const uint8_t* w = ctx->round_keys;
+    uint8_t* dw = ctx->dec_round_keys;
+
+    memcpy(dw, w, AES_BLOCK_SIZE);
+    memcpy(dw + ctx->Nr * AES_BLOCK_SIZE, w + ctx->Nr * AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+    for (int i = AES_BLOCK_SIZE; i < ctx->Nr * AES_BLOCK_SIZE; i += 4) { // 한 열(4바이트)씩 InvMixColumns
+        uint8_t a0 = w[i], a1 = w[i + 1], a2 = w[i + 2], a3 = w[i + 3];
+        dw[i + 0] = (uint8_t)(xtimes_14(a0) ^ xtimes_11(a1) ^ xtimes_13(a2) ^ xtimes_9(a3));
+        dw[i + 1] = (uint8_t)(xtimes_9(a0) ^ xtimes_14(a1) ^ xtimes_11(a2) ^ xtimes_13(a3));
+        dw[i + 2] = (uint8_t)(xtimes_13(a0) ^ xtimes_9(a1) ^ xtimes_14(a2) ^ xtimes_11(a3));
+        dw[i + 3] = (uint8_t)(xtimes_11(a0) ^ xtimes_13(a1) ^ xtimes_9(a2) ^ xtimes_14(a3));
+    }
+}
+
+
+/*****************************************************
+ * AES-NI 백엔드 (x86/x64)
+ * AESENC/AESENCLAST 명령어로 한 라운드를 1명령어에 처리하고,
+ * 키 스케줄은 AESKEYGENASSIST로 생성합니다.
+ * 생성되는 라운드 키는 T-tables 경로와 바이트 단위로 동일하므로
+ * 같은 AES_CTX를 어느 구현에서든 사용할 수 있습니다.
+ *****************************************************/
+#ifdef AES_HAVE_AESNI
+
+// CTR 커널에서 동시에 처리하는 블록 수 (AESENC 지연시간을 가리기 위해 8개를 파이프라인에 유지)
+#define AESNI_CTR_PARALLEL 8
+
+// 이전 라운드 키의 4워드 누적 XOR + AESKEYGENASSIST 결과(RotWord/SubWord/Rcon) 결합
+AES_TARGET("aes,sse2")
+static __m128i aesni_expand_step(__m128i key, __m128i assist) {
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+// AESKEYGENASSIST의 rcon은 즉시값이어야 하므로 매크로로 펼침
+#define AESNI_ASSIST(k, rcon, sel) _mm_shuffle_epi32(_mm_aeskeygenassist_si128((k), (rcon)), (sel))
+
+AES_TARGET("aes,sse2")
+static void aesni_key_schedule128(const uint8_t* key, AES_CTX* ctx) {
+    __m128i* rk = (__m128i*)ctx->round_keys;
+    __m128i k = _mm_loadu_si128((const __m128i*)key);
+
+    _mm_storeu_si128(rk + 0, k);
+    k = aesni_expand_step(k, AESNI_ASSIST(k, 0x01, 0xff)); _mm_storeu_si128(rk + 1, k);
+    k = aesni_expand_step(k, AESNI_ASSIST(k, 0x02, 0xff)); _mm_storeu_si128(rk + 2, k);
+    k = aesni_expand_step(k, AESNI_ASSIST(k, 0x04, 0xff)); _mm_storeu_si128(rk + 3, k);
+    k = aesni_expand_step(k, AESNI_ASSIST(k, 0x08, 0xff)); _mm_storeu_si128(rk + 4, k);
+    k = aesni_expand_step(k, AESNI_ASSIST(k, 0x10, 0xff)); _mm_storeu_si128(rk + 5, k);
+    k = aesni_expand_step(k, AESNI_ASSIST(k, 0x20, 0xff)); _mm_storeu_si128(rk + 6, k);
+    k = aesni_expand_step(k, AESNI_ASSIST(k, 0x40, 0xff)); _mm_storeu_si128(rk + 7, k);
+    k = aesni_expand_step(k, AESNI_ASSIST(k, 0x80, 0xff)); _mm_storeu_si128(rk + 8, k);
+    k = aesni_expand_step(k, AESNI_ASSIST(k, 0x1b, 0xff)); _mm_storeu_si128(rk + 9, k);
+    k = aesni_expand_step(k, AESNI_ASSIST(k, 0x36, 0xff)); _mm_storeu_si128(rk + 10, k);
+}
+
+// 192비트: 한 단계에 6워드(1.5 라운드 키)가 생성됨
+// lo = w[i..i+3], hi = w[i+4..i+5] (상위 8바이트는 사용하지 않음)
+AES_TARGET("aes,sse2")
+static void aesni_expand192_step(__m128i* lo, __m128i* hi, __m128i assist) {
+    *lo = aesni_expand_step(*lo, assist);
+    __m128i last = _mm_shuffle_epi32(*lo, 0xff);
+    *hi = _mm_xor_si128(*hi, _mm_slli_si128(*hi, 4));
+    *hi = _mm_xor_si128(*hi, last);
+}
+
+// 두 레지스터의 하위/상위 8바이트를 이어 붙여 라운드 키 하나를 구성
+#define AESNI_CONCAT64(a, b, sel) \
+    _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), (sel)))
+
+AES_TARGET("aes,sse2")
+static void aesni_key_schedule192(const uint8_t* key, AES_CTX* ctx) {
+    __m128i* rk = (__m128i*)ctx->round_keys;
+    __m128i lo = _mm_loadu_si128((const __m128i*)key);
+    __m128i hi = _mm_loadl_epi64((const __m128i*)(key + 16)); // 24바이트 키 이후를 읽지 않도록 8바이트만 로드
+    __m128i prev_hi = hi;
+
+    _mm_storeu_si128(rk + 0, lo);
+    aesni_expand192_step(&lo, &hi, AESNI_ASSIST(hi, 0x01, 0x55));
+    _mm_storeu_si128(rk + 1, AESNI_CONCAT64(prev_hi, lo, 0));
+    _mm_storeu_si128(rk + 2, AESNI_CONCAT64(lo, hi, 1));
+    aesni_expand192_step(&lo, &hi, AESNI_ASSIST(hi, 0x02, 0x55));
+    _mm_storeu_si128(rk + 3, lo);
+    prev_hi = hi;
+    aesni_expand192_step(&lo, &hi, AESNI_ASSIST(hi, 0x04, 0x55));
+    _mm_storeu_si128(rk + 4, AESNI_CONCAT64(prev_hi, lo, 0));
+    _mm_storeu_si128(rk + 5, AESNI_CONCAT64(lo, hi, 1));
+    aesni_expand192_step(&lo, &hi, AESNI_ASSIST(hi, 0x08, 0x55));
+    _mm_storeu_si128(rk + 6, lo);
+    prev_hi = hi;
+    aesni_expand192_step(&lo, &hi, AESNI_ASSIST(hi, 0x10, 0x55));
+    _mm_storeu_si128(rk + 7, AESNI_CONCAT64(prev_hi, lo, 0));
+    _mm_storeu_si128(rk + 8, AESNI_CONCAT64(lo, hi, 1));
+    aesni_expand192_step(&lo, &hi, AESNI_ASSIST(hi, 0x20, 0x55));
+    _mm_storeu_si128(rk + 9, lo);
+    prev_hi = hi;
+    aesni_expand192_step(&lo, &hi, AESNI_ASSIST(hi, 0x40, 0x55));
+    _mm_storeu_si128(rk + 10, AESNI_CONCAT64(prev_hi, lo, 0));
+    _mm_storeu_si128(rk + 11, AESNI_CONCAT64(lo, hi, 1));
+    aesni_expand192_step(&lo, &hi, AESNI_ASSIST(hi, 0x80, 0x55));
+    _mm_storeu_si128(rk + 12, lo);
+}
+
+// 256비트: 짝수 라운드 키는 RotWord+SubWord+Rcon, 홀수 라운드 키는 SubWord만 적용 (selector 0xaa)
+AES_TARGET("aes,sse2")
+static void aesni_key_schedule256(const uint8_t* key, AES_CTX* ctx) {
+    __m128i* rk = (__m128i*)ctx->round_keys;
+    __m128i a = _mm_loadu_si128((const __m128i*)key);
+    __m128i b = _mm_loadu_si128((const __m128i*)(key + 16));
+
+    _mm_storeu_si128(rk + 0, a);
+    _mm_storeu_si128(rk + 1, b);
+    a = aesni_expand_step(a, AESNI_ASSIST(b, 0x01, 0xff)); _mm_storeu_si128(rk + 2, a);
+    b = aesni_expand_step(b, AESNI_ASSIST(a, 0x00, 0xaa)); _mm_storeu_si128(rk + 3, b);
+    a = aesni_expand_step(a, AESNI_ASSIST(b, 0x02, 0xff)); _mm_storeu_si128(rk + 4, a);
+    b = aesni_expand_step(b, AESNI_ASSIST(a, 0x00, 0xaa)); _mm_storeu_si128(rk + 5, b);
+    a = aesni_expand_step(a, AESNI_ASSIST(b, 0x04, 0xff)); _mm_storeu_si128(rk + 6, a);
+    b = aesni_expand_step(b, AESNI_ASSIST(a, 0x00, 0xaa)); _mm_storeu_si128(rk + 7, b);
+    a = aesni_expand_step(a, AESNI_ASSIST(b, 0x08, 0xff)); _mm_storeu_si128(rk + 8, a);
+    b = aesni_expand_step(b, AESNI_ASSIST(a, 0x00, 0xaa)); _mm_storeu_si128(rk + 9, b);
+    a = aesni_expand_step(a, AESNI_ASSIST(b, 0x10, 0xff)); _mm_storeu_si128(rk + 10, a);
+    b = aesni_expand_step(b, AESNI_ASSIST(a, 0x00, 0xaa)); _mm_storeu_si128(rk + 11, b);
+    a = aesni_expand_step(a, AESNI_ASSIST(b, 0x20, 0xff)); _mm_storeu_si128(rk + 12, a);
+    b = aesni_expand_step(b, AESNI_ASSIST(a, 0x00, 0xaa)); _mm_storeu_si128(rk + 13, b);
+    a = aesni_expand_step(a, AESNI_ASSIST(b, 0x40, 0xff)); _mm_storeu_si128(rk + 14, a);
+}
+
+AES_TARGET("aes,sse2")
+static void aesni_encrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    const __m128i* rk = (const __m128i*)ctx->round_keys;
+    __m128i s = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), _mm_loadu_si128(rk));
+
+    for (int r = 1; r < ctx->Nr; r++) {
+        s = _mm_aesenc_si128(s, _mm_loadu_si128(rk + r));
+    }
+    s = _mm_aesenclast_si128(s, _mm_loadu_si128(rk + ctx->Nr));
+    _mm_storeu_si128((__m128i*)out, s);
+}
+
+// 복호화 라운드 키: AESIMC(= InvMixColumns)로 생성 (결과는 KeyScheduleInv와 동일)
+AES_TARGET("aes,sse2")
+static void aesni_key_schedule_inv(AES_CTX* ctx) {
+    const __m128i* rk = (const __m128i*)ctx->round_keys;
+    __m128i* dk = (__m128i*)ctx->dec_round_keys;
+
+    _mm_storeu_si128(dk, _mm_loadu_si128(rk));
+    for (int r = 1; r < ctx->Nr; r++) _mm_storeu_si128(dk + r, _mm_aesimc_si128(_mm_loadu_si128(rk + r)));
+    _mm_storeu_si128(dk + ctx->Nr, _mm_loadu_si128(rk + ctx->Nr));
+}
+
+AES_TARGET("aes,sse2")
+static void aesni_decrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    const __m128i* dk = (const __m128i*)ctx->dec_round_keys;
+    __m128i s = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), _mm_loadu_si128(dk + ctx->Nr));
+
+    for (int r = ctx->Nr - 1; r > 0; r--) {
+        s = _mm_aesdec_si128(s, _mm_loadu_si128(dk + r));
+    }
+    s = _mm_aesdeclast_si128(s, _mm_loadu_si128(dk));
+    _mm_storeu_si128((__m128i*)out, s);
+}
+
+/**
+ * @brief aesni_ecb_crypt: AES-NI ECB 커널 (decrypt가 0이면 암호화, 1이면 복호화).
+ * * 서로 독립인 블록 8개를 한꺼번에 라운드에 통과시킵니다 (CTR 커널과 같은 파이프라인 구성).
+ */
+AES_TARGET("aes,sse2")
+static void aesni_ecb_crypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out, int decrypt) {
+    const int nr = ctx->Nr;
+    const __m128i* src = (const __m128i*)(decrypt ? ctx->dec_round_keys : ctx->round_keys);
+    __m128i rk[AES_ROUND_256 + 1];
+    // 복호화는 라운드 키를 역순으로 적재해 두어 두 방향 모두 rk[0]부터 차례로 사용
+    for (int r = 0; r <= nr; r++) rk[r] = _mm_loadu_si128(src + (decrypt ? nr - r : r));
+
+    while (blocks > 0) {
+        __m128i b[AESNI_CTR_PARALLEL];
+        int n = (blocks < AESNI_CTR_PARALLEL) ? (int)blocks : AESNI_CTR_PARALLEL;
+        for (int j = 0; j < n; j++) b[j] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in + j), rk[0]);
+        if (decrypt) {
+            for (int r = 1; r < nr; r++) {
+                for (int j = 0; j < n; j++) b[j] = _mm_aesdec_si128(b[j], rk[r]);
+            }
+            for (int j = 0; j < n; j++) b[j] = _mm_aesdeclast_si128(b[j], rk[nr]);
+        } else {
+            for (int r = 1; r < nr; r++) {
+                for (int j = 0; j < n; j++) b[j] = _mm_aesenc_si128(b[j], rk[r]);
+            }
+            for (int j = 0; j < n; j++) b[j] = _mm_aesenclast_si128(b[j], rk[nr]);
+        }
+        for (int j = 0; j < n; j++) _mm_storeu_si128((__m128i*)out + j, b[j]);
+        in += n * AES_BLOCK_SIZE;
+        out += n * AES_BLOCK_SIZE;
+        blocks -= (size_t)n;
+    }
+}
+
+// CBC 암호화는 이전 암호문이 다음 입력이 되므로 블록 간 병렬화가 불가능 (라운드 키만 레지스터에 유지)
+AES_TARGET("aes,sse2")
+static void aesni_cbc_encrypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out,
+                              uint8_t iv[AES_BLOCK_SIZE]) {
+    const int nr = ctx->Nr;
+    __m128i rk[AES_ROUND_256 + 1];
+    for (int r = 0; r <= nr; r++) rk[r] = _mm_loadu_si128((const __m128i*)ctx->round_keys + r);
+
+    __m128i c = _mm_loadu_si128((const __m128i*)iv);
+    for (size_t i = 0; i < blocks; i++) {
+        c = _mm_xor_si128(_mm_xor_si128(_mm_loadu_si128((const __m128i*)in + i), c), rk[0]);
+        for (int r = 1; r < nr; r++) c = _mm_aesenc_si128(c, rk[r]);
+        c = _mm_aesenclast_si128(c, rk[nr]);
+        _mm_storeu_si128((__m128i*)out + i, c);
+    }
+    _mm_storeu_si128((__m128i*)iv, c);
+}
+
+/**
+ * @brief aesni_cbc_decrypt: AES-NI CBC 복호화 커널.
+ * * P[i] = D(C[i]) ^ C[i-1]이고 D(C[i])끼리는 서로 독립이므로 8블록씩 병렬로 복호화합니다.
+ * * 암호문 블록을 레지스터에 보관한 뒤 결과를 쓰므로 in == out (in-place)도 안전합니다.
+ */
+AES_TARGET("aes,sse2")
+static void aesni_cbc_decrypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out,
+                              uint8_t iv[AES_BLOCK_SIZE]) {
+    const int nr = ctx->Nr;
+    __m128i dk[AES_ROUND_256 + 1];
+    for (int r = 0; r <= nr; r++) dk[r] = _mm_loadu_si128((const __m128i*)ctx->dec_round_keys + nr - r);
+
+    __m128i prev = _mm_loadu_si128((const __m128i*)iv);
+    while (blocks > 0) {
+        __m128i c[AESNI_CTR_PARALLEL], b[AESNI_CTR_PARALLEL];
+        int n = (blocks < AESNI_CTR_PARALLEL) ? (int)blocks : AESNI_CTR_PARALLEL;
+        for (int j = 0; j < n; j++) {
+            c[j] = _mm_loadu_si128((const __m128i*)in + j);
+            b[j] = _mm_xor_si128(c[j], dk[0]);
+        }
+        for (int r = 1; r < nr; r++) {
+            for (int j = 0; j < n; j++) b[j] = _mm_aesdec_si128(b[j], dk[r]);
+        }
+        for (int j = 0; j < n; j++) {
+            b[j] = _mm_aesdeclast_si128(b[j], dk[nr]);
+            _mm_storeu_si128((__m128i*)out + j, _mm_xor_si128(b[j], j == 0 ? prev : c[j - 1]));
+        }
+        prev = c[n - 1];
+        in += n * AES_BLOCK_SIZE;
+        out += n * AES_BLOCK_SIZE;
+        blocks -= (size_t)n;
+    }
+    _mm_storeu_si128((__m128i*)iv, prev);
+}
+
+/**
+ * @brief aesni_ctr_crypt: AES-NI CTR 커널.
+ * * 카운터 블록 8개를 한꺼번에 라운드에 통과시켜 AESENC의 지연시간(수 사이클)을 감춥니다.
+ * * 카운터는 128비트 big-endian 값으로 다루며, 블록마다 1씩 증가합니다 (T-tables 경로와 동일).
+ * * in == out (in-place) 호출도 블록 단위로 읽은 뒤 쓰므로 안전합니다.
+ */
+AES_TARGET("aes,ssse3")
+static void aesni_ctr_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out,
+                            uint8_t nonce_counter[AES_BLOCK_SIZE]) {
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const int nr = ctx->Nr;
+    __m128i rk[AES_ROUND_256 + 1];
+    for (int r = 0; r <= nr; r++) rk[r] = _mm_loadu_si128((const __m128i*)ctx->round_keys + r);
+
+    uint64_t ctr_hi, ctr_lo;
+    ctr_split(nonce_counter, &ctr_hi, &ctr_lo);
+
+    while (length >= AESNI_CTR_PARALLEL * AES_BLOCK_SIZE) {
+        __m128i b[AESNI_CTR_PARALLEL];
+        for (int j = 0; j < AESNI_CTR_PARALLEL; j++) {
+            uint64_t lo = ctr_lo + (uint64_t)j;
+            uint64_t hi = ctr_hi + (lo < ctr_lo); // 하위 64비트 자리올림
+            b[j] = _mm_xor_si128(_mm_shuffle_epi8(_mm_set_epi64x((long long)hi, (long long)lo), bswap), rk[0]);
+        }
+        for (int r = 1; r < nr; r++) {
+            for (int j = 0; j < AESNI_CTR_PARALLEL; j++) b[j] = _mm_aesenc_si128(b[j], rk[r]);
+        }
+        for (int j = 0; j < AESNI_CTR_PARALLEL; j++) {
+            b[j] = _mm_aesenclast_si128(b[j], rk[nr]);
+            __m128i d = _mm_loadu_si128((const __m128i*)in + j);
+            _mm_storeu_si128((__m128i*)out + j, _mm_xor_si128(d, b[j]));
+        }
+        ctr_lo += AESNI_CTR_PARALLEL;
+        if (ctr_lo < AESNI_CTR_PARALLEL) ctr_hi++;
+        in += AESNI_CTR_PARALLEL * AES_BLOCK_SIZE;
+        out += AESNI_CTR_PARALLEL * AES_BLOCK_SIZE;
+        length -= AESNI_CTR_PARALLEL * AES_BLOCK_SIZE;
+    }
+
+    // 남은 블록 (마지막 블록은 16바이트보다 작을 수 있음)
+    while (length > 0) {
+        __m128i b = _mm_xor_si128(_mm_shuffle_epi8(_mm_set_epi64x((long long)ctr_hi, (long long)ctr_lo), bswap), rk[0]);
+        for (int r = 1; r < nr; r++) b = _mm_aesenc_si128(b, rk[r]);
+        b = _mm_aesenclast_si128(b, rk[nr]);
+
+        if (length >= AES_BLOCK_SIZE) {
+            __m128i d = _mm_loadu_si128((const __m128i*)in);
+            _mm_storeu_si128((__m128i*)out, _mm_xor_si128(d, b));
+            in += AES_BLOCK_SIZE;
+            out += AES_BLOCK_SIZE;
+            length -= AES_BLOCK_SIZE;
+        } else {
+            uint8_t keystream_block[AES_BLOCK_SIZE];
+            _mm_storeu_si128((__m128i*)keystream_block, b);
+            ctr_xor(out, in, keystream_block, length);
+            length = 0;
+        }
+        if (++ctr_lo == 0) ctr_hi++;
+    }
+
+    ctr_join(nonce_counter, ctr_hi, ctr_lo); // 증가된 카운터를 big-endian으로 되돌려 기록
+}
+
+/*****************************************************
+ * VAES 광폭 CTR 커널 (256/512비트 레지스터)
+ * 레지스터 하나에 카운터 블록 2개(AVX2) 또는 4개(AVX-512)를 담아
+ * 한 번의 VAESENC로 여러 블록의 라운드를 처리합니다.
+ * 반복당 레지스터 8개를 사용하므로 16블록(256B) 또는 32블록(512B) 단위로 처리하고,
+ * 남은 꼬리 부분과 카운터 하위 64비트 자리올림이 걸리는 구간은 aesni_ctr_crypt가 처리합니다.
+ * ECB와 CBC 복호화(블록 간 독립)도 같은 구성으로 처리합니다. CBC 암호화는 직렬이라 AES-NI 커널을 씁니다.
+ *****************************************************/
+#define VAES_CTR_REGS 8
+
+// 하위 64비트 자리올림 없이 광폭 커널로 처리할 수 있는 블록 수 (batch_blocks의 배수)
+static size_t ctr_wide_blocks(const uint8_t nonce_counter[AES_BLOCK_SIZE], size_t length, size_t batch_blocks) {
+    uint64_t lo = 0;
+    for (int i = 8; i < 16; i++) lo = (lo << 8) | nonce_counter[i];
+    uint64_t blocks = (uint64_t)(length / (batch_blocks * AES_BLOCK_SIZE)) * batch_blocks;
+    uint64_t room = UINT64_MAX - lo; // 자리올림이 생기는 경계는 (드물게) 좁은 경로가 처리
+    if (blocks > room) blocks = room / batch_blocks * batch_blocks;
+    return (size_t)blocks;
+}
+
+// big-endian 카운터에 블록 수를 더함 (128비트 자리올림 포함)
+static void ctr_add_blocks(uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t blocks) {
+    for (int i = AES_BLOCK_SIZE - 1; i >= 0 && blocks > 0; i--) {
+        uint64_t sum = (uint64_t)nonce_counter[i] + (blocks & 0xff);
+        nonce_counter[i] = (uint8_t)sum;
+        blocks = (blocks >> 8) + (sum >> 8);
+    }
+}
+
+AES_TARGET("vaes,avx2")
+static void vaes256_ctr_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out,
+                              uint8_t nonce_counter[AES_BLOCK_SIZE]) {
+    const size_t batch = VAES_CTR_REGS * 2 * AES_BLOCK_SIZE; // 256바이트
+    const __m256i bswap = _mm256_broadcastsi128_si256(
+        _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    const int nr = ctx->Nr;
+    __m256i rk[AES_ROUND_256 + 1];
+    for (int r = 0; r <= nr; r++) {
+        rk[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)ctx->round_keys + r));
+    }
+
+    size_t blocks = ctr_wide_blocks(nonce_counter, length, batch / AES_BLOCK_SIZE);
+    if (blocks > 0) {
+        // 리틀엔디언 128비트 정수로 바꾼 카운터 (레인 0 = ctr, 레인 1 = ctr + 1)
+        __m256i ctr = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)nonce_counter)), bswap);
+        ctr = _mm256_add_epi64(ctr, _mm256_set_epi64x(0, 1, 0, 0));
+        const __m256i step = _mm256_set_epi64x(0, 2, 0, 2);
+
+        for (size_t done = 0; done < blocks; done += batch / AES_BLOCK_SIZE) {
+            __m256i b[VAES_CTR_REGS];
+            for (int j = 0; j < VAES_CTR_REGS; j++) {
+                b[j] = _mm256_xor_si256(_mm256_shuffle_epi8(ctr, bswap), rk[0]);
+                ctr = _mm256_add_epi64(ctr, step);
+            }
+            for (int r = 1; r < nr; r++) {
+                for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm256_aesenc_epi128(b[j], rk[r]);
+            }
+            for (int j = 0; j < VAES_CTR_REGS; j++) {
+                b[j] = _mm256_aesenclast_epi128(b[j], rk[nr]);
+                __m256i d = _mm256_loadu_si256((const __m256i*)in + j);
+                _mm256_storeu_si256((__m256i*)out + j, _mm256_xor_si256(d, b[j]));
+            }
+            in += batch;
+            out += batch;
+        }
+        length -= blocks * AES_BLOCK_SIZE;
+        ctr_add_blocks(nonce_counter, blocks);
+    }
+    _mm256_zeroupper();
+
+    aesni_ctr_crypt(ctx, in, length, out, nonce_counter);
+}
+
+AES_TARGET("vaes,avx512f,avx512bw")
+static void vaes512_ctr_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out,
+                              uint8_t nonce_counter[AES_BLOCK_SIZE]) {
+    const size_t batch = VAES_CTR_REGS * 4 * AES_BLOCK_SIZE; // 512바이트
+    const __m512i bswap = _mm512_broadcast_i32x4(
+        _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    const int nr = ctx->Nr;
+    __m512i rk[AES_ROUND_256 + 1];
+    for (int r = 0; r <= nr; r++) {
+        rk[r] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)ctx->round_keys + r));
+    }
+
+    size_t blocks = ctr_wide_blocks(nonce_counter, length, batch / AES_BLOCK_SIZE);
+    if (blocks > 0) {
+        // 리틀엔디언 128비트 정수로 바꾼 카운터 (레인 k = ctr + k)
+        __m512i ctr = _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)nonce_counter)), bswap);
+        ctr = _mm512_add_epi64(ctr, _mm512_set_epi64(0, 3, 0, 2, 0, 1, 0, 0));
+        const __m512i step = _mm512_set_epi64(0, 4, 0, 4, 0, 4, 0, 4);
+
+        for (size_t done = 0; done < blocks; done += batch / AES_BLOCK_SIZE) {
+            __m512i b[VAES_CTR_REGS];
+            for (int j = 0; j < VAES_CTR_REGS; j++) {
+                b[j] = _mm512_xor_si512(_mm512_shuffle_epi8(ctr, bswap), rk[0]);
+                ctr = _mm512_add_epi64(ctr, step);
+            }
+            for (int r = 1; r < nr; r++) {
+                for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm512_aesenc_epi128(b[j], rk[r]);
+            }
+            for (int j = 0; j < VAES_CTR_REGS; j++) {
+                b[j] = _mm512_aesenclast_epi128(b[j], rk[nr]);
+                __m512i d = _mm512_loadu_si512((const void*)(in + j * 64));
+                _mm512_storeu_si512((void*)(out + j * 64), _mm512_xor_si512(d, b[j]));
+            }
+            in += batch;
+            out += batch;
+        }
+        length -= blocks * AES_BLOCK_SIZE;
+        ctr_add_blocks(nonce_counter, blocks);
+    }
+    _mm256_zeroupper();
+
+    aesni_ctr_crypt(ctx, in, length, out, nonce_counter);
+}
+
+// ECB 광폭 커널: 레지스터 VAES_CTR_REGS개(16/32블록) 단위로 처리하고, 남은 블록은 AES-NI 커널이 처리
+AES_TARGET("vaes,avx2")
+static void vaes256_ecb_crypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out, int decrypt) {
+    const size_t batch = VAES_CTR_REGS * 2; // 블록 수
+    const int nr = ctx->Nr;
+    const __m128i* src = (const __m128i*)(decrypt ? ctx->dec_round_keys : ctx->round_keys);
+    __m256i rk[AES_ROUND_256 + 1];
+    for (int r = 0; r <= nr; r++) rk[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128(src + (decrypt ? nr - r : r)));
+
+    for (; blocks >= batch; blocks -= batch) {
+        __m256i b[VAES_CTR_REGS];
+        for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)in + j), rk[0]);
+        if (decrypt) {
+            for (int r = 1; r < nr; r++) {
+                for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm256_aesdec_epi128(b[j], rk[r]);
+            }
+            for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm256_aesdeclast_epi128(b[j], rk[nr]);
+        } else {
+            for (int r = 1; r < nr; r++) {
+                for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm256_aesenc_epi128(b[j], rk[r]);
+            }
+            for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm256_aesenclast_epi128(b[j], rk[nr]);
+        }
+        for (int j = 0; j < VAES_CTR_REGS; j++) _mm256_storeu_si256((__m256i*)out + j, b[j]);
+        in += batch * AES_BLOCK_SIZE;
+        out += batch * AES_BLOCK_SIZE;
+    }
+    _mm256_zeroupper();
+
+    aesni_ecb_crypt(ctx, in, blocks, out, decrypt);
+}
+
+// CBC 복호화 광폭 커널: 각 레인의 이전 암호문은 VPERM2I128로 [이전 레지스터 상위 레인, 현재 레지스터 하위 레인]을 조합
+AES_TARGET("vaes,avx2")
+static void vaes256_cbc_decrypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out,
+                                uint8_t iv[AES_BLOCK_SIZE]) {
+    const size_t batch = VAES_CTR_REGS * 2;
+    const int nr = ctx->Nr;
+    __m256i dk[AES_ROUND_256 + 1];
+    for (int r = 0; r <= nr; r++) {
+        dk[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)ctx->dec_round_keys + nr - r));
+    }
+
+    if (blocks >= batch) {
+        __m256i last = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)iv)); // 상위 레인 = 직전 암호문
+        for (; blocks >= batch; blocks -= batch) {
+            __m256i c[VAES_CTR_REGS], b[VAES_CTR_REGS];
+            for (int j = 0; j < VAES_CTR_REGS; j++) {
+                c[j] = _mm256_loadu_si256((const __m256i*)in + j); // 쓰기 전에 모두 읽어 두므로 in-place 안전
+                b[j] = _mm256_xor_si256(c[j], dk[0]);
+            }
+            for (int r = 1; r < nr; r++) {
+                for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm256_aesdec_epi128(b[j], dk[r]);
+            }
+            for (int j = 0; j < VAES_CTR_REGS; j++) {
+                __m256i prev = _mm256_permute2x128_si256(j == 0 ? last : c[j - 1], c[j], 0x21);
+                b[j] = _mm256_aesdeclast_epi128(b[j], dk[nr]);
+                _mm256_storeu_si256((__m256i*)out + j, _mm256_xor_si256(b[j], prev));
+            }
+            last = c[VAES_CTR_REGS - 1];
+            in += batch * AES_BLOCK_SIZE;
+            out += batch * AES_BLOCK_SIZE;
+        }
+        _mm_storeu_si128((__m128i*)iv, _mm256_extracti128_si256(last, 1));
+    }
+    _mm256_zeroupper();
+
+    aesni_cbc_decrypt(ctx, in, blocks, out, iv);
+}
+
+AES_TARGET("vaes,avx512f,avx512bw")
+static void vaes512_ecb_crypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out, int decrypt) {
+    const size_t batch = VAES_CTR_REGS * 4;
+    const int nr = ctx->Nr;
+    const __m128i* src = (const __m128i*)(decrypt ? ctx->dec_round_keys : ctx->round_keys);
+    __m512i rk[AES_ROUND_256 + 1];
+    for (int r = 0; r <= nr; r++) rk[r] = _mm512_broadcast_i32x4(_mm_loadu_si128(src + (decrypt ? nr - r : r)));
+
+    for (; blocks >= batch; blocks -= batch) {
+        __m512i b[VAES_CTR_REGS];
+        for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm512_xor_si512(_mm512_loadu_si512((const void*)(in + j * 64)), rk[0]);
+        if (decrypt) {
+            for (int r = 1; r < nr; r++) {
+                for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm512_aesdec_epi128(b[j], rk[r]);
+            }
+            for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm512_aesdeclast_epi128(b[j], rk[nr]);
+        } else {
+            for (int r = 1; r < nr; r++) {
+                for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm512_aesenc_epi128(b[j], rk[r]);
+            }
+            for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm512_aesenclast_epi128(b[j], rk[nr]);
+        }
+        for (int j = 0; j < VAES_CTR_REGS; j++) _mm512_storeu_si512((void*)(out + j * 64), b[j]);
+        in += batch * AES_BLOCK_SIZE;
+        out += batch * AES_BLOCK_SIZE;
+    }
+    _mm256_zeroupper();
+
+    aesni_ecb_crypt(ctx, in, blocks, out, decrypt);
+}
+
+// 이전 암호문 레지스터는 VALIGNQ로 [직전 레지스터 레인 3, 현재 레인 0..2]를 조합
+AES_TARGET("vaes,avx512f,avx512bw")
+static void vaes512_cbc_decrypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out,
+                                uint8_t iv[AES_BLOCK_SIZE]) {
+    const size_t batch = VAES_CTR_REGS * 4;
+    const int nr = ctx->Nr;
+    __m512i dk[AES_ROUND_256 + 1];
+    for (int r = 0; r <= nr; r++) {
+        dk[r] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)ctx->dec_round_keys + nr - r));
+    }
+
+    if (blocks >= batch) {
+        __m512i last = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)iv)); // 레인 3 = 직전 암호문
+        for (; blocks >= batch; blocks -= batch) {
+            __m512i c[VAES_CTR_REGS], b[VAES_CTR_REGS];
+            for (int j = 0; j < VAES_CTR_REGS; j++) {
+                c[j] = _mm512_loadu_si512((const void*)(in + j * 64));
+                b[j] = _mm512_xor_si512(c[j], dk[0]);
+            }
+            for (int r = 1; r < nr; r++) {
+                for (int j = 0; j < VAES_CTR_REGS; j++) b[j] = _mm512_aesdec_epi128(b[j], dk[r]);
+            }
+            for (int j = 0; j < VAES_CTR_REGS; j++) {
+                __m512i prev = _mm512_alignr_epi64(c[j], j == 0 ? last : c[j - 1], 6);
+                b[j] = _mm512_aesdeclast_epi128(b[j], dk[nr]);
+                _mm512_storeu_si512((void*)(out + j * 64), _mm512_xor_si512(b[j], prev));
+            }
+            last = c[VAES_CTR_REGS - 1];
+            in += batch * AES_BLOCK_SIZE;
+            out += batch * AES_BLOCK_SIZE;
+        }
+        _mm_storeu_si128((__m128i*)iv, _mm512_extracti32x4_epi32(last, 3));
+    }
+    _mm256_zeroupper();
+
+    aesni_cbc_decrypt(ctx, in, blocks, out, iv);
+}
+
+/*****************************************************
+ * SSSE3 벡터 순열(vector permute) 백엔드 - vpaes 방식
+ * AES-NI가 없는 CPU용. S-Box를 PSHUFB 니블 조회만으로 계산하므로
+ * 메모리 테이블 조회가 없어 캐시 타이밍 누출이 없습니다.
+ *
+ * * GF(2^8)을 GF(2^4)[t]/(t^2 + 2t + 2)로 옮겨(기저 변환) 바이트를 (i, k) 두 니블로 나눕니다.
+ *   (x = i*t + k, GF(2^4)은 x^4 + x + 1)
+ * * 역원은 1/i, a/k 니블 테이블만으로 io = j ^ 1/(1/i ^ a/k), jo = i ^ 1/(1/j ^ a/k) (j = i ^ k)로 구합니다.
+ *   0의 역원은 0x80("무한대")으로 두어, 이후 PSHUFB에서 자연스럽게 0이 되도록 합니다.
+ * * 출력 테이블(io, jo 각 16바이트)은 역원 -> 아핀 변환 -> (MixColumns 계수 곱) -> 다음 라운드 기저 변환을
+ *   한 번에 수행하며, 아핀 상수 0x63은 라운드 키에 미리 더해 둡니다.
+ * * 복호화는 동등 역암호(equivalent inverse cipher) 구조로, AES_CTX의 dec_round_keys를 사용합니다.
+ * 기저 변환된 라운드 키는 호출마다 만듭니다 (AES_CTX 형식은 모든 구현이 공유).
+ *****************************************************/
+#define VPAES_CTR_PARALLEL 4
+
+// GF(2^4) 역원 1/x, a/x (a = 2), 0 -> 0x80
+static const uint8_t vp_inv[2][16] = {
+    { 0x80, 0x01, 0x09, 0x0E, 0x0D, 0x0B, 0x07, 0x06, 0x0F, 0x02, 0x0C, 0x05, 0x0A, 0x04, 0x03, 0x08 },
+    { 0x80, 0x02, 0x01, 0x0F, 0x09, 0x05, 0x0E, 0x0C, 0x0D, 0x04, 0x0B, 0x0A, 0x07, 0x08, 0x06, 0x03 }
+};
+// 입력 기저 변환 (하위/상위 니블): 암호화 phi(x), 복호화 phi(M^-1 x)
+static const uint8_t vp_ipt[2][16] = {
+    { 0x00, 0x01, 0x1C, 0x1D, 0x2D, 0x2C, 0x31, 0x30, 0x27, 0x26, 0x3B, 0x3A, 0x0A, 0x0B, 0x16, 0x17 },
+    { 0x00, 0x86, 0xFD, 0x7B, 0x8E, 0x08, 0x73, 0xF5, 0x77, 0xF1, 0x8A, 0x0C, 0xF9, 0x7F, 0x04, 0x82 }
+};
+static const uint8_t vp_dipt[2][16] = {
+    { 0x00, 0xB5, 0xDC, 0x69, 0xDB, 0x6E, 0x07, 0xB2, 0x14, 0xA1, 0xC8, 0x7D, 0xCF, 0x7A, 0x13, 0xA6 },
+    { 0x00, 0xA7, 0xA8, 0x0F, 0xED, 0x4A, 0x45, 0xE2, 0xD1, 0x76, 0x79, 0xDE, 0x3C, 0x9B, 0x94, 0x33 }
+};
+// 암호화 출력 (io, jo): S(x), 2*S(x) (다음 라운드 기저), 마지막 라운드 S(x) (표준 기저)
+static const uint8_t vp_sb1[2][16] = {
+    { 0x00, 0xC3, 0x4F, 0x0C, 0xFC, 0x7C, 0x43, 0x80, 0xCF, 0x33, 0x3F, 0x70, 0xBF, 0xB3, 0xF0, 0x8C },
+    { 0x00, 0xE6, 0x72, 0xB7, 0xE5, 0xC6, 0xC5, 0x23, 0x51, 0xB4, 0x03, 0x71, 0x20, 0x97, 0x52, 0x94 }
+};
+static const uint8_t vp_sb2[2][16] = {
+    { 0x00, 0x7C, 0x20, 0xCF, 0x92, 0x01, 0xEF, 0x93, 0xB3, 0x21, 0xEE, 0xCE, 0x7D, 0xB2, 0x5D, 0x5C },
+    { 0x00, 0xD1, 0xE5, 0xF7, 0xE6, 0x25, 0x12, 0xC3, 0x26, 0xC0, 0x37, 0xD2, 0xF4, 0x03, 0x11, 0x34 }
+};
+static const uint8_t vp_sbo[2][16] = {
+    { 0x00, 0xCB, 0xD7, 0xB0, 0x21, 0x8D, 0x67, 0xAC, 0x7B, 0x5A, 0xEA, 0x3D, 0x46, 0xF6, 0x91, 0x1C },
+    { 0x00, 0x9F, 0x61, 0x16, 0xC2, 0x2A, 0x77, 0xE8, 0x89, 0x4B, 0x5D, 0x3C, 0xB5, 0xA3, 0xD4, 0xFE }
+};
+// 복호화 출력 (io, jo): InvS(x)에 14, 11, 13, 9를 곱한 값 (다음 라운드 기저), 마지막 라운드 InvS(x)
+static const uint8_t vp_dsbe[2][16] = {
+    { 0x00, 0xEB, 0xA6, 0xB9, 0x7B, 0x8F, 0x1F, 0xF4, 0x52, 0x29, 0x90, 0x36, 0x64, 0xDD, 0xC2, 0x4D },
+    { 0x00, 0xFD, 0xDF, 0x65, 0x9D, 0xDA, 0xBA, 0x47, 0x98, 0x05, 0x60, 0xBF, 0x27, 0x42, 0xF8, 0x22 }
+};
+static const uint8_t vp_dsbb[2][16] = {
+    { 0x00, 0xC2, 0x4D, 0xEB, 0xDD, 0xB9, 0xA6, 0x64, 0x29, 0xF4, 0x1F, 0x52, 0x7B, 0x90, 0x36, 0x8F },
+    { 0x00, 0xF8, 0x22, 0xFD, 0x42, 0x65, 0xDF, 0x27, 0x05, 0x47, 0xBA, 0x98, 0x9D, 0x60, 0xBF, 0xDA }
+};
+static const uint8_t vp_dsbd[2][16] = {
+    { 0x00, 0x7C, 0x1B, 0x3D, 0x15, 0x4F, 0x26, 0x5A, 0x41, 0x54, 0x69, 0x72, 0x33, 0x0E, 0x28, 0x67 },
+    { 0x00, 0x77, 0xB2, 0xB0, 0xB6, 0xC3, 0x02, 0x75, 0xC7, 0x71, 0xC1, 0x73, 0xB4, 0x04, 0x06, 0xC5 }
+};
+static const uint8_t vp_dsb9[2][16] = {
+    { 0x00, 0x27, 0xBF, 0x47, 0xDA, 0x05, 0xF8, 0xDF, 0x60, 0xBA, 0xFD, 0x42, 0x22, 0x65, 0x9D, 0x98 },
+    { 0x00, 0x01, 0x8C, 0x2E, 0xA8, 0x0B, 0xA2, 0xA3, 0x2F, 0x87, 0xA9, 0x25, 0x0A, 0x24, 0x86, 0x8D }
+};
+static const uint8_t vp_dsbo[2][16] = {
+    { 0x00, 0x3B, 0xE4, 0xC8, 0x03, 0x14, 0x2C, 0x17, 0xF3, 0xF0, 0x38, 0xDC, 0x2F, 0xE7, 0xCB, 0xDF },
+    { 0x00, 0x24, 0x91, 0x19, 0x23, 0x8F, 0x88, 0xAC, 0x3D, 0x1E, 0x07, 0x96, 0xAB, 0xB2, 0x3A, 0xB5 }
+};
+// 바이트 순열: ShiftRows, InvShiftRows, 열 안에서 한 행 회전 (a[r] <- a[r+1])
+static const uint8_t vp_shift_rows[16] = { 0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11 };
+static const uint8_t vp_inv_shift_rows[16] = { 0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3 };
+static const uint8_t vp_rot_column[16] = { 1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12 };
+
+#define VP_LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+
+// 바이트별 선형 변환 (하위/상위 니블 테이블 조회 후 XOR)
+AES_TARGET("ssse3")
+static __m128i vp_transform(__m128i x, const uint8_t tab[2][16]) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    __m128i lo = _mm_and_si128(x, mask);
+    __m128i hi = _mm_and_si128(_mm_srli_epi32(x, 4), mask);
+    return _mm_xor_si128(_mm_shuffle_epi8(VP_LOAD(tab[0]), lo), _mm_shuffle_epi8(VP_LOAD(tab[1]), hi));
+}
+
+// GF((2^4)^2) 역원: 결과를 io, jo 두 니블로 반환
+AES_TARGET("ssse3")
+static void vp_invert(__m128i x, __m128i* io, __m128i* jo) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i inv = VP_LOAD(vp_inv[0]), inva = VP_LOAD(vp_inv[1]);
+    __m128i k = _mm_and_si128(x, mask);
+    __m128i i = _mm_and_si128(_mm_srli_epi32(x, 4), mask);
+    __m128i j = _mm_xor_si128(i, k);
+    __m128i ak = _mm_shuffle_epi8(inva, k);                          // a/k
+    __m128i iak = _mm_xor_si128(_mm_shuffle_epi8(inv, i), ak);       // 1/i + a/k
+    __m128i jak = _mm_xor_si128(_mm_shuffle_epi8(inv, j), ak);       // 1/j + a/k
+    *io = _mm_xor_si128(_mm_shuffle_epi8(inv, iak), j);
+    *jo = _mm_xor_si128(_mm_shuffle_epi8(inv, jak), i);
+}
+
+// 역원 (io, jo)를 출력 테이블로 변환
+AES_TARGET("ssse3")
+static __m128i vp_output(__m128i io, __m128i jo, const uint8_t tab[2][16]) {
+    return _mm_xor_si128(_mm_shuffle_epi8(VP_LOAD(tab[0]), io), _mm_shuffle_epi8(VP_LOAD(tab[1]), jo));
+}
+
+// 암호화 라운드 키: 0라운드는 기저 변환만, 중간 라운드는 0x63을 더해 기저 변환, 마지막은 표준 기저 + 0x63
+AES_TARGET("ssse3")
+static void vp_enc_round_keys(const AES_CTX* ctx, __m128i* ek) {
+    const __m128i c63 = _mm_set1_epi8(0x63);
+    const int nr = ctx->Nr;
+    ek[0] = vp_transform(VP_LOAD(ctx->round_keys), vp_ipt);
+    for (int r = 1; r < nr; r++) {
+        ek[r] = vp_transform(_mm_xor_si128(VP_LOAD(ctx->round_keys + r * 16), c63), vp_ipt);
+    }
+    ek[nr] = _mm_xor_si128(VP_LOAD(ctx->round_keys + nr * 16), c63);
+}
+
+// 복호화 라운드 키: InvMixColumns가 이미 적용된 dec_round_keys(동등 역암호)를 복호화 기저로 변환
+AES_TARGET("ssse3")
+static void vp_dec_round_keys(const AES_CTX* ctx, __m128i* dk) {
+    const __m128i c63 = _mm_set1_epi8(0x63);
+    const int nr = ctx->Nr;
+    for (int r = 1; r <= nr; r++) {
+        dk[r] = vp_transform(_mm_xor_si128(VP_LOAD(ctx->dec_round_keys + r * 16), c63), vp_dipt);
+    }
+    dk[0] = VP_LOAD(ctx->dec_round_keys);
+}
+
+AES_TARGET("ssse3")
+static __m128i vp_encrypt(__m128i x, const __m128i* ek, int nr) {
+    const __m128i sr = VP_LOAD(vp_shift_rows), rot = VP_LOAD(vp_rot_column);
+    __m128i io, jo;
+
+    x = _mm_xor_si128(vp_transform(x, vp_ipt), ek[0]);
+    for (int r = 1; r < nr; r++) {
+        vp_invert(_mm_shuffle_epi8(x, sr), &io, &jo); // ShiftRows는 바이트별 SubBytes와 순서 교환 가능
+        __m128i u = vp_output(io, jo, vp_sb1);
+        __m128i v = vp_output(io, jo, vp_sb2);
+        // MixColumns: 2*a0 ^ 3*a1 ^ a2 ^ a3 = v ^ rot(v ^ u ^ rot(u ^ rot(u)))
+        __m128i t = _mm_xor_si128(u, _mm_shuffle_epi8(u, rot));
+        t = _mm_xor_si128(_mm_xor_si128(v, u), _mm_shuffle_epi8(t, rot));
+        x = _mm_xor_si128(_mm_xor_si128(v, _mm_shuffle_epi8(t, rot)), ek[r]);
+    }
+    vp_invert(_mm_shuffle_epi8(x, sr), &io, &jo);
+    return _mm_xor_si128(vp_output(io, jo, vp_sbo), ek[nr]);
+}
+
+AES_TARGET("ssse3")
+static __m128i vp_decrypt(__m128i x, const __m128i* dk, int nr) {
+    const __m128i isr = VP_LOAD(vp_inv_shift_rows), rot = VP_LOAD(vp_rot_column);
+    __m128i io, jo;
+
+    x = _mm_xor_si128(vp_transform(x, vp_dipt), dk[nr]);
+    for (int r = nr - 1; r > 0; r--) {
+        vp_invert(_mm_shuffle_epi8(x, isr), &io, &jo);
+        // InvMixColumns: 14*a0 ^ 11*a1 ^ 13*a2 ^ 9*a3 = e ^ rot(b ^ rot(d ^ rot(n)))
+        __m128i t = vp_output(io, jo, vp_dsb9);
+        t = _mm_xor_si128(vp_output(io, jo, vp_dsbd), _mm_shuffle_epi8(t, rot));
+        t = _mm_xor_si128(vp_output(io, jo, vp_dsbb), _mm_shuffle_epi8(t, rot));
+        x = _mm_xor_si128(_mm_xor_si128(vp_output(io, jo, vp_dsbe), _mm_shuffle_epi8(t, rot)), dk[r]);
+    }
+    vp_invert(_mm_shuffle_epi8(x, isr), &io, &jo);
+    return _mm_xor_si128(vp_output(io, jo, vp_dsbo), dk[0]);
+}
+
+AES_TARGET("ssse3")
+static void vpaes_encrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    __m128i ek[AES_ROUND_256 + 1];
+    vp_enc_round_keys(ctx, ek);
+    _mm_storeu_si128((__m128i*)out, vp_encrypt(VP_LOAD(in), ek, ctx->Nr));
+}
+
+AES_TARGET("ssse3")
+static void vpaes_decrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
+    __m128i dk[AES_ROUND_256 + 1];
+    vp_dec_round_keys(ctx, dk);
+    _mm_storeu_si128((__m128i*)out, vp_decrypt(VP_LOAD(in), dk, ctx->Nr));
+}
+
+// CTR: 라운드 키는 호출당 한 번만 변환하고, 독립적인 카운터 블록 4개를 함께 처리
+AES_TARGET("ssse3")
+static void vpaes_ctr_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out,
+                            uint8_t nonce_counter[AES_BLOCK_SIZE]) {
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const int nr = ctx->Nr;
+    __m128i ek[AES_ROUND_256 + 1];
+    vp_enc_round_keys(ctx, ek);
+
+    uint64_t ctr_hi, ctr_lo;
+    ctr_split(nonce_counter, &ctr_hi, &ctr_lo);
+
+    while (length >= VPAES_CTR_PARALLEL * AES_BLOCK_SIZE) {
+        for (int j = 0; j < VPAES_CTR_PARALLEL; j++) {
+            uint64_t lo = ctr_lo + (uint64_t)j;
+            uint64_t hi = ctr_hi + (lo < ctr_lo);
+            __m128i b = vp_encrypt(_mm_shuffle_epi8(_mm_set_epi64x((long long)hi, (long long)lo), bswap), ek, nr);
+            __m128i d = _mm_loadu_si128((const __m128i*)in + j);
+            _mm_storeu_si128((__m128i*)out + j, _mm_xor_si128(d, b));
+        }
+        ctr_lo += VPAES_CTR_PARALLEL;
+        if (ctr_lo < VPAES_CTR_PARALLEL) ctr_hi++;
+        in += VPAES_CTR_PARALLEL * AES_BLOCK_SIZE;
+        out += VPAES_CTR_PARALLEL * AES_BLOCK_SIZE;
+        length -= VPAES_CTR_PARALLEL * AES_BLOCK_SIZE;
+    }
+
+    while (length > 0) {
+        uint8_t keystream_block[AES_BLOCK_SIZE];
+        size_t n = (length < AES_BLOCK_SIZE) ? length : AES_BLOCK_SIZE;
+        __m128i b = vp_encrypt(_mm_shuffle_epi8(_mm_set_epi64x((long long)ctr_hi, (long long)ctr_lo), bswap), ek, nr);
+        _mm_storeu_si128((__m128i*)keystream_block, b);
+        ctr_xor(out, in, keystream_block, n);
+        in += n;
+        out += n;
+        length -= n;
+        if (++ctr_lo == 0) ctr_hi++;
+    }
+
+    ctr_join(nonce_counter, ctr_hi, ctr_lo);
+}
+
+AES_TARGET("ssse3")
+static void vpaes_ecb_crypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out, int decrypt) {
+    __m128i k[AES_ROUND_256 + 1];
+    if (decrypt) vp_dec_round_keys(ctx, k);
+    else vp_enc_round_keys(ctx, k);
+
+    for (size_t i = 0; i < blocks; i++) {
+        __m128i x = _mm_loadu_si128((const __m128i*)in + i);
+        x = decrypt ? vp_decrypt(x, k, ctx->Nr) : vp_encrypt(x, k, ctx->Nr);
+        _mm_storeu_si128((__m128i*)out + i, x);
+    }
+}
+
+AES_TARGET("ssse3")
+static void vpaes_cbc_encrypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out,
+                              uint8_t iv[AES_BLOCK_SIZE]) {
+    __m128i ek[AES_ROUND_256 + 1];
+    vp_enc_round_keys(ctx, ek);
+
+    __m128i c = _mm_loadu_si128((const __m128i*)iv);
+    for (size_t i = 0; i < blocks; i++) {
+        c = vp_encrypt(_mm_xor_si128(_mm_loadu_si128((const __m128i*)in + i), c), ek, ctx->Nr);
+        _mm_storeu_si128((__m128i*)out + i, c);
+    }
+    _mm_storeu_si128((__m128i*)iv, c);
+}
+
+// 암호문 블록을 먼저 읽어 보관하므로 in-place 안전 (블록 간 의존이 없어 비순차 실행으로 겹쳐 처리됨)
+AES_TARGET("ssse3")
+static void vpaes_cbc_decrypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out,
+                              uint8_t iv[AES_BLOCK_SIZE]) {
+    __m128i dk[AES_ROUND_256 + 1];
+    vp_dec_round_keys(ctx, dk);
+
+    __m128i prev = _mm_loadu_si128((const __m128i*)iv);
+    for (size_t i = 0; i < blocks; i++) {
+        __m128i c = _mm_loadu_si128((const __m128i*)in + i);
+        _mm_storeu_si128((__m128i*)out + i, _mm_xor_si128(vp_decrypt(c, dk, ctx->Nr), prev));
+        prev = c;
+    }
+    _mm_storeu_si128((__m128i*)iv, prev);
+}
+
+#endif // AES_HAVE_AESNI
+
+
+/*****************************************************
+ * 비트슬라이스(bitsliced) 상수시간 백엔드 (포터블 C)
+ * 테이블 조회 없이 논리 연산만 사용하므로 캐시 타이밍 누출이 없습니다.
+ * 64비트 워드 8개(q[0..7])에 4블록을 비트 단위로 전치해 담고,
+ * q[i]에는 각 바이트의 i번째 비트가 모입니다.
+ * S-Box는 Boyar-Peralta 회로(AND 32개 + XOR/XNOR 83개)로 계산하며,
+ * CTR은 한 번에 8블록(4블록 그룹 2개)을 처리합니다.
+ * GCC/Clang에서는 두 그룹을 128비트 벡터(bs_word)의 두 레인에 담아 SSE2/NEON으로
+ * 한 번의 패스에 8블록을 계산하고, 그 밖의 컴파일러는 64비트 워드로 그룹을 차례로 계산합니다.
+ * 블록은 리틀엔디언 32비트 워드 4개로 읽어 들입니다 (키 스케줄도 동일한 형식).
+ *****************************************************/
+#define BS_CTR_PARALLEL 8
+
+#if defined(__GNUC__) || defined(__clang__)
+typedef uint64_t bs_word __attribute__((vector_size(16)));
+#define BS_LANES 2
+#define BS_LANE(x, l) ((x)[l])
+#else
+typedef uint64_t bs_word;
+#define BS_LANES 1
+#define BS_LANE(x, l) (x)
+#endif
+
+// 8비트 슬라이스 전체에 S-Box 적용 (q[7]이 최상위 비트)
+static void bs_sbox(bs_word* q) {
+    bs_word x0, x1, x2, x3, x4, x5, x6, x7;
+    bs_word y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    bs_word y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    bs_word y20, y21;
+    bs_word z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    bs_word z10, z11, z12, z13, z14, z15, z16, z17;
+    bs_word t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    bs_word t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    bs_word t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    bs_word t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    bs_word t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    bs_word t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    bs_word t60, t61, t62, t63, t64, t65, t66, t67;
+    bs_word s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7]; x1 = q[6]; x2 = q[5]; x3 = q[4];
+    x4 = q[3]; x5 = q[2]; x6 = q[1]; x7 = q[0];
+
+    // 상단 선형 변환
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    // 비선형 구간 (GF(2^4) 역원 계산)
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    // 하단 선형 변환 (아핀 상수 0x63은 NOT으로 반영)
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+    q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+}
+
+// 8x8 비트 전치: 바이트 단위 표현 <-> 비트 슬라이스 표현 (자기 역연산)
+static void bs_ortho(bs_word* q) {
+#define BS_SWAPN(cl, ch, s, x, y) do { \
+        bs_word a_ = (x), b_ = (y); \
+        (x) = (a_ & (uint64_t)(cl)) | ((b_ & (uint64_t)(cl)) << (s)); \
+        (y) = ((a_ & (uint64_t)(ch)) >> (s)) | (b_ & (uint64_t)(ch)); \
+    } while (0)
+#define BS_SWAP2(x, y) BS_SWAPN(0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1, x, y)
+#define BS_SWAP4(x, y) BS_SWAPN(0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2, x, y)
+#define BS_SWAP8(x, y) BS_SWAPN(0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4, x, y)
+    BS_SWAP2(q[0], q[1]); BS_SWAP2(q[2], q[3]); BS_SWAP2(q[4], q[5]); BS_SWAP2(q[6], q[7]);
+    BS_SWAP4(q[0], q[2]); BS_SWAP4(q[1], q[3]); BS_SWAP4(q[4], q[6]); BS_SWAP4(q[5], q[7]);
+    BS_SWAP8(q[0], q[4]); BS_SWAP8(q[1], q[5]); BS_SWAP8(q[2], q[6]); BS_SWAP8(q[3], q[7]);
+#undef BS_SWAP8
+#undef BS_SWAP4
+#undef BS_SWAP2
+#undef BS_SWAPN
+}
+
+// 블록 하나(워드 4개)를 두 64비트 워드에 16비트 간격으로 펼쳐 넣음
+static void bs_interleave_in(uint64_t* q0, uint64_t* q1, const uint32_t* w) {
+    uint64_t x0 = w[0], x1 = w[1], x2 = w[2], x3 = w[3];
+    x0 |= (x0 << 16); x1 |= (x1 << 16); x2 |= (x2 << 16); x3 |= (x3 << 16);
+    x0 &= 0x0000FFFF0000FFFFULL; x1 &= 0x0000FFFF0000FFFFULL;
+    x2 &= 0x0000FFFF0000FFFFULL; x3 &= 0x0000FFFF0000FFFFULL;
+    x0 |= (x0 << 8); x1 |= (x1 << 8); x2 |= (x2 << 8); x3 |= (x3 << 8);
+    x0 &= 0x00FF00FF00FF00FFULL; x1 &= 0x00FF00FF00FF00FFULL;
+    x2 &= 0x00FF00FF00FF00FFULL; x3 &= 0x00FF00FF00FF00FFULL;
+    *q0 = x0 | (x2 << 8);
+    *q1 = x1 | (x3 << 8);
+}
+
+static void bs_interleave_out(uint32_t* w, uint64_t q0, uint64_t q1) {
+    uint64_t x0 = q0 & 0x00FF00FF00FF00FFULL;
+    uint64_t x1 = q1 & 0x00FF00FF00FF00FFULL;
+    uint64_t x2 = (q0 >> 8) & 0x00FF00FF00FF00FFULL;
+    uint64_t x3 = (q1 >> 8) & 0x00FF00FF00FF00FFULL;
+    x0 |= (x0 >> 8); x1 |= (x1 >> 8); x2 |= (x2 >> 8); x3 |= (x3 >> 8);
+    x0 &= 0x0000FFFF0000FFFFULL; x1 &= 0x0000FFFF0000FFFFULL;
+    x2 &= 0x0000FFFF0000FFFFULL; x3 &= 0x0000FFFF0000FFFFULL;
+    w[0] = (uint32_t)x0 | (uint32_t)(x0 >> 16);
+    w[1] = (uint32_t)x1 | (uint32_t)(x1 >> 16);
+    w[2] = (uint32_t)x2 | (uint32_t)(x2 >> 16);
+    w[3] = (uint32_t)x3 | (uint32_t)(x3 >> 16);
+}
+
+static void bs_shift_rows(bs_word* q) {
+    for (int i = 0; i < 8; i++) {
+        bs_word x = q[i];
+        q[i] = (x & 0x000000000000FFFFULL)
+             | ((x & 0x00000000FFF00000ULL) >> 4)
+             | ((x & 0x00000000000F0000ULL) << 12)
+             | ((x & 0x0000FF0000000000ULL) >> 8)
+             | ((x & 0x000000FF00000000ULL) << 8)
+             | ((x & 0xF000000000000000ULL) >> 12)
+             | ((x & 0x0FFF000000000000ULL) << 4);
+    }
+}
+
+static bs_word bs_rotr32(bs_word x) {
+    return (x << 32) | (x >> 32);
+}
+
+// MixColumns: xtimes는 비트 슬라이스 간 이동(q[7] 자리올림을 q[0],q[1],q[3],q[4]에 XOR)으로 계산
+static void bs_mix_columns(bs_word* q) {
+    bs_word q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    bs_word q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    bs_word r0 = (q0 >> 16) | (q0 << 48), r1 = (q1 >> 16) | (q1 << 48);
+    bs_word r2 = (q2 >> 16) | (q2 << 48), r3 = (q3 >> 16) | (q3 << 48);
+    bs_word r4 = (q4 >> 16) | (q4 << 48), r5 = (q5 >> 16) | (q5 << 48);
+    bs_word r6 = (q6 >> 16) | (q6 << 48), r7 = (q7 >> 16) | (q7 << 48);
+
+    q[0] = q7 ^ r7 ^ r0 ^ bs_rotr32(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ bs_rotr32(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ bs_rotr32(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ bs_rotr32(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ bs_rotr32(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ bs_rotr32(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ bs_rotr32(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ bs_rotr32(q7 ^ r7);
+}
+
+static void bs_add_round_key(bs_word* q, const bs_word* sk) {
+    for (int i = 0; i < 8; i++) q[i] ^= sk[i];
+}
+
+// 4블록 암호화 (q는 이미 비트 슬라이스 형태)
+static void bs_encrypt(int nr, const bs_word* sk, bs_word* q) {
+    bs_add_round_key(q, sk);
+    for (int r = 1; r < nr; r++) {
+        bs_sbox(q);
+        bs_shift_rows(q);
+        bs_mix_columns(q);
+        bs_add_round_key(q, sk + r * 8);
+    }
+    bs_sbox(q);
+    bs_shift_rows(q);
+    bs_add_round_key(q, sk + nr * 8);
+}
+
+// 라운드 키를 모든 블록(모든 레인)에 복제한 비트 슬라이스 형태로 변환
+static void bs_expand_round_keys(const AES_CTX* ctx, bs_word* sk) {
+    for (int r = 0; r <= ctx->Nr; r++) {
+        uint32_t w[4];
+        uint64_t k0, k1;
+        bs_word* q = sk + r * 8;
+        for (int i = 0; i < 4; i++) w[i] = load32_le(ctx->round_keys + r * 16 + i * 4);
+        bs_interleave_in(&k0, &k1, w);
+        for (int i = 0; i < 4; i++) {
+            for (int l = 0; l < BS_LANES; l++) {
+                BS_LANE(q[i], l) = k0;
+                BS_LANE(q[i + 4], l) = k1;
+            }
+        }
+        bs_ortho(q);
+    }
+}
+
+// SubWord를 비트 슬라이스 S-Box로 계산 (키 스케줄에서도 테이블 조회를 피함)
+static uint32_t bs_sub_word(uint32_t x) {
+    bs_word q[8];
+    memset(q, 0, sizeof(q));
+    BS_LANE(q[0], 0) = x;
+    bs_ortho(q);
+    bs_sbox(q);
+    bs_ortho(q);
+    return (uint32_t)BS_LANE(q[0], 0);
+}
+
+// 상수시간 키 스케줄 (리틀엔디언 워드 단위, 결과는 KeySchedule128/192/256과 동일)
+static void bs_key_schedule(const uint8_t* key, AES_CTX* ctx) {
+    const int nk = ctx->Nk;
+    const int total = 4 * (ctx->Nr + 1);
+    uint32_t w[4 * (AES_ROUND_256 + 1)];
+
+    for (int i = 0; i < nk; i++) w[i] = load32_le(key + i * 4);
+    for (int i = nk; i < total; i++) {
+        uint32_t temp = w[i - 1];
+        if (i % nk == 0) {
+            temp = (temp >> 8) | (temp << 24); // RotWord
+            temp = bs_sub_word(temp) ^ Rcon[i / nk];
+        } else if (nk > 6 && i % nk == 4) {
+            temp = bs_sub_word(temp);
+        }
+        w[i] = w[i - nk] ^ temp;
+    }
+    for (int i = 0; i < total; i++) store32_le(ctx->round_keys + i * 4, w[i]);
+}
+
+static void bs_ctr_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out,
+                         uint8_t nonce_counter[AES_BLOCK_SIZE]) {
+    bs_word sk[8 * (AES_ROUND_256 + 1)];
+    bs_expand_round_keys(ctx, sk);
+
+    uint64_t ctr_hi, ctr_lo;
+    ctr_split(nonce_counter, &ctr_hi, &ctr_lo);
+
+    while (length > 0) {
+        uint32_t w[BS_CTR_PARALLEL * 4];
+        uint8_t keystream[BS_CTR_PARALLEL * AES_BLOCK_SIZE];
+
+        // 카운터 블록 8개를 리틀엔디언 워드로 구성 (바이트 순서는 big-endian 카운터)
+        for (int j = 0; j < BS_CTR_PARALLEL; j++) {
+            uint8_t block[AES_BLOCK_SIZE];
+            ctr_make_block(block, ctr_hi, ctr_lo, (uint64_t)j);
+            for (int i = 0; i < 4; i++) w[j * 4 + i] = load32_le(block + i * 4);
+        }
+
+        // 레인 l에는 블록 g + 4l .. g + 4l + 3을 담음
+        for (int g = 0; g < BS_CTR_PARALLEL; g += 4 * BS_LANES) {
+            bs_word q[8];
+            for (int l = 0; l < BS_LANES; l++) {
+                for (int i = 0; i < 4; i++) {
+                    uint64_t a, b;
+                    bs_interleave_in(&a, &b, w + (g + 4 * l + i) * 4);
+                    BS_LANE(q[i], l) = a;
+                    BS_LANE(q[i + 4], l) = b;
+                }
+            }
+            bs_ortho(q);
+            bs_encrypt(ctx->Nr, sk, q);
+            bs_ortho(q);
+            for (int l = 0; l < BS_LANES; l++) {
+                for (int i = 0; i < 4; i++) {
+                    bs_interleave_out(w + (g + 4 * l + i) * 4, BS_LANE(q[i], l), BS_LANE(q[i + 4], l));
+                }
+            }
+        }
+        for (int i = 0; i < BS_CTR_PARALLEL * 4; i++) store32_le(keystream + i * 4, w[i]);
+
+        size_t n = (length < sizeof(keystream)) ? length : sizeof(keystream);
+        ctr_xor(out, in, keystream, n);
+
+        // 처리한 블록 수만큼 카운터 증가 (마지막 부분 블록도 1블록으로 계산)
+        ctr_advance(&ctr_hi, &ctr_lo, (n + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE);
+
+        in += n;
+        out += n;
+        length -= n;
+    }
+
+    ctr_join(nonce_counter, ctr_hi, ctr_lo);
+}
+
+
+/*****************************************************
+ * 구현 선택 (런타임 디스패치)
+ * 기본값(AUTO)은 CPU 기능을 보고 가장 빠른 구현을 고르며,
+ * 테스트에서는 AES_set_impl로 특정 구현을 강제할 수 있습니다.
+ *****************************************************/
+static AES_IMPL g_aes_forced_impl = AES_IMPL_AUTO;
+
+// AES-NI 명령어 기반 구현인지 (키 스케줄/단일 블록은 AES-NI 코드를 공유)
+static int aes_impl_uses_aesni(AES_IMPL impl) {
+    return impl == AES_IMPL_AESNI || impl == AES_IMPL_VAES_AVX2 || impl == AES_IMPL_VAES_AVX512;
+}
+
+int AES_impl_available(AES_IMPL impl) {
+    switch (impl) {
+        case AES_IMPL_AUTO:
+        case AES_IMPL_TABLE:
+        case AES_IMPL_BITSLICE:
+            return 1;
+#ifdef AES_HAVE_AESNI
+        case AES_IMPL_AESNI: {
+            uint32_t f = platform_cpu_features();
+            return (f & PLATFORM_CPU_AESNI) && (f & PLATFORM_CPU_SSSE3);
+        }
+        case AES_IMPL_VAES_AVX2: {
+            uint32_t f = platform_cpu_features();
+            return AES_impl_available(AES_IMPL_AESNI) && (f & PLATFORM_CPU_VAES) && (f & PLATFORM_CPU_AVX2);
+        }
+        case AES_IMPL_VAES_AVX512: {
+            uint32_t f = platform_cpu_features();
+            return AES_impl_available(AES_IMPL_VAES_AVX2) &&
+                   (f & PLATFORM_CPU_AVX512F) && (f & PLATFORM_CPU_AVX512BW);
+        }
+        case AES_IMPL_VPAES:
+            return (platform_cpu_features() & PLATFORM_CPU_SSSE3) != 0;
+#endif
+        default:
+            return 0;
+    }
+}
+
+CRYPTO_STATUS AES_set_impl(AES_IMPL impl) {
+    if (!AES_impl_available(impl)) return CRYPTO_ERR_INVALID_ARGUMENT;
+    g_aes_forced_impl = impl;
+    return CRYPTO_SUCCESS;
+}
+
+// 하드웨어 AES가 없으면 T-tables가 더 빨라도 비트슬라이스를 고름: T-tables는 키에 따라 달라지는
+// 메모리 주소를 읽으므로 캐시 타이밍으로 키가 샐 수 있음. 그 대가로 AES-128 CTR(64KB, 1스레드) 처리량은
+// T-tables의 약 70~85% (x86-64 SSE2 2레인 기준, 64비트 스칼라 경로는 약 45~55%)
+AES_IMPL AES_get_impl(void) {
+    if (g_aes_forced_impl != AES_IMPL_AUTO) return g_aes_forced_impl;
+    if (AES_impl_available(AES_IMPL_VAES_AVX512)) return AES_IMPL_VAES_AVX512;
+    if (AES_impl_available(AES_IMPL_VAES_AVX2)) return AES_IMPL_VAES_AVX2;
+    if (AES_impl_available(AES_IMPL_AESNI)) return AES_IMPL_AESNI;
+    if (AES_impl_available(AES_IMPL_VPAES)) return AES_IMPL_VPAES; // AES-NI가 없거나 숨겨진 SSSE3 CPU
+    return AES_IMPL_BITSLICE; // 하드웨어 AES가 없으면 상수시간 비트슬라이스 구현
+}
+
+const char* AES_impl_name(AES_IMPL impl) {
+    switch (impl) {
+        case AES_IMPL_AUTO:  return "auto";
+        case AES_IMPL_TABLE: return "table";
+        case AES_IMPL_BITSLICE: return "bitslice";
+        case AES_IMPL_VPAES: return "vpaes-ssse3";
+        case AES_IMPL_AESNI: return "aes-ni";
+        case AES_IMPL_VAES_AVX2:   return "vaes-avx2";
+        case AES_IMPL_VAES_AVX512: return "vaes-avx512";
+        default:             return "unknown";
+    }
+}
+
 
 /*****************************************************
  * Crypto API 함수 구현
@@ -382,21 +1730,34 @@ CRYPTO_STATUS AES_set_key(AES_CTX* ctx, const uint8_t* key, int key_bits) {
     ctx->Nk = key_bits / 32; // Nk: 키 길이를 32비트 워드 단위로 나타낸 값
 
     switch (key_bits) {
-        case 128:
-            ctx->Nr = AES_ROUND_128; // Nr: 라운드 수
-            KeySchedule128(key, ctx);
-            break;
-        case 192:
-            ctx->Nr = AES_ROUND_192;
-            KeySchedule192(key, ctx);
-            break;
-        case 256:
-            ctx->Nr = AES_ROUND_256;
-            KeySchedule256(key, ctx);
-            break;
+        case 128: ctx->Nr = AES_ROUND_128; break; // Nr: 라운드 수
+        case 192: ctx->Nr = AES_ROUND_192; break;
+        case 256: ctx->Nr = AES_ROUND_256; break;
         default:
             return CRYPTO_ERR_INVALID_ARGUMENT; // 지원하지 않는 키 길이
     }
+
+    // 어느 구현이든 라운드 키(암호화/복호화 모두)는 바이트 단위로 동일하게 생성됨
+    AES_IMPL impl = AES_get_impl();
+#ifdef AES_HAVE_AESNI
+    if (aes_impl_uses_aesni(impl)) { // AES-NI 계열은 AESKEYGENASSIST로 키 확장, AESIMC로 복호화 키 생성
+        if (key_bits == 128) aesni_key_schedule128(key, ctx);
+        else if (key_bits == 192) aesni_key_schedule192(key, ctx);
+        else aesni_key_schedule256(key, ctx);
+        aesni_key_schedule_inv(ctx);
+        return CRYPTO_SUCCESS;
+    }
+#endif
+    if (impl == AES_IMPL_BITSLICE || impl == AES_IMPL_VPAES) { // S-Box 테이블 조회가 없는 상수시간 키 확장
+        bs_key_schedule(key, ctx);
+    } else {
+        switch (key_bits) {
+            case 128: KeySchedule128(key, ctx); break;
+            case 192: KeySchedule192(key, ctx); break;
+            default:  KeySchedule256(key, ctx); break;
+        }
+    }
+    KeyScheduleInv(ctx); // 복호화 라운드 키는 키 설정 시 한 번만 계산
     return CRYPTO_SUCCESS;
 }
 
@@ -410,28 +1771,18 @@ CRYPTO_STATUS AES_set_key(AES_CTX* ctx, const uint8_t* key, int key_bits) {
 CRYPTO_STATUS AES_encrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
     if (!ctx || !in || !out) return CRYPTO_ERR_NULL_CONTEXT;
 
-    // 1. 입력 평문을 4x4 state 행렬로 변환
-    uint8_t state[4][4];
-    for(int i=0; i<4; i++) for(int j=0; j<4; j++) state[j][i] = in[i*4+j];
-
-    // 2. 초기 라운드: AddRoundKey
-    AddRoundKey(state, ctx->round_keys);
-
-    // 3. 메인 라운드: (Nr - 1)번 반복
-    // T-tables 최적화: ShiftRows 후 SubBytesAndMixColumns를 한 번에 수행
-    for (int r = 1; r < ctx->Nr; r++) {
-        ShiftRows(state);
-        SubBytesAndMixColumns(state); // T-tables 사용: SubBytes + MixColumns 동시 수행
-        AddRoundKey(state, ctx->round_keys + r * 16); // r번째 라운드 키 사용
+#ifdef AES_HAVE_AESNI
+    if (aes_impl_uses_aesni(AES_get_impl())) {
+        aesni_encrypt_block(ctx, in, out); // 단일 블록은 광폭 레지스터의 이득이 없음
+        return CRYPTO_SUCCESS;
     }
+    if (AES_get_impl() == AES_IMPL_VPAES) {
+        vpaes_encrypt_block(ctx, in, out);
+        return CRYPTO_SUCCESS;
+    }
+#endif
 
-    // 4. 마지막 라운드: MixColumns 제외
-    SubBytes(state);
-    ShiftRows(state);
-    AddRoundKey(state, ctx->round_keys + ctx->Nr * 16);
-
-    // 5. state 행렬을 출력 버퍼로 변환
-    for(int i=0; i<4; i++) for(int j=0; j<4; j++) out[i*4+j] = state[j][i];
+    table_encrypt_block(ctx, in, out);
     return CRYPTO_SUCCESS;
 }
 
@@ -445,31 +1796,156 @@ CRYPTO_STATUS AES_encrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_S
 CRYPTO_STATUS AES_decrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]) {
     if (!ctx || !in || !out) return CRYPTO_ERR_NULL_CONTEXT;
 
-    // 1. 입력 암호문을 4x4 state 행렬로 변환
-    uint8_t state[4][4];
-    for(int i=0; i<4; i++) for(int j=0; j<4; j++) state[j][i] = in[i*4+j];
+#ifdef AES_HAVE_AESNI
+    if (aes_impl_uses_aesni(AES_get_impl())) {
+        aesni_decrypt_block(ctx, in, out);
+        return CRYPTO_SUCCESS;
+    }
+    if (AES_get_impl() == AES_IMPL_VPAES) {
+        vpaes_decrypt_block(ctx, in, out);
+        return CRYPTO_SUCCESS;
+    }
+#endif
 
-    // 2. 초기 라운드: AddRoundKey (마지막 라운드 키 사용)
-    AddRoundKey(state, ctx->round_keys + ctx->Nr * 16);
+    table_decrypt_block(ctx, in, out);
+    return CRYPTO_SUCCESS;
+}
+
+
+// CTR 직렬 처리: 선택된 구현의 커널로 디스패치 (멀티스레드 경로의 각 작업자도 이 함수를 호출)
+static void aes_ctr_crypt_serial(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out,
+                                 uint8_t nonce_counter[AES_BLOCK_SIZE]) {
+    switch (AES_get_impl()) {
+#ifdef AES_HAVE_AESNI
+        case AES_IMPL_VAES_AVX512:
+            vaes512_ctr_crypt(ctx, in, length, out, nonce_counter);
+            return;
+        case AES_IMPL_VAES_AVX2:
+            vaes256_ctr_crypt(ctx, in, length, out, nonce_counter);
+            return;
+        case AES_IMPL_AESNI:
+            aesni_ctr_crypt(ctx, in, length, out, nonce_counter);
+            return;
+        case AES_IMPL_VPAES:
+            vpaes_ctr_crypt(ctx, in, length, out, nonce_counter);
+            return;
+#endif
+        case AES_IMPL_BITSLICE:
+            bs_ctr_crypt(ctx, in, length, out, nonce_counter);
+            return;
+        default:
+            break;
+    }
+    
+    // T-tables 경로: 카운터 블록을 TABLE_CTR_PARALLEL개씩 만들어 한꺼번에 암호화한 뒤,
+    // 키스트림을 8바이트 단위로 입력과 XOR해 바로 출력 버퍼에 씀 (in == out이어도 추가 복사 없음)
+    uint8_t counter_blocks[TABLE_CTR_PARALLEL * AES_BLOCK_SIZE];
+    uint8_t keystream[TABLE_CTR_PARALLEL * AES_BLOCK_SIZE];
+    uint64_t ctr_hi, ctr_lo;
+    ctr_split(nonce_counter, &ctr_hi, &ctr_lo);
+
+    while (length > 0) {
+        size_t n = (length < sizeof(keystream)) ? length : sizeof(keystream);
+        size_t blocks = (n + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE; // 마지막 부분 블록도 1블록
 
-    // 3. 메인 라운드: (Nr - 1)번 반복 (역순)
-    // T-tables 최적화: InvShiftRows 후 InvSubBytesAndMixColumns를 한 번에 수행
-    for (int r = ctx->Nr - 1; r >= 1; r--) {
-        InvShiftRows(state);
-        InvSubBytesAndMixColumns(state); // Inverse T-tables 사용: InvSubBytes + InvMixColumns 동시 수행
-        AddRoundKey(state, ctx->round_keys + r * 16); // r번째 라운드 키 사용
+        for (size_t j = 0; j < blocks; j++) {
+            ctr_make_block(counter_blocks + j * AES_BLOCK_SIZE, ctr_hi, ctr_lo, (uint64_t)j);
+        }
+        for (size_t j = 0; j < blocks; j++) {
+            table_encrypt_block(ctx, counter_blocks + j * AES_BLOCK_SIZE, keystream + j * AES_BLOCK_SIZE);
+        }
+        ctr_xor(out, in, keystream, n);
+
+        ctr_advance(&ctr_hi, &ctr_lo, blocks);
+        in += n;
+        out += n;
+        length -= n;
     }
 
-    // 4. 마지막 라운드: InvMixColumns 제외
-    InvShiftRows(state);
-    InvSubBytes(state);
-    AddRoundKey(state, ctx->round_keys); // 초기 라운드 키 사용
+    ctr_join(nonce_counter, ctr_hi, ctr_lo);
+}
+
+/*****************************************************
+ * 멀티스레드 CTR
+ * CTR 블록은 서로 독립이므로 버퍼를 블록 경계에서 연속 구간으로 나누고,
+ * 각 작업자의 시작 카운터를 (시작 카운터 + 앞 구간의 블록 수)로 직접 계산해 병렬 처리합니다.
+ * 결과는 직렬 경로와 바이트 단위로 동일하며, nonce_counter는 전체 블록 수만큼 증가합니다.
+ * 작업자 스레드는 호출마다 생성/합류하므로, 스레드 생성 비용이 묻히도록
+ * 임계값 이상 길이에서만, 작업자당 최소 AES_CTR_MIN_WORKER_BYTES씩 배분합니다.
+ *****************************************************/
+#define AES_CTR_MAX_WORKERS 64
+#define AES_CTR_MIN_WORKER_BYTES (64 * 1024)
+#define AES_CTR_DEFAULT_THRESHOLD (256 * 1024)
+
+static size_t g_aes_ctr_threshold = AES_CTR_DEFAULT_THRESHOLD;
+static int g_aes_ctr_workers = 0; // 0 = CPU 코어 수
+
+typedef struct {
+    const AES_CTX* ctx;
+    const uint8_t* in;
+    uint8_t* out;
+    size_t length;
+    uint8_t counter[AES_BLOCK_SIZE]; // 이 구간의 시작 카운터 블록
+} AES_CTR_JOB;
+
+static void aes_ctr_worker(void* arg) {
+    AES_CTR_JOB* job = (AES_CTR_JOB*)arg;
+    aes_ctr_crypt_serial(job->ctx, job->in, job->length, job->out, job->counter);
+}
 
-    // 5. state 행렬을 출력 버퍼로 변환
-    for(int i=0; i<4; i++) for(int j=0; j<4; j++) out[i*4+j] = state[j][i];
+CRYPTO_STATUS AES_CTR_set_parallel(size_t threshold_bytes, int workers) {
+    if (workers < 0) return CRYPTO_ERR_INVALID_ARGUMENT;
+    g_aes_ctr_threshold = threshold_bytes;
+    g_aes_ctr_workers = (workers > AES_CTR_MAX_WORKERS) ? AES_CTR_MAX_WORKERS : workers;
     return CRYPTO_SUCCESS;
 }
 
+// 이번 호출에 사용할 작업자 수 (1이면 직렬)
+static int aes_ctr_worker_count(size_t length) {
+    if (length < g_aes_ctr_threshold) return 1;
+    int workers = g_aes_ctr_workers;
+    if (workers == 0) {
+        workers = platform_cpu_count();
+        if (workers > AES_CTR_MAX_WORKERS) workers = AES_CTR_MAX_WORKERS;
+    }
+    size_t by_size = (length + AES_CTR_MIN_WORKER_BYTES - 1) / AES_CTR_MIN_WORKER_BYTES;
+    if ((size_t)workers > by_size) workers = (int)by_size;
+    return workers > 1 ? workers : 1;
+}
+
+static void aes_ctr_crypt_parallel(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out,
+                                   uint8_t nonce_counter[AES_BLOCK_SIZE], int workers) {
+    AES_CTR_JOB jobs[AES_CTR_MAX_WORKERS];
+    platform_thread threads[AES_CTR_MAX_WORKERS];
+    int started[AES_CTR_MAX_WORKERS];
+
+    size_t total_blocks = (length + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE; // 마지막 부분 블록도 1블록
+    size_t share = (total_blocks + (size_t)workers - 1) / (size_t)workers * AES_BLOCK_SIZE; // 블록 경계로 나눔
+    uint64_t ctr_hi, ctr_lo;
+    ctr_split(nonce_counter, &ctr_hi, &ctr_lo);
+
+    int n = 0;
+    for (size_t pos = 0; pos < length; pos += share, n++) {
+        uint64_t hi = ctr_hi, lo = ctr_lo;
+        ctr_advance(&hi, &lo, pos / AES_BLOCK_SIZE);
+        jobs[n].ctx = ctx;
+        jobs[n].in = in + pos;
+        jobs[n].out = out + pos;
+        jobs[n].length = (length - pos < share) ? length - pos : share;
+        ctr_join(jobs[n].counter, hi, lo);
+    }
+
+    // 첫 구간은 호출한 스레드가 직접 처리. 스레드 생성에 실패한 구간도 여기서 직렬로 처리
+    for (int i = 1; i < n; i++) started[i] = platform_thread_start(&threads[i], aes_ctr_worker, &jobs[i]);
+    aes_ctr_worker(&jobs[0]);
+    for (int i = 1; i < n; i++) {
+        if (started[i]) platform_thread_join(&threads[i]);
+        else aes_ctr_worker(&jobs[i]);
+    }
+
+    ctr_advance(&ctr_hi, &ctr_lo, total_blocks);
+    ctr_join(nonce_counter, ctr_hi, ctr_lo);
+}
 
 /**
  * @brief AES_CTR_crypt: AES 카운터(CTR) 모드로 암호화 또는 복호화를 수행합니다.
@@ -477,6 +1953,7 @@ CRYPTO_STATUS AES_decrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_S
  * Nonce(재사용 금지 값)와 Counter를 합쳐 암호화한 결과를 '키스트림'으로 만들고,
  * 이 키스트림을 평문(또는 암호문)과 XOR하여 암호문(또는 평문)을 생성합니다.
  * 암호화와 복호화 과정이 동일하다는 장점이 있습니다.
+ * * 길이가 AES_CTR_set_parallel로 설정한 임계값 이상이면 여러 스레드로 나눠 처리합니다 (결과는 동일).
  * * @param ctx 초기화된 AES 컨텍스트
  * @param in 입력 데이터 (평문 또는 암호문)
  * @param length 입력 데이터의 길이 (바이트)
@@ -488,37 +1965,212 @@ CRYPTO_STATUS AES_CTR_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length
     if (!ctx) return CRYPTO_ERR_NULL_CONTEXT;
     if ((!in || !out) && length > 0) return CRYPTO_ERR_INVALID_INPUT;
     if (!nonce_counter) return CRYPTO_ERR_INVALID_INPUT;
-    
-    uint8_t counter_block[AES_BLOCK_SIZE]; // 현재 카운터 값 (암호화 대상)
-    uint8_t keystream_block[AES_BLOCK_SIZE]; // 카운터를 암호화한 결과 (키스트림)
-    size_t offset = 0;
 
-    memcpy(counter_block, nonce_counter, AES_BLOCK_SIZE);
+    int workers = aes_ctr_worker_count(length);
+    if (workers > 1) aes_ctr_crypt_parallel(ctx, in, length, out, nonce_counter, workers);
+    else aes_ctr_crypt_serial(ctx, in, length, out, nonce_counter);
+    return CRYPTO_SUCCESS;
+}
 
-    // 데이터를 16바이트 블록 단위로 처리
-    while (length > 0) {
-        // 1. 현재 카운터 블록을 AES로 암호화하여 키스트림 생성
-        AES_encrypt_block(ctx, counter_block, keystream_block);
+/**
+ * @brief AES_CTR_crypt_at: 스트림의 임의 바이트 위치부터 CTR 암복호화를 수행합니다 (랜덤 액세스).
+ * * CTR 키스트림의 byte_offset 위치는 카운터 블록 nonce_counter + byte_offset / 16 의
+ *   (byte_offset % 16)번째 바이트이므로, 앞부분을 처리하지 않고 바로 계산할 수 있습니다.
+ * * 시작 위치가 블록 중간이면 첫 블록의 키스트림 일부만 사용하고, 이후는 AES_CTR_crypt와 같습니다.
+ * @param ctx 초기화된 AES 컨텍스트
+ * @param nonce_counter 스트림 시작(오프셋 0)의 16바이트 Nonce+Counter 블록. 변경되지 않습니다.
+ * @param byte_offset 스트림 시작으로부터의 바이트 오프셋
+ * @param in 입력 데이터 (스트림의 byte_offset 위치부터 length바이트)
+ * @param length 입력 데이터의 길이 (바이트)
+ * @param out 출력 데이터가 저장될 버퍼 (in과 같아도 됨)
+ * @return 성공 시 CRYPTO_SUCCESS
+ */
+static CRYPTO_STATUS aes_ctr_crypt_at(const AES_CTX* ctx, const uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t byte_offset,
+                                      const uint8_t* in, size_t length, uint8_t* out, int allow_parallel) {
+    if (!ctx) return CRYPTO_ERR_NULL_CONTEXT;
+    if ((!in || !out) && length > 0) return CRYPTO_ERR_INVALID_INPUT;
+    if (!nonce_counter) return CRYPTO_ERR_INVALID_INPUT;
 
-        // 처리할 데이터 길이 결정 (마지막 블록은 16바이트보다 작을 수 있음)
-        size_t block_len = (length < AES_BLOCK_SIZE) ? length : AES_BLOCK_SIZE;
+    uint8_t counter[AES_BLOCK_SIZE];
+    uint64_t ctr_hi, ctr_lo;
+    ctr_split(nonce_counter, &ctr_hi, &ctr_lo);
+    ctr_advance(&ctr_hi, &ctr_lo, byte_offset / AES_BLOCK_SIZE);
+    ctr_join(counter, ctr_hi, ctr_lo);
+
+    size_t skip = (size_t)(byte_offset % AES_BLOCK_SIZE);
+    if (skip > 0 && length > 0) { // 블록 중간에서 시작: 첫 블록 키스트림의 뒷부분만 사용
+        // 키스트림 블록도 선택된 CTR 커널로 만듦 (AES_encrypt_block은 비트슬라이스 선택 시 T-tables로 가므로
+        // 캐시 타이밍 누출을 피하려고 고른 구현을 우회하게 됨)
+        static const uint8_t zero_block[AES_BLOCK_SIZE] = { 0 };
+        uint8_t keystream_block[AES_BLOCK_SIZE];
+        uint8_t block_counter[AES_BLOCK_SIZE];
+        size_t n = AES_BLOCK_SIZE - skip;
+        if (n > length) n = length;
+        memcpy(block_counter, counter, AES_BLOCK_SIZE);
+        aes_ctr_crypt_serial(ctx, zero_block, AES_BLOCK_SIZE, keystream_block, block_counter);
+        ctr_xor(out, in, keystream_block + skip, n);
+        ctr_advance(&ctr_hi, &ctr_lo, 1);
+        ctr_join(counter, ctr_hi, ctr_lo);
+        in += n;
+        out += n;
+        length -= n;
+    }
+    if (!allow_parallel) {
+        aes_ctr_crypt_serial(ctx, in, length, out, counter);
+        return CRYPTO_SUCCESS;
+    }
+    return AES_CTR_crypt(ctx, in, length, out, counter);
+}
 
-        // 2. 입력 데이터와 키스트림을 XOR하여 출력 생성
-        for (size_t i = 0; i < block_len; i++) {
-            out[offset + i] = in[offset + i] ^ keystream_block[i];
-        }
+CRYPTO_STATUS AES_CTR_crypt_at(const AES_CTX* ctx, const uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t byte_offset,
+                               const uint8_t* in, size_t length, uint8_t* out) {
+    return aes_ctr_crypt_at(ctx, nonce_counter, byte_offset, in, length, out, 1);
+}
 
-        length -= block_len;
-        offset += block_len;
-        
-        // 3. 다음 블록을 위해 카운터 값을 1 증가 (big-endian 방식)
-        for (int i = AES_BLOCK_SIZE - 1; i >= 0; i--) {
-            if (++counter_block[i] != 0) break; // 자리올림이 없으면 중단
-        }
+/**
+ * @brief AES_CTR_crypt_at_serial: AES_CTR_crypt_at과 같지만 멀티스레드 CTR 설정과 관계없이 호출한 스레드에서만 처리합니다.
+ * * 파일 청크 엔진처럼 이미 데이터를 여러 스레드로 나눠 처리하는 호출자가 스레드를 중첩해서 만들지 않도록 합니다.
+ */
+CRYPTO_STATUS AES_CTR_crypt_at_serial(const AES_CTX* ctx, const uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t byte_offset,
+                                      const uint8_t* in, size_t length, uint8_t* out) {
+    return aes_ctr_crypt_at(ctx, nonce_counter, byte_offset, in, length, out, 0);
+}
+
+// ECB 공통 디스패치 (decrypt가 0이면 암호화). 비트슬라이스 구현은 CTR 전용이므로 T-tables 사용
+static void aes_ecb_crypt(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out, int decrypt) {
+    switch (AES_get_impl()) {
+#ifdef AES_HAVE_AESNI
+        case AES_IMPL_VAES_AVX512:
+            vaes512_ecb_crypt(ctx, in, blocks, out, decrypt);
+            return;
+        case AES_IMPL_VAES_AVX2:
+            vaes256_ecb_crypt(ctx, in, blocks, out, decrypt);
+            return;
+        case AES_IMPL_AESNI:
+            aesni_ecb_crypt(ctx, in, blocks, out, decrypt);
+            return;
+        case AES_IMPL_VPAES:
+            vpaes_ecb_crypt(ctx, in, blocks, out, decrypt);
+            return;
+#endif
+        default:
+            break;
+    }
+
+    for (size_t i = 0; i < blocks; i++) {
+        if (decrypt) table_decrypt_block(ctx, in + i * AES_BLOCK_SIZE, out + i * AES_BLOCK_SIZE);
+        else table_encrypt_block(ctx, in + i * AES_BLOCK_SIZE, out + i * AES_BLOCK_SIZE);
+    }
+}
+
+/**
+ * @brief AES_ECB_encrypt_blocks: 16바이트 블록 여러 개를 각각 독립적으로 암호화합니다 (ECB).
+ * * 블록 간 의존이 없으므로 하드웨어 구현은 여러 블록을 한꺼번에 파이프라인에 넣어 처리합니다.
+ * @param ctx 초기화된 AES 컨텍스트
+ * @param in 입력 블록들 (blocks * 16바이트)
+ * @param blocks 블록 개수 (0이면 아무것도 하지 않고 성공)
+ * @param out 출력 버퍼 (in과 같아도 됨)
+ * @return 성공 시 CRYPTO_SUCCESS
+ */
+CRYPTO_STATUS AES_ECB_encrypt_blocks(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out) {
+    if (!ctx) return CRYPTO_ERR_NULL_CONTEXT;
+    if ((!in || !out) && blocks > 0) return CRYPTO_ERR_INVALID_INPUT;
+
+    aes_ecb_crypt(ctx, in, blocks, out, 0);
+    return CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief AES_ECB_decrypt_blocks: 16바이트 블록 여러 개를 각각 독립적으로 복호화합니다 (ECB).
+ * * 키 설정 시 미리 계산한 복호화 라운드 키(dec_round_keys)를 사용합니다.
+ */
+CRYPTO_STATUS AES_ECB_decrypt_blocks(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out) {
+    if (!ctx) return CRYPTO_ERR_NULL_CONTEXT;
+    if ((!in || !out) && blocks > 0) return CRYPTO_ERR_INVALID_INPUT;
+
+    aes_ecb_crypt(ctx, in, blocks, out, 1);
+    return CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief AES_CBC_encrypt: AES CBC 모드로 암호화합니다 (패딩 없음).
+ * * C[i] = E(P[i] ^ C[i-1]), C[-1] = iv. 앞 블록의 결과가 다음 입력이 되므로 블록 단위로 직렬 처리됩니다.
+ * @param ctx 초기화된 AES 컨텍스트
+ * @param in 평문 (length바이트)
+ * @param length 입력 길이. AES_BLOCK_SIZE의 배수여야 함
+ * @param out 암호문 출력 버퍼 (in과 같아도 됨)
+ * @param iv 16바이트 IV. 호출 후 마지막 암호문 블록으로 갱신됩니다.
+ * @return 성공 시 CRYPTO_SUCCESS, 길이가 블록 배수가 아니면 CRYPTO_ERR_INVALID_INPUT
+ */
+CRYPTO_STATUS AES_CBC_encrypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out, uint8_t iv[AES_BLOCK_SIZE]) {
+    if (!ctx) return CRYPTO_ERR_NULL_CONTEXT;
+    if ((!in || !out) && length > 0) return CRYPTO_ERR_INVALID_INPUT;
+    if (!iv || length % AES_BLOCK_SIZE != 0) return CRYPTO_ERR_INVALID_INPUT;
+
+    size_t blocks = length / AES_BLOCK_SIZE;
+    switch (AES_get_impl()) {
+#ifdef AES_HAVE_AESNI
+        case AES_IMPL_VAES_AVX512:
+        case AES_IMPL_VAES_AVX2:
+        case AES_IMPL_AESNI:
+            aesni_cbc_encrypt(ctx, in, blocks, out, iv); // 직렬 연산이라 광폭 레지스터의 이득이 없음
+            return CRYPTO_SUCCESS;
+        case AES_IMPL_VPAES:
+            vpaes_cbc_encrypt(ctx, in, blocks, out, iv);
+            return CRYPTO_SUCCESS;
+#endif
+        default:
+            break;
+    }
+
+    uint8_t block[AES_BLOCK_SIZE];
+    for (size_t i = 0; i < blocks; i++) {
+        ctr_xor(block, in + i * AES_BLOCK_SIZE, iv, AES_BLOCK_SIZE);
+        table_encrypt_block(ctx, block, iv);
+        memcpy(out + i * AES_BLOCK_SIZE, iv, AES_BLOCK_SIZE);
+    }
+    return CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief AES_CBC_decrypt: AES CBC 모드로 복호화합니다 (패딩 제거 없음).
+ * * P[i] = D(C[i]) ^ C[i-1]. 각 D(C[i])는 서로 독립이므로 하드웨어 구현은 여러 블록을 병렬로 복호화합니다.
+ * * in == out (in-place)도 안전합니다.
+ * @param iv 16바이트 IV. 호출 후 마지막 암호문 블록으로 갱신됩니다.
+ * @return 성공 시 CRYPTO_SUCCESS, 길이가 블록 배수가 아니면 CRYPTO_ERR_INVALID_INPUT
+ */
+CRYPTO_STATUS AES_CBC_decrypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out, uint8_t iv[AES_BLOCK_SIZE]) {
+    if (!ctx) return CRYPTO_ERR_NULL_CONTEXT;
+    if ((!in || !out) && length > 0) return CRYPTO_ERR_INVALID_INPUT;
+    if (!iv || length % AES_BLOCK_SIZE != 0) return CRYPTO_ERR_INVALID_INPUT;
+
+    size_t blocks = length / AES_BLOCK_SIZE;
+    switch (AES_get_impl()) {
+#ifdef AES_HAVE_AESNI
+        case AES_IMPL_VAES_AVX512:
+            vaes512_cbc_decrypt(ctx, in, blocks, out, iv);
+            return CRYPTO_SUCCESS;
+        case AES_IMPL_VAES_AVX2:
+            vaes256_cbc_decrypt(ctx, in, blocks, out, iv);
+            return CRYPTO_SUCCESS;
+        case AES_IMPL_AESNI:
+            aesni_cbc_decrypt(ctx, in, blocks, out, iv);
+            return CRYPTO_SUCCESS;
+        case AES_IMPL_VPAES:
+            vpaes_cbc_decrypt(ctx, in, blocks, out, iv);
+            return CRYPTO_SUCCESS;
+#endif
+        default:
+            break;
+    }
+
+    uint8_t cipher[AES_BLOCK_SIZE], plain[AES_BLOCK_SIZE];
+    for (size_t i = 0; i < blocks; i++) {
+        memcpy(cipher, in + i * AES_BLOCK_SIZE, AES_BLOCK_SIZE); // in-place 대비: 쓰기 전에 암호문 보관
+        table_decrypt_block(ctx, cipher, plain);
+        ctr_xor(out + i * AES_BLOCK_SIZE, plain, iv, AES_BLOCK_SIZE);
+        memcpy(iv, cipher, AES_BLOCK_SIZE);
     }
-    
-    // 최종적으로 증가된 카운터 값을 원래 nonce_counter 배열에 업데이트
-    memcpy(nonce_counter, counter_block, AES_BLOCK_SIZE); 
     return CRYPTO_SUCCESS;
 }
 
@@ -577,12 +2229,12 @@ static int load_openssl_mac(void) {
 #endif
 
 /**
- * @brief crypto_random_bytes: OpenSSL RAND_bytes를 사용하여 암호학적으로 안전한 난수를 생성합니다.
+ * @brief crypto_random_bytes: 암호학적으로 안전한 난수를 생성합니다.
  * @param buf 난수를 저장할 버퍼
  * @param len 생성할 난수의 바이트 수
- * @return 성공 시 CRYPTO_SUCCESS, 실패 시 CRYPTO_ERR_INTERNAL_FAILURE
- * @note macOS에서는 런타임에 OpenSSL을 동적으로 로드합니다.
- *       다른 플랫폼에서는 컴파일 시 -DUSE_OPENSSL 플래그와 OpenSSL 라이브러리 링크가 필요합니다.
+ * @return 성공 시 CRYPTO_SUCCESS, 안전한 난수원이 없으면 CRYPTO_ERR_INTERNAL_FAILURE
+ * @note OpenSSL RAND_bytes를 먼저 사용합니다 (macOS는 런타임에 동적 로드, 다른 플랫폼은 -DUSE_OPENSSL).
+ *       OpenSSL이 없거나 실패하면 OS 난수 생성기(platform_random_bytes)를 사용합니다.
  */
 CRYPTO_STATUS crypto_random_bytes(uint8_t* buf, size_t len) {
     if (!buf && len > 0) return CRYPTO_ERR_INVALID_INPUT;
@@ -592,26 +2244,15 @@ CRYPTO_STATUS crypto_random_bytes(uint8_t* buf, size_t len) {
     // 컴파일 타임에 OpenSSL이 링크된 경우
     if (RAND_bytes(buf, (int)len) == 1) {
         return CRYPTO_SUCCESS;
-    } else {
-        return CRYPTO_ERR_INTERNAL_FAILURE;
     }
 #elif defined(PLATFORM_MAC)
     // macOS: OpenSSL을 동적으로 로드 시도
-    if (load_openssl_mac() && g_rand_bytes) {
-        if (g_rand_bytes(buf, (int)len) == 1) {
-            return CRYPTO_SUCCESS;
-        } else {
-            return CRYPTO_ERR_INTERNAL_FAILURE;
-        }
+    if (load_openssl_mac() && g_rand_bytes && g_rand_bytes(buf, (int)len) == 1) {
+        return CRYPTO_SUCCESS;
     }
-    // OpenSSL을 찾지 못한 경우
-    return CRYPTO_ERR_INTERNAL_FAILURE;
-#else
-    // 다른 플랫폼 (Windows 등)
-    (void)buf;  // unused parameter warning 방지
-    (void)len;
-    return CRYPTO_ERR_INTERNAL_FAILURE;
 #endif
+    // OpenSSL이 없거나 실패한 경우 OS 난수 생성기
+    return platform_random_bytes(buf, len) ? CRYPTO_SUCCESS : CRYPTO_ERR_INTERNAL_FAILURE;
 }
 
 /*****************************************************
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <limits.h>
 #include <time.h>
 #include "crypto_api.h"
 #include "aes.h"
@@ -46,35 +47,172 @@ int validate_password(const char* password) {
     return 1;
 }
 
-// 키 도출: PBKDF2-SHA512 -> AES 키 + HMAC 키
-void derive_keys(const char* password, int aes_key_bits, 
-                 uint8_t* aes_key, uint8_t* hmac_key) {
-    // 1. 패스워드를 PBKDF2-SHA512로 512비트(64바이트)로 변환
-    uint8_t kdf_output[64];
-    pbkdf2_sha512((const uint8_t*)password, strlen(password),
-                  NULL, 0, 10000, kdf_output, 64);
-    
-    // 2. 상위 절반(32바이트)에서 AES 키 길이만큼 사용
+// 새로 암호화하는 파일에 기록할 PBKDF2 반복 횟수
+static uint32_t g_encrypt_kdf_iterations = KDF_DEFAULT_ITERATIONS;
+
+int set_encrypt_kdf_iterations(uint32_t iterations) {
+    if (iterations < ENC_KDF_MIN_ITERATIONS || iterations > ENC_KDF_MAX_ITERATIONS) return 0;
+    g_encrypt_kdf_iterations = iterations;
+    return 1;
+}
+
+uint32_t get_encrypt_kdf_iterations(void) {
+    return g_encrypt_kdf_iterations;
+}
+
+// 새로 암호화하는 파일의 청크 크기 (0이면 v3)
+static size_t g_encrypt_chunk_size = ENC_CHUNK_DEFAULT_SIZE;
+
+int set_encrypt_chunk_size(size_t chunk_size) {
+    if (chunk_size != 0 &&
+        (chunk_size % 16 != 0 || chunk_size < ENC_CHUNK_MIN_SIZE || chunk_size > ENC_CHUNK_MAX_SIZE)) {
+        return 0;
+    }
+    g_encrypt_chunk_size = chunk_size;
+    return 1;
+}
+
+size_t get_encrypt_chunk_size(void) {
+    return g_encrypt_chunk_size;
+}
+
+// v4 청크 엔진 스레드 수 (0이면 CPU 코어 수)
+static int g_file_crypto_workers = 0;
+
+int set_file_crypto_workers(int workers) {
+    if (workers < 0 || workers > ENC_ENGINE_MAX_WORKERS) return 0;
+    g_file_crypto_workers = workers;
+    return 1;
+}
+
+int get_file_crypto_workers(void) {
+    return g_file_crypto_workers;
+}
+
+// 실제로 쓸 스레드 수 (0이면 CPU 코어 수, 1 ~ ENC_ENGINE_MAX_WORKERS)
+static int file_crypto_worker_count(void) {
+    int workers = g_file_crypto_workers;
+    if (workers == 0) workers = platform_cpu_count();
+    if (workers > ENC_ENGINE_MAX_WORKERS) workers = ENC_ENGINE_MAX_WORKERS;
+    return workers < 1 ? 1 : workers;
+}
+
+// 64바이트 키 자료 -> AES 키 + HMAC 키
+static void split_keys(const uint8_t kdf_output[64], int aes_key_bits,
+                       uint8_t* aes_key, uint8_t* hmac_key) {
+    // 상위 절반(32바이트)에서 AES 키 길이만큼 사용
     int aes_key_bytes = aes_key_bits / 8;
     memcpy(aes_key, kdf_output, aes_key_bytes);
     
-    // 3. 하위 32바이트 중 처음 24바이트를 HMAC 키로 사용
+    // 하위 32바이트 중 처음 24바이트를 HMAC 키로 사용
     memcpy(hmac_key, kdf_output + 32, 24);
 }
 
-// 랜덤 nonce 생성 (OpenSSL RAND_bytes 사용)
+// 키 도출: PBKDF2-SHA512 -> AES 키 + HMAC 키
+// salt가 NULL이면 v1 고정 솔트 사용. 같은 (패스워드, 솔트, 반복 횟수)는 키 도출 캐시(kdf_cache_*)에서 재사용
+void derive_keys(const char* password, const uint8_t* salt, size_t salt_len, uint32_t iterations,
+                 int aes_key_bits, uint8_t* aes_key, uint8_t* hmac_key) {
+    // 패스워드를 PBKDF2-SHA512로 512비트(64바이트)로 변환
+    uint8_t kdf_output[64];
+    pbkdf2_sha512_cached((const uint8_t*)password, strlen(password),
+                         salt, salt_len, iterations, kdf_output, 64);
+    split_keys(kdf_output, aes_key_bits, aes_key, hmac_key);
+    memset(kdf_output, 0, sizeof(kdf_output));
+}
+
+// 파일별 하위 키 도출 (ENC_KDF_FLAG_SUBKEYS): HKDF-SHA512(salt = 파일 솔트 || nonce, IKM = 마스터 키)
+// 파일마다 솔트와 nonce가 다르므로 같은 마스터 키에서도 키가 겹치지 않음
+static void derive_subkeys(const uint8_t master[64], const uint8_t file_salt[16], const uint8_t nonce[8],
+                           int aes_key_bits, uint8_t* aes_key, uint8_t* hmac_key) {
+    static const char info[] = "AESC file subkeys";
+    uint8_t hkdf_salt[16 + 8];
+    uint8_t kdf_output[64];
+    memcpy(hkdf_salt, file_salt, 16);
+    memcpy(hkdf_salt + 16, nonce, 8);
+    hkdf_sha512(hkdf_salt, sizeof(hkdf_salt), master, 64,
+                (const uint8_t*)info, sizeof(info) - 1, kdf_output, sizeof(kdf_output));
+    split_keys(kdf_output, aes_key_bits, aes_key, hmac_key);
+    memset(kdf_output, 0, sizeof(kdf_output));
+}
+
+// 랜덤 nonce/솔트 생성 (OpenSSL RAND_bytes, 없으면 OS 난수 생성기)
+// 안전한 난수를 얻지 못하면 0 반환 - 예측 가능한 값으로 대체하지 않으므로 호출자는 암호화를 중단해야 함
 int generate_nonce(uint8_t* nonce, size_t len) {
-    if (crypto_random_bytes(nonce, len) == CRYPTO_SUCCESS) {
-        printf("[DEBUG] OpenSSL RAND_bytes random number generation succeeded\n");
-        return 1;
+    return crypto_random_bytes(nonce, len) == CRYPTO_SUCCESS;
+}
+
+// 일괄 암호화 세션 상태 (세션 동안 마스터 키를 보관하고 끝나면 지움)
+typedef struct {
+    int active;
+    uint8_t master[64];                   // PBKDF2(password, salt, iterations)
+    uint8_t salt[ENC_KDF_SALT_SIZE];      // 세션 공통 솔트
+    uint32_t iterations;
+    uint8_t password_tag[64];             // HMAC(master, password): 같은 패스워드인지 확인용
+} EncBatchSession;
+
+static EncBatchSession g_batch;
+static platform_mutex g_batch_lock = PLATFORM_MUTEX_INIT;
+static int g_batch_locked = 0;
+
+static void batch_password_tag(const uint8_t master[64], const char* password, uint8_t tag[64]) {
+    HMAC_SHA512_CTX hmac_ctx;
+    hmac_sha512_init(&hmac_ctx, master, 64);
+    hmac_sha512_update(&hmac_ctx, (const uint8_t*)password, strlen(password));
+    hmac_sha512_final(&hmac_ctx, tag);
+    hmac_sha512_wipe(&hmac_ctx);
+}
+
+int encrypt_batch_begin(const char* password) {
+    if (!password || password[0] == '\0') return 0;
+    
+    // 마스터 키 도출 (세션 전체에서 한 번)
+    EncBatchSession session;
+    session.active = 1;
+    session.iterations = g_encrypt_kdf_iterations;
+    if (!generate_nonce(session.salt, ENC_KDF_SALT_SIZE)) {
+        return 0;
     }
-    // OpenSSL이 없는 경우 fallback (보안상 권장하지 않음)
-    // srand는 main 함수에서 이미 호출됨
-    printf("[DEBUG] OpenSSL RAND_bytes failed, using fallback rand()\n");
-    for (size_t i = 0; i < len; i++) {
-        nonce[i] = (uint8_t)(rand() & 0xFF);
+    pbkdf2_sha512_cached((const uint8_t*)password, strlen(password),
+                         session.salt, ENC_KDF_SALT_SIZE, session.iterations, session.master, 64);
+    batch_password_tag(session.master, password, session.password_tag);
+    
+    platform_mutex_lock(&g_batch_lock);
+    if (!g_batch_locked) {
+        // 가능하면 스왑되지 않도록 잠금 (실패해도 세션은 사용)
+        g_batch_locked = platform_mem_lock(&g_batch, sizeof(g_batch));
     }
-    return 0; // fallback 사용됨을 표시
+    g_batch = session;
+    platform_mutex_unlock(&g_batch_lock);
+    
+    memset(&session, 0, sizeof(session));
+    return 1;
+}
+
+void encrypt_batch_end(void) {
+    platform_mutex_lock(&g_batch_lock);
+    memset(&g_batch, 0, sizeof(g_batch));
+    platform_mutex_unlock(&g_batch_lock);
+}
+
+// 세션이 켜져 있고 같은 패스워드면 마스터 키, 솔트, 반복 횟수를 복사하고 1 반환
+static int batch_session_get(const char* password, uint8_t master[64],
+                             uint8_t salt[ENC_KDF_SALT_SIZE], uint32_t* iterations) {
+    int found = 0;
+    platform_mutex_lock(&g_batch_lock);
+    if (g_batch.active) {
+        uint8_t tag[64];
+        uint8_t diff = 0;
+        batch_password_tag(g_batch.master, password, tag);
+        for (int i = 0; i < 64; i++) diff |= (uint8_t)(tag[i] ^ g_batch.password_tag[i]);
+        if (diff == 0) {
+            memcpy(master, g_batch.master, 64);
+            memcpy(salt, g_batch.salt, ENC_KDF_SALT_SIZE);
+            *iterations = g_batch.iterations;
+            found = 1;
+        }
+    }
+    platform_mutex_unlock(&g_batch_lock);
+    return found;
 }
 
 // 파일 경로에서 확장자 추출 (예: "file.txt" -> ".txt")
@@ -107,8 +245,251 @@ void extract_extension(const char* file_path, char* ext, size_t ext_size) {
     }
 }
 
+// 복호화할 파일의 헤더 정보 (버전별 차이를 한 곳에서 처리)
+typedef struct {
+    EncFileHeader header;
+    EncKdfParams kdf;          // v2에서만 유효
+    int has_kdf;               // 1이면 kdf를 헤더와 함께 HMAC에 포함
+    int mac_ciphertext;        // 1이면 HMAC이 암호문을 덮음 (v3), 0이면 평문 (v1/v2)
+    uint32_t iterations;       // PBKDF2 반복 횟수 (v1은 10000)
+    long header_size;          // 헤더 + 키 도출 파라미터 길이 (HMAC 앞까지, v4는 암호문 앞까지)
+    EncChunkParams chunk;      // v4에서만 유효
+    int chunked;               // 1이면 v4 (청크별 태그 + 인덱스)
+    uint32_t chunk_size;
+} EncHeaderInfo;
+
+// 파일 처음부터 헤더 읽기 (v1~v4). 성공 1, 읽기 실패 0, 형식 오류(시그니처/버전/반복 횟수/청크 크기) -1
+static int read_enc_header(FILE* fin, EncHeaderInfo* info) {
+    memset(info, 0, sizeof(*info));
+    if (fread(&info->header, 1, sizeof(info->header), fin) != sizeof(info->header)) {
+        return 0;
+    }
+    if (memcmp(info->header.signature, ENC_SIGNATURE, 4) != 0) {
+        return -1;
+    }
+
+    if (info->header.version == ENC_VERSION) {
+        info->iterations = KDF_DEFAULT_ITERATIONS;
+        info->header_size = (long)sizeof(info->header);
+        return 1;
+    }
+    if (info->header.version != ENC_VERSION_2 && info->header.version != ENC_VERSION_3 &&
+        info->header.version != ENC_VERSION_4) {
+        return -1;
+    }
+    info->mac_ciphertext = (info->header.version != ENC_VERSION_2);
+
+    if (fread(&info->kdf, 1, sizeof(info->kdf), fin) != sizeof(info->kdf)) {
+        return 0;
+    }
+    info->has_kdf = 1;
+    info->iterations = ((uint32_t)info->kdf.iterations[0] << 24) | ((uint32_t)info->kdf.iterations[1] << 16) |
+                       ((uint32_t)info->kdf.iterations[2] << 8) | (uint32_t)info->kdf.iterations[3];
+    info->header_size = (long)(sizeof(info->header) + sizeof(info->kdf));
+    if (info->iterations < ENC_KDF_MIN_ITERATIONS || info->iterations > ENC_KDF_MAX_ITERATIONS ||
+        (info->kdf.flags & ~ENC_KDF_FLAG_SUBKEYS) != 0) {
+        return -1;
+    }
+
+    if (info->header.version == ENC_VERSION_4) {
+        if (fread(&info->chunk, 1, sizeof(info->chunk), fin) != sizeof(info->chunk)) {
+            return 0;
+        }
+        info->chunked = 1;
+        info->chunk_size = ((uint32_t)info->chunk.chunk_size[0] << 24) | ((uint32_t)info->chunk.chunk_size[1] << 16) |
+                           ((uint32_t)info->chunk.chunk_size[2] << 8) | (uint32_t)info->chunk.chunk_size[3];
+        info->header_size += (long)sizeof(info->chunk);
+        if (info->chunk_size % 16 != 0 || info->chunk_size < ENC_CHUNK_MIN_SIZE ||
+            info->chunk_size > ENC_CHUNK_MAX_SIZE) {
+            return -1;
+        }
+    }
+    return 1;
+}
+
+// 헤더에 기록된 솔트/반복 횟수로 키 도출
+// 일괄 암호화한 파일은 마스터 키가 같으므로 여러 파일을 복호화해도 PBKDF2는 캐시에서 재사용됨
+static void derive_file_keys(const char* password, const EncHeaderInfo* info, int aes_key_bits,
+                             uint8_t* aes_key, uint8_t* hmac_key) {
+    if (info->has_kdf && (info->kdf.flags & ENC_KDF_FLAG_SUBKEYS)) {
+        uint8_t master[64];
+        pbkdf2_sha512_cached((const uint8_t*)password, strlen(password),
+                             info->kdf.salt, ENC_KDF_SALT_SIZE, info->iterations, master, 64);
+        derive_subkeys(master, info->header.reserved, info->header.nonce, aes_key_bits, aes_key, hmac_key);
+        memset(master, 0, sizeof(master));
+        return;
+    }
+    derive_keys(password, info->has_kdf ? info->kdf.salt : NULL, info->has_kdf ? ENC_KDF_SALT_SIZE : 0,
+                info->iterations, aes_key_bits, aes_key, hmac_key);
+}
+
+// 청크 하나를 복호화해 plain에 쓰고 HMAC에 반영 (v1/v2는 평문, v3는 복호화 전에 암호문을 MAC)
+// in과 plain은 같은 버퍼여도 됨
+static int decrypt_chunk(const EncHeaderInfo* info, const AES_CTX* aes_ctx, uint8_t nonce_counter[16],
+                         HMAC_SHA512_CTX* hmac_ctx, const uint8_t* in, uint8_t* plain, size_t len) {
+    if (info->mac_ciphertext) {
+        hmac_sha512_update(hmac_ctx, in, len);
+    }
+    if (AES_CTR_crypt(aes_ctx, in, len, plain, nonce_counter) != CRYPTO_SUCCESS) return 0;
+    if (!info->mac_ciphertext) {
+        hmac_sha512_update(hmac_ctx, plain, len);
+    }
+    return 1;
+}
+
+static void store_be64(uint8_t out[8], uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        out[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+static uint64_t load_be64(const uint8_t in[8]) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+// v4 청크 태그 계산 시작: ctx는 hmac_key로 초기화된 컨텍스트
+// 앞의 0x00은 "AESC"(헤더)로 시작하는 최종 MAC 입력과 구분하기 위한 도메인 바이트
+static void chunk_tag_begin(HMAC_SHA512_CTX* ctx, const uint8_t nonce[8], uint64_t index) {
+    uint8_t prefix[1 + 8 + 8];
+    prefix[0] = 0x00;
+    memcpy(prefix + 1, nonce, 8);
+    store_be64(prefix + 9, index);
+    hmac_sha512_reset(ctx);
+    hmac_sha512_update(ctx, prefix, sizeof(prefix));
+}
+
+static void chunk_tag_final(HMAC_SHA512_CTX* ctx, uint8_t tag[ENC_CHUNK_TAG_SIZE]) {
+    uint8_t mac[64];
+    hmac_sha512_final(ctx, mac);
+    memcpy(tag, mac, ENC_CHUNK_TAG_SIZE);
+    memset(mac, 0, sizeof(mac));
+}
+
+// 열어 둔 v4 파일 (전체 복호화, 검증, 구간 읽기가 공유)
+typedef struct {
+    EncHeaderInfo info;
+    uint64_t plaintext_size;
+    uint64_t chunk_count;
+    uint8_t* tags;                 // chunk_count * ENC_CHUNK_TAG_SIZE, 최종 MAC으로 확인됨
+    AES_CTX aes_ctx;
+    uint8_t nonce_counter[16];     // 카운터 0 (청크 i는 i * chunk_size 바이트 위치부터)
+    HMAC_SHA512_CTX tag_ctx;       // hmac_key로 초기화, 청크마다 reset
+} EncChunkedFile;
+
+// 트레일러와 청크 인덱스를 읽어 최종 MAC을 확인하고 키를 준비 (fin은 read_enc_header 이후)
+// 성공 1, 읽기 실패/형식 오류 0, 패스워드가 틀렸거나 변조됨 -1
+static int chunked_open(FILE* fin, const EncHeaderInfo* info, const char* password, EncChunkedFile* cf) {
+    memset(cf, 0, sizeof(*cf));
+    cf->info = *info;
+    
+    int aes_key_bits;
+    if (info->header.key_length_code == 0x01) aes_key_bits = 128;
+    else if (info->header.key_length_code == 0x02) aes_key_bits = 192;
+    else if (info->header.key_length_code == 0x03) aes_key_bits = 256;
+    else return 0;
+    
+    // 트레일러 읽기. 변조된 크기로 큰 할당을 하지 않도록 파일 크기와 먼저 맞춰 봄
+    if (platform_fseek64(fin, 0, SEEK_END) != 0) return 0;
+    int64_t trailer_pos = platform_ftell64(fin) - (int64_t)sizeof(EncChunkTrailer);
+    if (trailer_pos < info->header_size) return 0;
+    EncChunkTrailer trailer;
+    if (platform_fseek64(fin, trailer_pos, SEEK_SET) != 0 ||
+        fread(&trailer, 1, sizeof(trailer), fin) != sizeof(trailer)) {
+        return 0;
+    }
+    cf->plaintext_size = load_be64(trailer.plaintext_size);
+    cf->chunk_count = load_be64(trailer.chunk_count);
+    uint64_t body_size = (uint64_t)(trailer_pos - info->header_size);
+    if (cf->plaintext_size > body_size ||
+        cf->chunk_count != (cf->plaintext_size + info->chunk_size - 1) / info->chunk_size ||
+        cf->chunk_count > body_size / ENC_CHUNK_TAG_SIZE ||
+        cf->plaintext_size + cf->chunk_count * ENC_CHUNK_TAG_SIZE != body_size ||
+        cf->chunk_count * ENC_CHUNK_TAG_SIZE > (uint64_t)SIZE_MAX) {
+        return 0;
+    }
+    
+    size_t tags_len = (size_t)(cf->chunk_count * ENC_CHUNK_TAG_SIZE);
+    cf->tags = (uint8_t*)malloc(tags_len > 0 ? tags_len : 1);
+    if (!cf->tags) return 0;
+    if (platform_fseek64(fin, info->header_size + (int64_t)cf->plaintext_size, SEEK_SET) != 0 ||
+        fread(cf->tags, 1, tags_len, fin) != tags_len) {
+        free(cf->tags);
+        cf->tags = NULL;
+        return 0;
+    }
+    
+    uint8_t aes_key[32];
+    uint8_t hmac_key[24];
+    derive_file_keys(password, info, aes_key_bits, aes_key, hmac_key);
+    
+    // 최종 MAC 확인 (패스워드가 틀리면 여기서 걸러지므로 청크를 하나도 읽지 않음)
+    uint8_t computed_mac[64];
+    hmac_sha512_init(&cf->tag_ctx, hmac_key, 24);
+    hmac_sha512_update(&cf->tag_ctx, (uint8_t*)&info->header, sizeof(info->header));
+    hmac_sha512_update(&cf->tag_ctx, (uint8_t*)&info->kdf, sizeof(info->kdf));
+    hmac_sha512_update(&cf->tag_ctx, (uint8_t*)&info->chunk, sizeof(info->chunk));
+    hmac_sha512_update(&cf->tag_ctx, cf->tags, tags_len);
+    hmac_sha512_update(&cf->tag_ctx, trailer.plaintext_size, 16);  // plaintext_size || chunk_count
+    hmac_sha512_final(&cf->tag_ctx, computed_mac);
+    memset(hmac_key, 0, sizeof(hmac_key));
+    if (memcmp(computed_mac, trailer.mac, ENC_HMAC_SIZE) != 0) {
+        memset(aes_key, 0, sizeof(aes_key));
+        hmac_sha512_wipe(&cf->tag_ctx);
+        free(cf->tags);
+        cf->tags = NULL;
+        return -1;
+    }
+    
+    int ok = (AES_set_key(&cf->aes_ctx, aes_key, aes_key_bits) == CRYPTO_SUCCESS);
+    memset(aes_key, 0, sizeof(aes_key));
+    if (!ok) {
+        hmac_sha512_wipe(&cf->tag_ctx);
+        free(cf->tags);
+        cf->tags = NULL;
+        return 0;
+    }
+    memcpy(cf->nonce_counter, info->header.nonce, 8);
+    memset(cf->nonce_counter + 8, 0, 8);
+    return 1;
+}
+
+static void chunked_close(EncChunkedFile* cf) {
+    free(cf->tags);
+    hmac_sha512_wipe(&cf->tag_ctx);
+    memset(cf, 0, sizeof(*cf));
+}
+
+// 청크 index의 평문(=암호문) 길이
+static size_t chunked_chunk_len(const EncChunkedFile* cf, uint64_t index) {
+    uint64_t start = index * cf->info.chunk_size;
+    uint64_t left = cf->plaintext_size - start;
+    return (size_t)(left < cf->info.chunk_size ? left : cf->info.chunk_size);
+}
+
+// 청크 index의 암호문을 buf(chunk_size 이상)에 읽고 태그 확인. 성공하면 암호문 길이, 실패하면 0
+static size_t chunked_read_chunk(EncChunkedFile* cf, FILE* fin, uint64_t index, uint8_t* buf) {
+    size_t len = chunked_chunk_len(cf, index);
+    int64_t pos = cf->info.header_size + (int64_t)(index * cf->info.chunk_size);
+    if (platform_fseek64(fin, pos, SEEK_SET) != 0 || fread(buf, 1, len, fin) != len) {
+        return 0;
+    }
+    uint8_t tag[ENC_CHUNK_TAG_SIZE];
+    chunk_tag_begin(&cf->tag_ctx, cf->info.header.nonce, index);
+    hmac_sha512_update(&cf->tag_ctx, buf, len);
+    chunk_tag_final(&cf->tag_ctx, tag);
+    if (memcmp(tag, cf->tags + index * ENC_CHUNK_TAG_SIZE, ENC_CHUNK_TAG_SIZE) != 0) {
+        return 0;
+    }
+    return len;
+}
+
 // 진행률 표시 함수
-static void print_progress(long processed, long total, const char* operation) {
+static void print_progress(int64_t processed, int64_t total, const char* operation) {
     if (total <= 0) return;
     
     double percent = (double)processed / total * 100.0;
@@ -128,10 +509,377 @@ static void print_progress(long processed, long total, const char* operation) {
             printf(" ");
         }
     }
-    printf("] %.1f%% (%ld / %ld bytes)", percent, processed, total);
+    printf("] %.1f%% (%lld / %lld bytes)", percent, (long long)processed, (long long)total);
     fflush(stdout);
 }
 
+// 콜백 호출. 크기는 내부에서 64비트로 다루고, long(Windows는 32비트)을 넘으면 천분율로 바꿔 넘김
+static void notify_progress(progress_callback_t progress_cb, void* user_data, int64_t processed, int64_t total) {
+    if (total > LONG_MAX) {
+        processed = (int64_t)((uint64_t)processed * 1000 / (uint64_t)total);
+        total = 1000;
+    }
+    progress_cb((long)processed, (long)total, user_data);
+}
+
+// 진행률 보고: 콜백이 있으면 콜백, 없으면 operation이 있을 때 1% 단위로 print_progress
+static void report_progress(progress_callback_t progress_cb, void* user_data, const char* operation,
+                            int64_t processed, int64_t total, long* last_percent) {
+    if (progress_cb) {
+        notify_progress(progress_cb, user_data, processed, total);
+    } else if (operation && total > 0) {
+        long current_percent = (long)((uint64_t)processed * 100 / (uint64_t)total);
+        if (current_percent != *last_percent) {
+            print_progress(processed, total, operation);
+            *last_percent = current_percent;
+        }
+    }
+}
+
+// v4 청크 엔진: 작업 스레드들이 청크 번호를 하나씩 가져가 읽기 -> 암호화/MAC -> 제자리 쓰기를 반복
+// 청크는 서로 독립적으로 인증되므로 처리 순서와 관계없이 결과가 같고, 쓰기는 위치 지정(pwrite)이라 순서를 맞출 필요가 없음
+// 메모리는 스레드마다 청크 하나 (스레드 수 × chunk_size)로 제한됨
+typedef enum {
+    CHUNK_JOB_ENCRYPT,         // 평문 청크 -> 암호문 + 태그 채우기
+    CHUNK_JOB_DECRYPT,         // 태그 확인 후 복호화
+    CHUNK_JOB_VERIFY           // 태그만 확인 (출력 없음)
+} ChunkJobMode;
+
+typedef struct {
+    ChunkJobMode mode;
+    FILE* fin;
+    FILE* fout;                // CHUNK_JOB_VERIFY는 NULL
+    int64_t in_base;           // 청크 0의 입력 파일 위치
+    int64_t out_base;          // 청크 0의 출력 파일 위치
+    const AES_CTX* aes_ctx;
+    const uint8_t* nonce_counter;       // 카운터 0 (앞 8바이트가 nonce)
+    const HMAC_SHA512_CTX* tag_key;     // hmac_key로 초기화된 컨텍스트 (스레드마다 복사해서 사용)
+    uint32_t chunk_size;
+    uint64_t data_size;
+    uint64_t chunk_count;
+    uint8_t* tags;             // ENCRYPT는 채우고, 그 외에는 기대값
+    int serial_aes;            // 여러 스레드로 돌 때는 AES를 다시 나누지 않음
+    
+    platform_mutex lock;       // 아래 필드 보호 (chunk_engine_run 동안만 초기화되어 있음)
+    uint64_t next_chunk;
+    uint64_t done_bytes;
+    int failed;
+} ChunkEngine;
+
+static void chunk_engine_init(ChunkEngine* e, ChunkJobMode mode, FILE* fin, int64_t in_base,
+                              FILE* fout, int64_t out_base, const AES_CTX* aes_ctx,
+                              const uint8_t nonce_counter[16], const HMAC_SHA512_CTX* tag_key,
+                              uint32_t chunk_size, uint64_t data_size, uint8_t* tags) {
+    memset(e, 0, sizeof(*e));
+    e->mode = mode;
+    e->fin = fin;
+    e->fout = fout;
+    e->in_base = in_base;
+    e->out_base = out_base;
+    e->aes_ctx = aes_ctx;
+    e->nonce_counter = nonce_counter;
+    e->tag_key = tag_key;
+    e->chunk_size = chunk_size;
+    e->data_size = data_size;
+    e->chunk_count = (data_size + chunk_size - 1) / chunk_size;
+    e->tags = tags;
+}
+
+// 청크 하나 처리 (buf는 chunk_size 이상). 성공 1
+static int chunk_engine_process(ChunkEngine* e, HMAC_SHA512_CTX* tag_ctx, uint64_t index, uint8_t* buf) {
+    uint64_t pos = index * e->chunk_size;
+    size_t len = (size_t)((e->data_size - pos < e->chunk_size) ? e->data_size - pos : e->chunk_size);
+    if (platform_pread(e->fin, buf, len, e->in_base + (int64_t)pos) != (int64_t)len) {
+        return 0;
+    }
+    
+    uint8_t* expected = e->tags + index * ENC_CHUNK_TAG_SIZE;
+    uint8_t tag[ENC_CHUNK_TAG_SIZE];
+    CRYPTO_STATUS (*crypt_at)(const AES_CTX*, const uint8_t*, uint64_t, const uint8_t*, size_t, uint8_t*) =
+        e->serial_aes ? AES_CTR_crypt_at_serial : AES_CTR_crypt_at;
+    if (e->mode == CHUNK_JOB_ENCRYPT) {
+        if (crypt_at(e->aes_ctx, e->nonce_counter, pos, buf, len, buf) != CRYPTO_SUCCESS) return 0;
+        chunk_tag_begin(tag_ctx, e->nonce_counter, index);
+        hmac_sha512_update(tag_ctx, buf, len);
+        chunk_tag_final(tag_ctx, expected);
+    } else {
+        // 태그가 맞을 때만 복호화 (검증되지 않은 평문을 쓰지 않음)
+        chunk_tag_begin(tag_ctx, e->nonce_counter, index);
+        hmac_sha512_update(tag_ctx, buf, len);
+        chunk_tag_final(tag_ctx, tag);
+        if (memcmp(tag, expected, ENC_CHUNK_TAG_SIZE) != 0) return 0;
+        if (e->mode == CHUNK_JOB_DECRYPT &&
+            crypt_at(e->aes_ctx, e->nonce_counter, pos, buf, len, buf) != CRYPTO_SUCCESS) {
+            return 0;
+        }
+    }
+    
+    if (e->fout && platform_pwrite(e->fout, buf, len, e->out_base + (int64_t)pos) != (int64_t)len) {
+        return 0;
+    }
+    return 1;
+}
+
+// 작업 루프. 호출한 스레드(progress_cb/operation을 넘김)만 진행률을 표시
+static void chunk_engine_loop(ChunkEngine* e, progress_callback_t progress_cb, void* user_data,
+                              const char* operation) {
+    uint8_t* buf = (uint8_t*)malloc(e->chunk_size);
+    HMAC_SHA512_CTX tag_ctx;
+    hmac_sha512_clone(&tag_ctx, e->tag_key);
+    long last_percent = -1;
+    
+    for (;;) {
+        platform_mutex_lock(&e->lock);
+        if (!buf) e->failed = 1;
+        if (e->failed || e->next_chunk >= e->chunk_count) {
+            platform_mutex_unlock(&e->lock);
+            break;
+        }
+        uint64_t index = e->next_chunk++;
+        platform_mutex_unlock(&e->lock);
+        
+        int ok = chunk_engine_process(e, &tag_ctx, index, buf);
+        
+        platform_mutex_lock(&e->lock);
+        if (!ok) e->failed = 1;
+        else e->done_bytes += (index + 1 < e->chunk_count) ? e->chunk_size : e->data_size - index * e->chunk_size;
+        uint64_t done = e->done_bytes;
+        platform_mutex_unlock(&e->lock);
+        
+        report_progress(progress_cb, user_data, operation, (int64_t)done, (int64_t)e->data_size, &last_percent);
+    }
+    
+    if (buf) {
+        memset(buf, 0, e->chunk_size);
+        free(buf);
+    }
+    hmac_sha512_wipe(&tag_ctx);
+}
+
+static void chunk_engine_worker(void* arg) {
+    chunk_engine_loop((ChunkEngine*)arg, NULL, NULL, NULL);
+}
+
+// 모든 청크 처리. 호출한 스레드도 작업하며, 스레드를 만들지 못하면 남은 스레드가 나머지를 가져감
+static int chunk_engine_run(ChunkEngine* e, progress_callback_t progress_cb, void* user_data,
+                            const char* operation) {
+    int workers = file_crypto_worker_count();
+    if ((uint64_t)workers > ENC_ENGINE_MAX_INFLIGHT / e->chunk_size) workers = (int)(ENC_ENGINE_MAX_INFLIGHT / e->chunk_size);
+    if ((uint64_t)workers > e->chunk_count) workers = (int)e->chunk_count;
+    if (workers < 1) workers = 1;
+    e->serial_aes = (workers > 1);
+    platform_mutex_init(&e->lock);
+    
+    platform_thread threads[ENC_ENGINE_MAX_WORKERS];
+    int started[ENC_ENGINE_MAX_WORKERS];
+    for (int i = 1; i < workers; i++) started[i] = platform_thread_start(&threads[i], chunk_engine_worker, e);
+    chunk_engine_loop(e, progress_cb, user_data, operation);
+    for (int i = 1; i < workers; i++) {
+        if (started[i]) platform_thread_join(&threads[i]);
+    }
+    platform_mutex_destroy(&e->lock);
+    return !e->failed && e->done_bytes == e->data_size;
+}
+
+// v1/v2/v3 복호화 파이프라인
+// 작업 동안 유지되는 스레드들이 재사용 버퍼 링을 돌려 씀:
+//   읽기 스레드: 빈 슬롯에 암호문을 순서대로 읽음 (v3는 읽은 암호문을 여기서 순서대로 HMAC에 넣음)
+//   복호화 스레드 N개: 읽힌 슬롯을 하나씩 가져가 평문 위치의 카운터로 CTR 복호화
+//   호출한 스레드: 복호화된 슬롯을 순서대로 출력에 쓰고 (v1/v2는 평문을 HMAC에 넣음) 슬롯을 비움 (진행률도 여기서 보고)
+// 슬롯 상태는 mutex로 보호하고, 바뀔 때마다 condvar를 broadcast해 기다리는 단계를 깨움
+// CTR 키스트림은 위치만으로 정해지고 순서가 필요한 것은 HMAC뿐이므로, 전체 속도는 SHA-512에 맞춰짐
+typedef enum {
+    PIPE_SLOT_EMPTY,           // 읽기 스레드가 채울 수 있음
+    PIPE_SLOT_READ,            // 암호문, 복호화 대기
+    PIPE_SLOT_DECRYPTING,
+    PIPE_SLOT_PLAIN            // 평문, HMAC/쓰기 대기
+} PipeSlotState;
+
+typedef struct {
+    uint8_t* data;             // FILE_CHUNK_SIZE
+    size_t len;
+    uint64_t offset;           // 평문에서의 위치
+    PipeSlotState state;
+} PipeSlot;
+
+typedef struct {
+    FILE* fin;
+    const AES_CTX* aes_ctx;
+    const uint8_t* nonce_counter;   // 위치 0의 카운터
+    int64_t ciphertext_size;
+    HMAC_SHA512_CTX* hmac_ctx;
+    int mac_ciphertext;        // 1이면 읽기 스레드가 암호문을, 0이면 호출한 스레드가 평문을 HMAC에 넣음
+    PipeSlot* slots;
+    int slot_count;
+    
+    platform_mutex lock;       // 슬롯 상태와 아래 필드 보호
+    platform_cond changed;     // 위 상태가 바뀌면 broadcast
+    uint64_t read_seq;         // 읽기 스레드가 다음에 채울 순번 (슬롯 = 순번 % slot_count)
+    uint64_t decrypt_seq;      // 복호화 스레드가 다음에 가져갈 순번 (read_seq 이하)
+    uint64_t end_seq;          // 읽기가 끝나면 전체 순번 수, 그 전에는 UINT64_MAX
+    int stop;                  // 실패 또는 종료: 모든 단계가 기다리지 않고 끝냄
+} DecryptPipe;
+
+static void decrypt_pipe_reader(void* arg) {
+    DecryptPipe* p = (DecryptPipe*)arg;
+    int64_t pos = 0;
+    for (uint64_t seq = 0; ; seq++) {
+        PipeSlot* slot = &p->slots[seq % (uint64_t)p->slot_count];
+        size_t want = (p->ciphertext_size - pos < FILE_CHUNK_SIZE) ?
+                      (size_t)(p->ciphertext_size - pos) : FILE_CHUNK_SIZE;
+        platform_mutex_lock(&p->lock);
+        while (!p->stop && want > 0 && slot->state != PIPE_SLOT_EMPTY) {
+            platform_cond_wait(&p->changed, &p->lock);
+        }
+        if (p->stop || want == 0) {
+            if (want == 0) p->end_seq = seq;
+            platform_cond_broadcast(&p->changed);
+            platform_mutex_unlock(&p->lock);
+            return;
+        }
+        platform_mutex_unlock(&p->lock);
+        
+        // 빈 슬롯은 읽기 스레드만 건드리므로 잠그지 않고 읽음
+        size_t got = fread(slot->data, 1, want, p->fin);
+        if (got == want && p->mac_ciphertext) {
+            hmac_sha512_update(p->hmac_ctx, slot->data, got);
+        }
+        
+        platform_mutex_lock(&p->lock);
+        if (got != want) {
+            p->stop = 1;
+        } else {
+            slot->len = got;
+            slot->offset = (uint64_t)pos;
+            slot->state = PIPE_SLOT_READ;
+            p->read_seq = seq + 1;
+        }
+        platform_cond_broadcast(&p->changed);
+        platform_mutex_unlock(&p->lock);
+        pos += (int64_t)want;
+    }
+}
+
+static void decrypt_pipe_worker(void* arg) {
+    DecryptPipe* p = (DecryptPipe*)arg;
+    platform_mutex_lock(&p->lock);
+    for (;;) {
+        while (!p->stop && p->decrypt_seq == p->read_seq && p->decrypt_seq != p->end_seq) {
+            platform_cond_wait(&p->changed, &p->lock);
+        }
+        if (p->stop || p->decrypt_seq == p->end_seq) break;
+        PipeSlot* slot = &p->slots[p->decrypt_seq++ % (uint64_t)p->slot_count];
+        slot->state = PIPE_SLOT_DECRYPTING;
+        platform_mutex_unlock(&p->lock);
+        
+        int ok = AES_CTR_crypt_at_serial(p->aes_ctx, p->nonce_counter, slot->offset,
+                                         slot->data, slot->len, slot->data) == CRYPTO_SUCCESS;
+        
+        platform_mutex_lock(&p->lock);
+        if (!ok) p->stop = 1;
+        else slot->state = PIPE_SLOT_PLAIN;
+        platform_cond_broadcast(&p->changed);
+    }
+    platform_mutex_unlock(&p->lock);
+}
+
+// fin의 현재 위치부터 ciphertext_size 바이트를 복호화해 fout(NULL 가능)에 쓰고
+// hmac_ctx에 평문(mac_ciphertext가 1이면 암호문)을 반영
+// nonce_counter는 위치 0의 카운터이며 바뀌지 않음. 처리한 바이트 수를 total_out에 기록 (성공 1, 실패 0)
+// 스레드를 만들지 못하면 아무것도 읽지 않고 total_out = 0으로 성공을 반환하므로 호출한 쪽이 순서대로 처리
+static int decrypt_mac_pipelined(FILE* fin, FILE* fout, int64_t ciphertext_size, const AES_CTX* aes_ctx,
+                                 const uint8_t nonce_counter[16], HMAC_SHA512_CTX* hmac_ctx, int mac_ciphertext,
+                                 progress_callback_t progress_cb, void* user_data,
+                                 const char* operation, int64_t* total_out) {
+    // 복호화 스레드는 읽기/HMAC 단계 몫을 뺀 수, 슬롯은 스레드마다 하나 + 읽는 중/대기/HMAC 중 몫
+    int workers = file_crypto_worker_count() - 1;
+    if (workers < 1) workers = 1;
+    int slot_count = workers + 3;
+    
+    DecryptPipe p;
+    memset(&p, 0, sizeof(p));
+    p.fin = fin;
+    p.aes_ctx = aes_ctx;
+    p.nonce_counter = nonce_counter;
+    p.ciphertext_size = ciphertext_size;
+    p.hmac_ctx = hmac_ctx;
+    p.mac_ciphertext = mac_ciphertext;
+    p.slot_count = slot_count;
+    p.end_seq = UINT64_MAX;
+    *total_out = 0;
+    
+    PipeSlot slots[ENC_ENGINE_MAX_WORKERS + 3];
+    uint8_t* ring = (uint8_t*)malloc((size_t)slot_count * FILE_CHUNK_SIZE);
+    if (!ring) return 0;
+    for (int i = 0; i < slot_count; i++) {
+        slots[i].data = ring + (size_t)i * FILE_CHUNK_SIZE;
+        slots[i].len = 0;
+        slots[i].offset = 0;
+        slots[i].state = PIPE_SLOT_EMPTY;
+    }
+    p.slots = slots;
+    platform_mutex_init(&p.lock);
+    platform_cond_init(&p.changed);
+    
+    // 복호화 스레드를 먼저 띄우고 하나라도 있을 때만 읽기 시작 (읽기 전에 멈추면 호출한 쪽이 처음부터 처리)
+    platform_thread threads[ENC_ENGINE_MAX_WORKERS];
+    int started[ENC_ENGINE_MAX_WORKERS];
+    int running = 0;
+    for (int i = 0; i < workers; i++) {
+        started[i] = platform_thread_start(&threads[i], decrypt_pipe_worker, &p);
+        running += started[i];
+    }
+    platform_thread reader;
+    int reader_started = running > 0 && platform_thread_start(&reader, decrypt_pipe_reader, &p);
+    
+    // 쓰기 단계 (v1/v2는 평문 HMAC 포함): 순번 순서대로 처리
+    int success = 0;
+    if (reader_started) {
+        int64_t written = 0;
+        long last_percent = -1;
+        uint64_t write_seq = 0;
+        platform_mutex_lock(&p.lock);
+        for (;;) {
+            PipeSlot* slot = &slots[write_seq % (uint64_t)slot_count];
+            while (!p.stop && write_seq != p.end_seq && slot->state != PIPE_SLOT_PLAIN) {
+                platform_cond_wait(&p.changed, &p.lock);
+            }
+            if (p.stop || write_seq == p.end_seq) break;
+            platform_mutex_unlock(&p.lock);
+            
+            if (!mac_ciphertext) hmac_sha512_update(hmac_ctx, slot->data, slot->len);
+            int ok = !fout || fwrite(slot->data, 1, slot->len, fout) == slot->len;
+            written += (int64_t)slot->len;
+            report_progress(progress_cb, user_data, operation, written, ciphertext_size, &last_percent);
+            
+            platform_mutex_lock(&p.lock);
+            if (!ok) p.stop = 1;
+            slot->state = PIPE_SLOT_EMPTY;
+            write_seq++;
+            platform_cond_broadcast(&p.changed);
+        }
+        success = !p.stop;
+        platform_mutex_unlock(&p.lock);
+        *total_out = written;
+    }
+    
+    // 남은 스레드 종료
+    platform_mutex_lock(&p.lock);
+    p.stop = 1;
+    platform_cond_broadcast(&p.changed);
+    platform_mutex_unlock(&p.lock);
+    if (reader_started) platform_thread_join(&reader);
+    for (int i = 0; i < workers; i++) {
+        if (started[i]) platform_thread_join(&threads[i]);
+    }
+    platform_cond_destroy(&p.changed);
+    platform_mutex_destroy(&p.lock);
+    
+    memset(ring, 0, (size_t)slot_count * FILE_CHUNK_SIZE);
+    free(ring);
+    return reader_started ? success : 1;
+}
+
 // 내부 구현 함수 (콜백 지원)
 static int encrypt_file_internal(const char* input_path, const char* output_path,
                                  int aes_key_bits, const char* password,
@@ -143,9 +891,9 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
     }
     
     // 파일 크기 확인
-    fseek(fin, 0, SEEK_END);
-    long file_size = ftell(fin);
-    fseek(fin, 0, SEEK_SET);
+    platform_fseek64(fin, 0, SEEK_END);
+    int64_t file_size = platform_ftell64(fin);
+    platform_fseek64(fin, 0, SEEK_SET);
     
     if (file_size < 0) {
         fclose(fin);
@@ -154,10 +902,46 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
     
     if (!progress_cb) printf("Encrypting...\n");
     
-    // 키 도출
+    // 청크 크기 (0이면 v3 단일 스트림)
+    uint32_t chunk_size = (uint32_t)g_encrypt_chunk_size;
+    
+    // Nonce 생성 (안전한 난수를 얻지 못하면 중단)
+    uint8_t nonce[8];
+    if (!generate_nonce(nonce, 8)) {
+        fclose(fin);
+        if (!progress_cb) printf("Error: Secure random number generator is not available.\n");
+        return 0;
+    }
+    
+    // 키 도출 파라미터 (v2 헤더에 기록)
+    // 일괄 암호화 세션이면 세션의 마스터 키에서 파일별 하위 키를, 아니면 파일별 랜덤 솔트로 PBKDF2
+    EncKdfParams kdf;
+    memset(&kdf, 0, sizeof(kdf));
+    uint8_t file_salt[16] = {0};
+    uint8_t master[64];
+    uint32_t iterations;
     uint8_t aes_key[32];
     uint8_t hmac_key[24];
-    derive_keys(password, aes_key_bits, aes_key, hmac_key);
+    int salt_ok;
+    if (batch_session_get(password, master, kdf.salt, &iterations)) {
+        kdf.flags = ENC_KDF_FLAG_SUBKEYS;
+        salt_ok = generate_nonce(file_salt, sizeof(file_salt));
+        if (salt_ok) derive_subkeys(master, file_salt, nonce, aes_key_bits, aes_key, hmac_key);
+        memset(master, 0, sizeof(master));
+    } else {
+        iterations = g_encrypt_kdf_iterations;
+        salt_ok = generate_nonce(kdf.salt, ENC_KDF_SALT_SIZE);
+        if (salt_ok) derive_keys(password, kdf.salt, ENC_KDF_SALT_SIZE, iterations, aes_key_bits, aes_key, hmac_key);
+    }
+    if (!salt_ok) {
+        fclose(fin);
+        if (!progress_cb) printf("Error: Secure random number generator is not available.\n");
+        return 0;
+    }
+    kdf.iterations[0] = (uint8_t)(iterations >> 24);
+    kdf.iterations[1] = (uint8_t)(iterations >> 16);
+    kdf.iterations[2] = (uint8_t)(iterations >> 8);
+    kdf.iterations[3] = (uint8_t)iterations;
     
     // AES 컨텍스트 설정
     AES_CTX aes_ctx;
@@ -166,10 +950,6 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
         return 0;
     }
     
-    // Nonce 생성
-    uint8_t nonce[8];
-    generate_nonce(nonce, 8);
-    
     // CTR 모드용 nonce_counter (8바이트 nonce + 8바이트 카운터)
     uint8_t nonce_counter[16];
     memcpy(nonce_counter, nonce, 8);
@@ -184,7 +964,7 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
     // 헤더 작성
     EncFileHeader header;
     memcpy(header.signature, ENC_SIGNATURE, 4);
-    header.version = ENC_VERSION;
+    header.version = chunk_size ? ENC_VERSION_4 : ENC_VERSION_3;
     header.key_length_code = (aes_key_bits == 128) ? 0x01 : 
                              (aes_key_bits == 192) ? 0x02 : 0x03;
     header.mode_code = ENC_MODE_CTR;
@@ -195,12 +975,27 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
     if (ext_len > 0) {
         memcpy(header.format, original_ext, ext_len);
     }
-    memset(header.reserved, 0, 16);
-    
-    // HMAC 초기화 (헤더 + 원본 파일로 생성)
+    memcpy(header.reserved, file_salt, 16);  // 일괄 암호화: 파일별 HKDF 솔트, 그 외: 0
+    
+    // v4 청크 파라미터
+    EncChunkParams chunk_params;
+    memset(&chunk_params, 0, sizeof(chunk_params));
+    chunk_params.chunk_size[0] = (uint8_t)(chunk_size >> 24);
+    chunk_params.chunk_size[1] = (uint8_t)(chunk_size >> 16);
+    chunk_params.chunk_size[2] = (uint8_t)(chunk_size >> 8);
+    chunk_params.chunk_size[3] = (uint8_t)chunk_size;
+    
+    // HMAC 초기화 (헤더 + 암호문으로 생성, Encrypt-then-MAC)
+    // v4는 암호문 대신 청크 태그들을 최종 MAC에 넣고, 청크 태그는 tag_ctx로 따로 계산
     HMAC_SHA512_CTX hmac_ctx;
+    HMAC_SHA512_CTX tag_ctx;
     hmac_sha512_init(&hmac_ctx, hmac_key, 24);
     hmac_sha512_update(&hmac_ctx, (uint8_t*)&header, sizeof(header));  // 헤더를 HMAC에 포함
+    hmac_sha512_update(&hmac_ctx, (uint8_t*)&kdf, sizeof(kdf));        // 키 도출 파라미터도 포함
+    if (chunk_size) {
+        hmac_sha512_update(&hmac_ctx, (uint8_t*)&chunk_params, sizeof(chunk_params));
+        hmac_sha512_init(&tag_ctx, hmac_key, 24);
+    }
     
     // 출력 파일 작성
     FILE* fout = platform_fopen(output_path, "wb");
@@ -209,65 +1004,88 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
         return 0;
     }
     
-    // 헤더 쓰기
+    // 헤더 + 키 도출 파라미터 쓰기
     fwrite(&header, 1, sizeof(header), fout);
+    fwrite(&kdf, 1, sizeof(kdf), fout);
     
-    // HMAC을 위한 임시 공간 (나중에 쓸 예정)
-    long hmac_position = ftell(fout);
-    uint8_t hmac_placeholder[64] = {0};
-    fwrite(hmac_placeholder, 1, 64, fout);  // 나중에 채울 공간
+    // HMAC을 위한 임시 공간 (나중에 쓸 예정). v4는 청크 파라미터 다음에 바로 암호문
+    int64_t hmac_position = platform_ftell64(fout);
+    if (chunk_size) {
+        fwrite(&chunk_params, 1, sizeof(chunk_params), fout);
+    } else {
+        uint8_t hmac_placeholder[64] = {0};
+        fwrite(hmac_placeholder, 1, 64, fout);  // 나중에 채울 공간
+    }
     
-    // 파일을 한 번만 읽으면서 HMAC 계산과 암호화 동시 수행
-    uint8_t buffer[FILE_CHUNK_SIZE];
-    size_t bytes_read;
-    long total_processed = 0;
     int success = 1;
-    
-    // 파일 위치를 처음으로
-    fseek(fin, 0, SEEK_SET);
-    
-    while ((bytes_read = fread(buffer, 1, FILE_CHUNK_SIZE, fin)) > 0) {
-        // HMAC 업데이트 (평문에 대해 - 암호화 전)
-        hmac_sha512_update(&hmac_ctx, buffer, bytes_read);
+    if (chunk_size) {
+        // v4: 청크 엔진이 여러 스레드로 청크를 암호화해 제자리에 쓰고 태그 목록을 채움
+        uint64_t chunk_count = ((uint64_t)file_size + chunk_size - 1) / chunk_size;
+        size_t tags_len = (size_t)(chunk_count * ENC_CHUNK_TAG_SIZE);
+        uint8_t* tags = (uint8_t*)malloc(tags_len > 0 ? tags_len : 1);
+        int64_t data_pos = hmac_position + (int64_t)sizeof(chunk_params);
+        ChunkEngine engine;
+        chunk_engine_init(&engine, CHUNK_JOB_ENCRYPT, fin, 0, fout, data_pos, &aes_ctx, nonce_counter,
+                          &tag_ctx, chunk_size, (uint64_t)file_size, tags);
+        success = tags && fflush(fout) == 0 &&
+                  chunk_engine_run(&engine, progress_cb, user_data, progress_cb ? NULL : "Encrypting");
         
-        // 동시에 암호화 (in-place)
-        if (AES_CTR_crypt(&aes_ctx, buffer, bytes_read, buffer, nonce_counter) != CRYPTO_SUCCESS) {
-            success = 0;
-            break;
+        // 암호문 뒤에 청크 인덱스 + 트레일러 쓰기
+        if (success) {
+            EncChunkTrailer trailer;
+            store_be64(trailer.plaintext_size, (uint64_t)file_size);
+            store_be64(trailer.chunk_count, chunk_count);
+            hmac_sha512_update(&hmac_ctx, tags, tags_len);
+            hmac_sha512_update(&hmac_ctx, trailer.plaintext_size, 16);  // plaintext_size || chunk_count
+            hmac_sha512_final(&hmac_ctx, trailer.mac);
+            success = platform_fseek64(fout, data_pos + file_size, SEEK_SET) == 0 &&
+                      fwrite(tags, 1, tags_len, fout) == tags_len &&
+                      fwrite(&trailer, 1, sizeof(trailer), fout) == sizeof(trailer);
         }
+        free(tags);
+        hmac_sha512_wipe(&tag_ctx);
+    } else {
+        // 파일을 한 번만 읽으면서 암호화와 HMAC 계산 동시 수행
+        uint8_t buffer[FILE_CHUNK_SIZE];
+        size_t bytes_read;
+        int64_t total_processed = 0;
+        long last_percent = -1;
         
-        // 암호문 쓰기
-        if (fwrite(buffer, 1, bytes_read, fout) != bytes_read) {
-            success = 0;
-            break;
-        }
+        // 파일 위치를 처음으로
+        platform_fseek64(fin, 0, SEEK_SET);
         
-        // 진행률 업데이트 - 콜백이 있으면 콜백, 없으면 print_progress
-        total_processed += bytes_read;
-        if (progress_cb) {
-            progress_cb(total_processed, file_size, user_data);
-        } else {
-            // 진행률 출력을 1% 단위로만 (성능 최적화)
-            static long last_percent = -1;
-            long current_percent = (total_processed * 100) / file_size;
-            if (current_percent != last_percent) {
-                print_progress(total_processed, file_size, "Encrypting");
-                last_percent = current_percent;
+        while ((bytes_read = fread(buffer, 1, FILE_CHUNK_SIZE, fin)) > 0) {
+            // 암호화 (in-place)
+            if (AES_CTR_crypt(&aes_ctx, buffer, bytes_read, buffer, nonce_counter) != CRYPTO_SUCCESS) {
+                success = 0;
+                break;
             }
+            
+            // HMAC 업데이트 (암호문에 대해)
+            hmac_sha512_update(&hmac_ctx, buffer, bytes_read);
+            
+            // 암호문 쓰기
+            if (fwrite(buffer, 1, bytes_read, fout) != bytes_read) {
+                success = 0;
+                break;
+            }
+            
+            // 진행률 업데이트 - 콜백이 있으면 콜백, 없으면 1% 단위로 print_progress
+            total_processed += bytes_read;
+            report_progress(progress_cb, user_data, "Encrypting", total_processed, file_size, &last_percent);
+        }
+        
+        // HMAC 최종 계산 후 올바른 위치에 쓰기
+        if (success) {
+            uint8_t hmac[64];
+            hmac_sha512_final(&hmac_ctx, hmac);
+            int64_t current_pos = platform_ftell64(fout);
+            platform_fseek64(fout, hmac_position, SEEK_SET);
+            fwrite(hmac, 1, 64, fout);
+            platform_fseek64(fout, current_pos, SEEK_SET);  // 원래 위치로 복귀
         }
     }
-    
-    // HMAC 최종 계산
-    uint8_t hmac[64];
-    hmac_sha512_final(&hmac_ctx, hmac);
-    
-    // HMAC을 올바른 위치에 쓰기
-    if (success) {
-        long current_pos = ftell(fout);
-        fseek(fout, hmac_position, SEEK_SET);
-        fwrite(hmac, 1, 64, fout);
-        fseek(fout, current_pos, SEEK_SET);  // 원래 위치로 복귀
-    }
+    hmac_sha512_wipe(&hmac_ctx);
     
     fclose(fin);
     
@@ -280,7 +1098,7 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
     
     // 진행률 완료 표시
     if (progress_cb) {
-        progress_cb(file_size, file_size, user_data);
+        notify_progress(progress_cb, user_data, file_size, file_size);
     } else {
         print_progress(file_size, file_size, "Encrypting");
         printf("\nEncryption completed!\n");
@@ -309,196 +1127,218 @@ int read_aes_key_length(const char* input_path) {
         return 0;
     }
     
-    EncFileHeader header;
-    if (fread(&header, 1, sizeof(header), fin) != sizeof(header)) {
-        fclose(fin);
-        return 0;
-    }
-    
+    // 헤더 읽기 및 시그니처/버전 검증
+    EncHeaderInfo info;
+    int ok = read_enc_header(fin, &info);
     fclose(fin);
-    
-    // 시그니처 검증
-    if (memcmp(header.signature, ENC_SIGNATURE, 4) != 0) {
+    if (ok != 1) {
         return 0;
     }
     
     // 키 길이 코드에서 실제 키 길이 반환
-    if (header.key_length_code == 0x01) return 128;
-    else if (header.key_length_code == 0x02) return 192;
-    else if (header.key_length_code == 0x03) return 256;
+    if (info.header.key_length_code == 0x01) return 128;
+    else if (info.header.key_length_code == 0x02) return 192;
+    else if (info.header.key_length_code == 0x03) return 256;
     else return 0;
 }
 
-// 파일 복호화 내부 함수 (진행률 콜백 지원)
-static int decrypt_file_internal(const char* input_path, const char* output_path,
-                                  const char* password, char* final_output_path, size_t final_path_size,
-                                  progress_callback_t progress_cb, void* user_data) {
-    FILE* fin = platform_fopen(input_path, "rb");
-    if (!fin) {
-        if (!progress_cb) printf("Error: Cannot open file: %s\n", input_path);
-        return 0;
-    }
+// 평문을 쓰지 않고 무결성만 확인
+int verify_encrypted_file(const char* input_path, const char* password) {
+    if (!input_path || !password) return 0;
     
-    // 헤더 읽기
-    EncFileHeader header;
-    if (fread(&header, 1, sizeof(header), fin) != sizeof(header)) {
-        fclose(fin);
-        if (!progress_cb) printf("Error: Cannot read file header.\n");
-        return 0;
-    }
+    FILE* fin = platform_fopen(input_path, "rb");
+    if (!fin) return 0;
     
-    // 시그니처 검증
-    if (memcmp(header.signature, ENC_SIGNATURE, 4) != 0) {
+    // 헤더 읽기 및 시그니처/버전 검증
+    EncHeaderInfo info;
+    if (read_enc_header(fin, &info) != 1) {
         fclose(fin);
-        if (!progress_cb) printf("Error: Invalid file format.\n");
         return 0;
     }
     
-    // 파일 크기 확인
-    fseek(fin, 0, SEEK_END);
-    long file_size = ftell(fin);
-    
-    // 헤더 다음에 HMAC이 있음
-    long hmac_position = sizeof(header);
-    long ciphertext_size = file_size - sizeof(header) - 64; // 헤더와 HMAC 제외
-    
-    if (ciphertext_size <= 0) {
+    int aes_key_bits;
+    if (info.header.key_length_code == 0x01) aes_key_bits = 128;
+    else if (info.header.key_length_code == 0x02) aes_key_bits = 192;
+    else if (info.header.key_length_code == 0x03) aes_key_bits = 256;
+    else {
         fclose(fin);
-        if (!progress_cb) printf("Error: Invalid file size.\n");
         return 0;
     }
     
-    // HMAC 읽기 (헤더 다음 위치)
-    fseek(fin, hmac_position, SEEK_SET);
-    uint8_t stored_hmac[64];
-    if (fread(stored_hmac, 1, 64, fin) != 64) {
+    if (info.chunked) {
+        // v4: 최종 MAC으로 인덱스를 확인한 뒤 청크 엔진으로 태그만 확인 (복호화하지 않음)
+        EncChunkedFile cf;
+        int ok = (chunked_open(fin, &info, password, &cf) == 1);
+        if (ok) {
+            ChunkEngine engine;
+            chunk_engine_init(&engine, CHUNK_JOB_VERIFY, fin, info.header_size, NULL, 0, &cf.aes_ctx,
+                              cf.nonce_counter, &cf.tag_ctx, info.chunk_size, cf.plaintext_size, cf.tags);
+            ok = chunk_engine_run(&engine, NULL, NULL, NULL);
+        }
+        chunked_close(&cf);
         fclose(fin);
-        if (!progress_cb) printf("Error: Cannot read HMAC.\n");
-        return 0;
+        return ok;
     }
     
-    // AES 키 길이 결정
-    int aes_key_bits;
-    if (header.key_length_code == 0x01) aes_key_bits = 128;
-    else if (header.key_length_code == 0x02) aes_key_bits = 192;
-    else if (header.key_length_code == 0x03) aes_key_bits = 256;
-    else {
+    platform_fseek64(fin, 0, SEEK_END);
+    int64_t ciphertext_size = platform_ftell64(fin) - info.header_size - ENC_HMAC_SIZE;
+    uint8_t stored_hmac[ENC_HMAC_SIZE];
+    platform_fseek64(fin, info.header_size, SEEK_SET);
+    if (ciphertext_size < 0 || fread(stored_hmac, 1, ENC_HMAC_SIZE, fin) != ENC_HMAC_SIZE) {
         fclose(fin);
-        if (!progress_cb) printf("Error: Unsupported AES key length.\n");
         return 0;
     }
     
-    // 키 도출
     uint8_t aes_key[32];
     uint8_t hmac_key[24];
-    derive_keys(password, aes_key_bits, aes_key, hmac_key);
+    derive_file_keys(password, &info, aes_key_bits, aes_key, hmac_key);
     
-    // AES 컨텍스트 설정
     AES_CTX aes_ctx;
-    if (AES_set_key(&aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) {
-        fclose(fin);
-        return 0;
-    }
-    
-    // CTR 모드용 nonce_counter
     uint8_t nonce_counter[16];
-    memcpy(nonce_counter, header.nonce, 8);
-    memset(nonce_counter + 8, 0, 8);
-    
-    if (!progress_cb) printf("Decrypting...\n");
-    
-    // 암호문 위치로 이동 (헤더 + HMAC 다음)
-    fseek(fin, sizeof(header) + 64, SEEK_SET);
+    if (!info.mac_ciphertext) {
+        // v1/v2: HMAC이 평문을 덮으므로 메모리에서 복호화
+        if (AES_set_key(&aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) {
+            fclose(fin);
+            return 0;
+        }
+        memcpy(nonce_counter, info.header.nonce, 8);
+        memset(nonce_counter + 8, 0, 8);
+    }
+    memset(aes_key, 0, sizeof(aes_key));
     
-    // 임시 파일에 복호화된 평문 저장 (HMAC 검증을 위해)
-    FILE* ftemp = tmpfile();
-    if (!ftemp) {
-        fclose(fin);
-        printf("Error: Cannot create temporary file.\n");
-        return 0;
+    HMAC_SHA512_CTX hmac_ctx;
+    hmac_sha512_init(&hmac_ctx, hmac_key, 24);
+    hmac_sha512_update(&hmac_ctx, (uint8_t*)&info.header, sizeof(info.header));
+    if (info.has_kdf) {
+        hmac_sha512_update(&hmac_ctx, (uint8_t*)&info.kdf, sizeof(info.kdf));
     }
+    memset(hmac_key, 0, sizeof(hmac_key));
     
-    // 암호문 읽기 및 복호화
     uint8_t buffer[FILE_CHUNK_SIZE];
-    size_t bytes_read;
-    long total_read = 0;
+    int64_t total_read = 0;
     int success = 1;
-    
-    while (total_read < ciphertext_size) {
-        size_t to_read = (ciphertext_size - total_read < FILE_CHUNK_SIZE) ? 
-                         (ciphertext_size - total_read) : FILE_CHUNK_SIZE;
-        bytes_read = fread(buffer, 1, to_read, fin);
+    if (!info.mac_ciphertext && file_crypto_worker_count() > 1) {
+        // v1/v2: 복호화와 평문 HMAC을 파이프라인으로 겹쳐 처리 (스레드를 만들지 못하면 아래 루프가 처리)
+        success = decrypt_mac_pipelined(fin, NULL, ciphertext_size, &aes_ctx, nonce_counter, &hmac_ctx, 0,
+                                        NULL, NULL, NULL, &total_read);
+    }
+    while (success && total_read < ciphertext_size) {
+        size_t to_read = (ciphertext_size - total_read < FILE_CHUNK_SIZE) ?
+                         (size_t)(ciphertext_size - total_read) : FILE_CHUNK_SIZE;
+        size_t bytes_read = fread(buffer, 1, to_read, fin);
         if (bytes_read == 0) break;
         
-        // 청크 복호화 (in-place)
-        if (AES_CTR_crypt(&aes_ctx, buffer, bytes_read, buffer, nonce_counter) != CRYPTO_SUCCESS) {
+        if (info.mac_ciphertext) {
+            hmac_sha512_update(&hmac_ctx, buffer, bytes_read);  // v3: 복호화 없이 암호문만
+        } else if (!decrypt_chunk(&info, &aes_ctx, nonce_counter, &hmac_ctx, buffer, buffer, bytes_read)) {
             success = 0;
             break;
         }
-        
-        // 복호화된 평문을 임시 파일에 저장
-        if (fwrite(buffer, 1, bytes_read, ftemp) != bytes_read) {
-            success = 0;
-            break;
-        }
-        
         total_read += bytes_read;
-        
-        // 진행률 업데이트 - 콜백이 있으면 콜백, 없으면 print_progress
-        if (progress_cb) {
-            // 복호화는 전체의 50%로 간주 (HMAC 검증이 50%)
-            progress_cb(total_read / 2, ciphertext_size, user_data);
-        } else {
-            // 진행률 출력을 1% 단위로만 (성능 최적화)
-            static long last_percent_decrypt = -1;
-            long current_percent = (total_read * 100) / ciphertext_size;
-            if (current_percent != last_percent_decrypt) {
-                print_progress(total_read, ciphertext_size, "Decrypting");
-                last_percent_decrypt = current_percent;
-            }
-        }
     }
-    
     fclose(fin);
+    memset(buffer, 0, sizeof(buffer));
     
-    if (!success) {
-        fclose(ftemp);
-        if (!progress_cb) printf("\nDecryption failed!\n");
+    uint8_t computed_hmac[ENC_HMAC_SIZE];
+    hmac_sha512_final(&hmac_ctx, computed_hmac);
+    hmac_sha512_wipe(&hmac_ctx);
+    
+    return success && total_read == ciphertext_size &&
+           memcmp(stored_hmac, computed_hmac, ENC_HMAC_SIZE) == 0;
+}
+
+// 파일 복호화 내부 함수 (진행률 콜백 지원)
+static int decrypt_file_internal(const char* input_path, const char* output_path,
+                                  const char* password, char* final_output_path, size_t final_path_size,
+                                  progress_callback_t progress_cb, void* user_data) {
+    FILE* fin = platform_fopen(input_path, "rb");
+    if (!fin) {
+        if (!progress_cb) printf("Error: Cannot open file: %s\n", input_path);
         return 0;
     }
     
-    if (!progress_cb) printf("\nDecryption completed! Verifying HMAC...\n");
-    
-    // HMAC 검증: 헤더 + 복호화한 평문으로 HMAC 생성
-    HMAC_SHA512_CTX hmac_ctx;
-    hmac_sha512_init(&hmac_ctx, hmac_key, 24);
-    hmac_sha512_update(&hmac_ctx, (uint8_t*)&header, sizeof(header));  // 헤더를 HMAC에 포함
-    
-    // 임시 파일에서 복호화된 평문을 읽으면서 HMAC 업데이트
-    fseek(ftemp, 0, SEEK_SET);
-    total_read = 0;
-    
-    while ((bytes_read = fread(buffer, 1, FILE_CHUNK_SIZE, ftemp)) > 0) {
-        hmac_sha512_update(&hmac_ctx, buffer, bytes_read);
-        total_read += bytes_read;
+    // 헤더 읽기 및 시그니처/버전 검증 (v1~v4)
+    EncHeaderInfo info;
+    int header_ok = read_enc_header(fin, &info);
+    if (header_ok == 0) {
+        fclose(fin);
+        if (!progress_cb) printf("Error: Cannot read file header.\n");
+        return 0;
     }
-    
-    // HMAC 최종 계산
-    uint8_t computed_hmac[64];
-    hmac_sha512_final(&hmac_ctx, computed_hmac);
-    
-    // HMAC 검증
-    if (memcmp(stored_hmac, computed_hmac, 64) != 0) {
-        fclose(ftemp);
-        if (!progress_cb) printf("Error: HMAC integrity verification failed. File may be corrupted or password is incorrect.\n");
+    if (header_ok < 0) {
+        fclose(fin);
+        if (!progress_cb) printf("Error: Invalid file format.\n");
         return 0;
     }
+    EncFileHeader header = info.header;
     
-    if (!progress_cb) printf("HMAC verification succeeded! Integrity confirmed.\n");
+    // AES 키 길이 결정
+    int aes_key_bits;
+    if (header.key_length_code == 0x01) aes_key_bits = 128;
+    else if (header.key_length_code == 0x02) aes_key_bits = 192;
+    else if (header.key_length_code == 0x03) aes_key_bits = 256;
+    else {
+        fclose(fin);
+        if (!progress_cb) printf("Error: Unsupported AES key length.\n");
+        return 0;
+    }
     
-    // 진행률 업데이트 (HMAC 검증 완료)
-    if (progress_cb) {
-        progress_cb(ciphertext_size / 2, ciphertext_size, user_data);
+    int64_t ciphertext_size;
+    uint8_t stored_hmac[64];
+    uint8_t aes_key[32];
+    uint8_t hmac_key[24];
+    AES_CTX aes_ctx;
+    uint8_t nonce_counter[16];
+    EncChunkedFile cf;
+    
+    if (info.chunked) {
+        // v4: 청크 인덱스를 최종 MAC으로 먼저 확인 (패스워드가 틀리면 출력 파일을 만들지 않음)
+        int opened = chunked_open(fin, &info, password, &cf);
+        if (opened != 1) {
+            fclose(fin);
+            if (!progress_cb) {
+                if (opened < 0) printf("Error: HMAC integrity verification failed. File may be corrupted or password is incorrect.\n");
+                else printf("Error: Invalid file size.\n");
+            }
+            return 0;
+        }
+        ciphertext_size = (int64_t)cf.plaintext_size;
+    } else {
+        // 파일 크기 확인
+        platform_fseek64(fin, 0, SEEK_END);
+        int64_t file_size = platform_ftell64(fin);
+        
+        // 헤더(v2는 키 도출 파라미터 포함) 다음에 HMAC이 있음
+        int64_t hmac_position = info.header_size;
+        ciphertext_size = file_size - info.header_size - 64; // 헤더와 HMAC 제외
+        
+        // 헤더와 HMAC도 담지 못하는 크기면 잘못된 파일
+        if (ciphertext_size < 0) {
+            fclose(fin);
+            if (!progress_cb) printf("Error: Invalid file size.\n");
+            return 0;
+        }
+        
+        // HMAC 읽기 (헤더 다음 위치)
+        platform_fseek64(fin, hmac_position, SEEK_SET);
+        if (fread(stored_hmac, 1, 64, fin) != 64) {
+            fclose(fin);
+            if (!progress_cb) printf("Error: Cannot read HMAC.\n");
+            return 0;
+        }
+        
+        // 키 도출
+        derive_file_keys(password, &info, aes_key_bits, aes_key, hmac_key);
+        
+        // AES 컨텍스트 설정
+        if (AES_set_key(&aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) {
+            fclose(fin);
+            return 0;
+        }
+        
+        // CTR 모드용 nonce_counter
+        memcpy(nonce_counter, header.nonce, 8);
+        memset(nonce_counter + 8, 0, 8);
     }
     
     // 헤더에서 원본 확장자 읽기
@@ -538,33 +1378,120 @@ static int decrypt_file_internal(const char* input_path, const char* output_path
         final_output_path[final_path_size - 1] = '\0';
     }
     
-    // 출력 파일 작성
-    FILE* fout = platform_fopen(actual_output_path, "wb");
+    // 평문은 출력 파일과 같은 디렉터리의 임시 파일에 쓰고, HMAC이 맞을 때만 출력 경로로 이름을 바꿈
+    // (검증되지 않은 평문이 출력 경로에 남지 않고, /tmp 용량도 필요 없음)
+    char temp_path[600];
+    FILE* fout = platform_create_temp_beside(actual_output_path, temp_path, sizeof(temp_path));
     if (!fout) {
-        fclose(ftemp);
+        fclose(fin);
+        if (info.chunked) chunked_close(&cf);
+        if (!progress_cb) printf("Error: Cannot create temporary file.\n");
         return 0;
     }
     
-    // 임시 파일에서 복호화된 평문을 최종 출력 파일로 복사
-    fseek(ftemp, 0, SEEK_SET);
-    total_read = 0;
+    if (!progress_cb) printf("Decrypting...\n");
+    
+    // HMAC 검증 준비: 헤더 + 복호화한 평문으로 HMAC 생성 (v4는 청크 태그로 확인하므로 사용하지 않음)
+    HMAC_SHA512_CTX hmac_ctx;
+    memset(&hmac_ctx, 0, sizeof(hmac_ctx));
+    if (!info.chunked) {
+        hmac_sha512_init(&hmac_ctx, hmac_key, 24);
+        hmac_sha512_update(&hmac_ctx, (uint8_t*)&header, sizeof(header));  // 헤더를 HMAC에 포함
+        if (info.has_kdf) {
+            hmac_sha512_update(&hmac_ctx, (uint8_t*)&info.kdf, sizeof(info.kdf));
+        }
+        
+        // 암호문 위치로 이동 (헤더 + HMAC 다음)
+        platform_fseek64(fin, info.header_size + 64, SEEK_SET);
+    }
+    
+    // 한 번만 읽으면서 복호화, HMAC 계산, 출력을 함께 수행
+    uint8_t buffer[FILE_CHUNK_SIZE];
+    size_t bytes_read;
+    int64_t total_read = 0;
+    long last_percent = -1;
+    int success = 1;
+    
+    // v4: 청크 엔진이 청크마다 태그를 확인한 뒤 복호화해 임시 파일의 제자리에 씀 (아래 루프는 건너뜀)
+    if (info.chunked) {
+        ChunkEngine engine;
+        chunk_engine_init(&engine, CHUNK_JOB_DECRYPT, fin, info.header_size, fout, 0, &cf.aes_ctx,
+                          cf.nonce_counter, &cf.tag_ctx, info.chunk_size, cf.plaintext_size, cf.tags);
+        success = chunk_engine_run(&engine, progress_cb, user_data, progress_cb ? NULL : "Decrypting");
+        if (success) total_read = ciphertext_size;
+    }
+    
+    // v1/v2/v3는 스레드를 여럿 쓸 수 있으면 읽기(+v3 HMAC)/복호화/쓰기(+v1/v2 HMAC)를 파이프라인으로 겹쳐 처리
+    // (스레드를 만들지 못하면 아무것도 읽지 않고 돌아오므로 아래 루프가 처음부터 처리)
+    if (!info.chunked && file_crypto_worker_count() > 1) {
+        success = decrypt_mac_pipelined(fin, fout, ciphertext_size, &aes_ctx, nonce_counter, &hmac_ctx,
+                                        info.mac_ciphertext, progress_cb, user_data,
+                                        progress_cb ? NULL : "Decrypting", &total_read);
+    }
     
-    while ((bytes_read = fread(buffer, 1, FILE_CHUNK_SIZE, ftemp)) > 0) {
+    while (success && total_read < ciphertext_size) {
+        size_t to_read = (ciphertext_size - total_read < FILE_CHUNK_SIZE) ? 
+                         (size_t)(ciphertext_size - total_read) : FILE_CHUNK_SIZE;
+        bytes_read = fread(buffer, 1, to_read, fin);
+        if (bytes_read == 0) break;
+        
+        // 청크 복호화 + HMAC 업데이트 후 평문을 임시 파일에 저장
+        if (!decrypt_chunk(&info, &aes_ctx, nonce_counter, &hmac_ctx, buffer, buffer, bytes_read)) {
+            success = 0;
+            break;
+        }
         if (fwrite(buffer, 1, bytes_read, fout) != bytes_read) {
-            fclose(ftemp);
+            success = 0;
+            break;
+        }
+        
+        total_read += bytes_read;
+        
+        // 진행률 업데이트 - 콜백이 있으면 콜백, 없으면 1% 단위로 print_progress
+        report_progress(progress_cb, user_data, "Decrypting", total_read, ciphertext_size, &last_percent);
+    }
+    
+    fclose(fin);
+    memset(buffer, 0, sizeof(buffer));
+    if (info.chunked) chunked_close(&cf);
+    
+    if (!success || total_read != ciphertext_size) {
+        hmac_sha512_wipe(&hmac_ctx);
+        fclose(fout);
+        platform_remove(temp_path);
+        if (!progress_cb) printf("\nDecryption failed!\n");
+        return 0;
+    }
+    
+    if (!progress_cb) printf("\nDecryption completed! Verifying HMAC...\n");
+    
+    // HMAC 최종 계산 및 검증 (실패하면 임시 파일 삭제). v4는 청크마다 이미 확인함
+    // 빈 파일(암호문 0바이트)은 위 루프를 건너뛰므로 여기서 헤더(v2/v3는 파라미터 포함)의 HMAC만 확인하고 빈 출력 파일을 만듦
+    if (!info.chunked) {
+        uint8_t computed_hmac[64];
+        hmac_sha512_final(&hmac_ctx, computed_hmac);
+        hmac_sha512_wipe(&hmac_ctx);
+        if (memcmp(stored_hmac, computed_hmac, 64) != 0) {
             fclose(fout);
-            remove(actual_output_path);
+            platform_remove(temp_path);
+            if (!progress_cb) printf("Error: HMAC integrity verification failed. File may be corrupted or password is incorrect.\n");
             return 0;
         }
-        total_read += bytes_read;
     }
     
-    fclose(ftemp);
-    fclose(fout);
+    if (!progress_cb) printf("HMAC verification succeeded! Integrity confirmed.\n");
+    
+    // 디스크에 기록한 뒤 출력 경로로 원자적으로 교체
+    int synced = platform_fsync(fout);
+    if (fclose(fout) != 0 || !synced || !platform_rename_replace(temp_path, actual_output_path)) {
+        platform_remove(temp_path);
+        if (!progress_cb) printf("Error: Cannot write output file: %s\n", actual_output_path);
+        return 0;
+    }
     
     // 진행률 완료 표시
     if (progress_cb) {
-        progress_cb(ciphertext_size, ciphertext_size, user_data);
+        notify_progress(progress_cb, user_data, ciphertext_size, ciphertext_size);
     } else {
         printf("Decryption completed!\n");
     }
@@ -585,20 +1512,174 @@ int decrypt_file_with_progress(const char* input_path, const char* output_path,
     return decrypt_file_internal(input_path, output_path, password, final_output_path, final_path_size, progress_cb, user_data);
 }
 
+// 부분 복호화 (인증되지 않음 - HMAC 검증 없음)
+// 카운터 블록은 8바이트 nonce + 64비트 블록 카운터이므로 임의 오프셋의 키스트림을 바로 계산할 수 있어,
+// 요청 구간의 암호문만 읽어 AES_CTR_crypt_at으로 복호화합니다 (임시 파일/전체 복호화 없음).
+int decrypt_file_range_unauthenticated(const char* input_path, const char* password,
+                                       uint64_t offset, size_t length, uint8_t* out, size_t* out_len) {
+    if (out_len) *out_len = 0;
+    if (!input_path || !password || (!out && length > 0)) return 0;
+
+    FILE* fin = platform_fopen(input_path, "rb");
+    if (!fin) return 0;
+
+    // 헤더 읽기 및 시그니처/버전 검증
+    EncHeaderInfo info;
+    if (read_enc_header(fin, &info) != 1) {
+        fclose(fin);
+        return 0;
+    }
+    const EncFileHeader header = info.header;
+
+    int aes_key_bits;
+    if (header.key_length_code == 0x01) aes_key_bits = 128;
+    else if (header.key_length_code == 0x02) aes_key_bits = 192;
+    else if (header.key_length_code == 0x03) aes_key_bits = 256;
+    else {
+        fclose(fin);
+        return 0;
+    }
+
+    // 평문 크기 = 파일 크기 - 헤더 - HMAC (v4는 트레일러에 기록된 값). 요청 구간을 평문 범위로 제한
+    platform_fseek64(fin, 0, SEEK_END);
+    int64_t plaintext_size = platform_ftell64(fin) - info.header_size - ENC_HMAC_SIZE;
+    int64_t data_offset = info.header_size + ENC_HMAC_SIZE;
+    if (info.chunked) {
+        EncChunkTrailer trailer;
+        if (platform_fseek64(fin, -(int64_t)sizeof(trailer), SEEK_END) != 0 ||
+            fread(&trailer, 1, sizeof(trailer), fin) != sizeof(trailer)) {
+            fclose(fin);
+            return 0;
+        }
+        plaintext_size = (int64_t)load_be64(trailer.plaintext_size);
+        data_offset = info.header_size;
+    }
+    if (plaintext_size < 0 || offset > (uint64_t)plaintext_size) {
+        fclose(fin);
+        return 0;
+    }
+    if ((uint64_t)length > (uint64_t)plaintext_size - offset) {
+        length = (size_t)((uint64_t)plaintext_size - offset);
+    }
+
+    // 키 도출 (HMAC 키는 사용하지 않음)
+    uint8_t aes_key[32];
+    uint8_t hmac_key[24];
+    derive_file_keys(password, &info, aes_key_bits, aes_key, hmac_key);
+
+    AES_CTX aes_ctx;
+    if (AES_set_key(&aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) {
+        fclose(fin);
+        return 0;
+    }
+
+    uint8_t nonce_counter[16];
+    memcpy(nonce_counter, header.nonce, 8);
+    memset(nonce_counter + 8, 0, 8);
+
+    // 필요한 암호문 구간만 읽어서 바로 복호화 (in-place)
+    platform_fseek64(fin, data_offset + (int64_t)offset, SEEK_SET);
+    if (fread(out, 1, length, fin) != length) {
+        fclose(fin);
+        return 0;
+    }
+    fclose(fin);
+
+    if (AES_CTR_crypt_at(&aes_ctx, nonce_counter, offset, out, length, out) != CRYPTO_SUCCESS) {
+        return 0;
+    }
+    if (out_len) *out_len = length;
+    return 1;
+}
+
+// v4 임의 구간 읽기 (인증됨)
+struct EncRangeReader {
+    FILE* fin;
+    EncChunkedFile cf;
+    uint8_t* chunk_buf;        // 청크 하나 (태그 확인 전 암호문)
+};
+
+EncRangeReader* enc_range_open(const char* input_path, const char* password) {
+    if (!input_path || !password) return NULL;
+    
+    FILE* fin = platform_fopen(input_path, "rb");
+    if (!fin) return NULL;
+    
+    EncHeaderInfo info;
+    if (read_enc_header(fin, &info) != 1 || !info.chunked) {
+        fclose(fin);
+        return NULL;
+    }
+    
+    EncRangeReader* reader = (EncRangeReader*)calloc(1, sizeof(EncRangeReader));
+    if (!reader) {
+        fclose(fin);
+        return NULL;
+    }
+    reader->fin = fin;
+    if (chunked_open(fin, &info, password, &reader->cf) != 1 ||
+        !(reader->chunk_buf = (uint8_t*)malloc(info.chunk_size))) {
+        enc_range_close(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+uint64_t enc_range_size(const EncRangeReader* reader) {
+    return reader ? reader->cf.plaintext_size : 0;
+}
+
+// 요청 구간이 걸치는 청크만 읽어 태그를 확인하고, 그 중 필요한 부분만 복호화
+int enc_range_read(EncRangeReader* reader, uint64_t offset, size_t length, uint8_t* out, size_t* out_len) {
+    if (out_len) *out_len = 0;
+    if (!reader || (!out && length > 0) || offset > reader->cf.plaintext_size) return 0;
+    
+    if ((uint64_t)length > reader->cf.plaintext_size - offset) {
+        length = (size_t)(reader->cf.plaintext_size - offset);
+    }
+    
+    uint32_t chunk_size = reader->cf.info.chunk_size;
+    size_t done = 0;
+    while (done < length) {
+        uint64_t pos = offset + done;
+        uint64_t index = pos / chunk_size;
+        size_t skip = (size_t)(pos % chunk_size);
+        size_t chunk_len = chunked_read_chunk(&reader->cf, reader->fin, index, reader->chunk_buf);
+        if (chunk_len == 0) {
+            memset(out, 0, length);
+            return 0;
+        }
+        size_t take = chunk_len - skip;
+        if (take > length - done) take = length - done;
+        if (AES_CTR_crypt_at(&reader->cf.aes_ctx, reader->cf.nonce_counter, pos,
+                             reader->chunk_buf + skip, take, out + done) != CRYPTO_SUCCESS) {
+            memset(out, 0, length);
+            return 0;
+        }
+        done += take;
+    }
+    if (out_len) *out_len = length;
+    return 1;
+}
+
+void enc_range_close(EncRangeReader* reader) {
+    if (!reader) return;
+    if (reader->fin) fclose(reader->fin);
+    free(reader->chunk_buf);
+    chunked_close(&reader->cf);
+    free(reader);
+}
+
 //#ifndef BUILD_GUI
+// 테스트(test_file_crypto)와 함께 링크할 때는 FILE_CRYPTO_NO_MAIN을 정의해 main을 뺌
+#ifndef FILE_CRYPTO_NO_MAIN
 int main(void) {
-    // OpenSSL 활성화 여부 확인 (런타임 체크)
-    // crypto_random_bytes가 호출되면 자동으로 OpenSSL을 로드 시도함
+    // 안전한 난수 생성기 확인 (OpenSSL 또는 OS). 없으면 암호화는 실패함
     uint8_t test_buf[1];
-    if (crypto_random_bytes(test_buf, 1) == CRYPTO_SUCCESS) {
-        printf("OpenSSL enabled (loaded at runtime)\n");
-    } else {
-        printf("OpenSSL not available (will use fallback rand())\n");
+    if (crypto_random_bytes(test_buf, 1) != CRYPTO_SUCCESS) {
+        printf("Warning: Secure random number generator not available. Encryption is disabled.\n");
     }
     
-    // 시드 초기화 (프로그램 시작 시 한 번만)
-    srand((unsigned int)time(NULL));
-    
     int service;
     char file_path[512];
     char password[32];
@@ -640,6 +1721,22 @@ int main(void) {
         }
         
         aes_key_bits = (aes_choice == 1) ? 128 : (aes_choice == 2) ? 192 : 256;
+        
+        // 키 도출 강도: 이 컴퓨터에서 목표 시간만큼 걸리는 PBKDF2 반복 횟수를 측정해 헤더에 기록
+        int kdf_choice;
+        printf("\nSelect key derivation strength:\n");
+        printf("1. Interactive (~%d ms)\n", KDF_TARGET_INTERACTIVE_MS);
+        printf("2. Archive (~%d ms)\n", KDF_TARGET_ARCHIVE_MS);
+        printf("Choice: ");
+        
+        if (scanf("%d", &kdf_choice) != 1 || kdf_choice < 1 || kdf_choice > 2) {
+            printf("Error: Invalid choice.\n");
+            return 1;
+        }
+        
+        uint32_t kdf_target_ms = (kdf_choice == 1) ? KDF_TARGET_INTERACTIVE_MS : KDF_TARGET_ARCHIVE_MS;
+        set_encrypt_kdf_iterations(pbkdf2_sha512_calibrate(kdf_target_ms, KDF_DEFAULT_ITERATIONS));
+        printf("PBKDF2-SHA512 iterations: %u\n", (unsigned int)get_encrypt_kdf_iterations());
         printf("\nStarting file encryption with AES-%d-CTR.\n", aes_key_bits);
         
         printf("Enter password (alphanumeric, case-sensitive, max 10 chars): ");
@@ -825,4 +1922,5 @@ int main(void) {
     
     return 0;
 }
+#endif // FILE_CRYPTO_NO_MAIN
 //#endif // BUILD_GUI
\ No newline at end of file
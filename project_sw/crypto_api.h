@@ -37,6 +37,7 @@ extern "C" {
     // AES 연산에 필요한 state를 담아 두는 구조체
     typedef struct {
         uint8_t round_keys[240];  // 라운드키 저장 공간 (AES256의 최대 240바이트에 맞춰 배열 선언)
+        uint8_t dec_round_keys[240]; // 복호화용 라운드키 (동등 역암호: 1~Nr-1 라운드 키에 InvMixColumns를 미리 적용)
         uint8_t Nr;               // 라운드 수 
         uint8_t Nk;               // 키 워드 수 (4/6/8) (워드 = 4바이트)
         uint16_t key_bits;        // 키 길이 (128/192/256)
@@ -52,6 +53,18 @@ extern "C" {
     // 함수 하나로 암복호화 양방향 처리
     // length==0일 경우 성공 반환
     CRYPTO_STATUS AES_CTR_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out, uint8_t nonce_counter[AES_BLOCK_SIZE]);
+    // 랜덤 액세스: 오프셋 0의 nonce_counter 기준으로 byte_offset 위치부터 처리 (nonce_counter는 변경되지 않음)
+    CRYPTO_STATUS AES_CTR_crypt_at(const AES_CTX* ctx, const uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t byte_offset,
+                                   const uint8_t* in, size_t length, uint8_t* out);
+
+    /* --------------------------- Modes (ECB / CBC) --------------------------- */
+    // 패딩은 하지 않음: ECB는 블록 개수, CBC는 AES_BLOCK_SIZE의 배수 길이만 받음 (아니면 CRYPTO_ERR_INVALID_INPUT)
+    // in == out (in-place) 호출 허용
+    CRYPTO_STATUS AES_ECB_encrypt_blocks(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out);
+    CRYPTO_STATUS AES_ECB_decrypt_blocks(const AES_CTX* ctx, const uint8_t* in, size_t blocks, uint8_t* out);
+    // 호출 후 iv는 마지막 암호문 블록으로 갱신되므로, 같은 iv 버퍼로 이어서 호출하면 하나의 긴 CBC 스트림이 됨
+    CRYPTO_STATUS AES_CBC_encrypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out, uint8_t iv[AES_BLOCK_SIZE]);
+    CRYPTO_STATUS AES_CBC_decrypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out, uint8_t iv[AES_BLOCK_SIZE]);
 
     /* --------------------------- SHA-512 context --------------------------- */
     typedef struct {
@@ -10,12 +10,28 @@ extern "C" {
 
 // .enc 파일 헤더 구조
 #define ENC_SIGNATURE "AESC"
-#define ENC_VERSION 0x01
+#define ENC_VERSION 0x01        // v1: 고정 솔트, 반복 10000회
+#define ENC_VERSION_2 0x02      // v2: 헤더 뒤에 파일별 솔트와 반복 횟수(EncKdfParams)를 기록
+#define ENC_VERSION_3 0x03      // v3: v2와 같은 배치, HMAC이 평문 대신 암호문을 덮음 (Encrypt-then-MAC)
+#define ENC_VERSION_4 0x04      // v4: 고정 크기 청크마다 태그, 파일 끝에 청크 인덱스와 최종 MAC (구간 단위 인증)
 #define ENC_MODE_CTR 0x02
 #define ENC_HMAC_ENABLED 0x01
 #define ENC_HEADER_SIZE 40
 #define ENC_NONCE_SIZE 8
 #define ENC_HMAC_SIZE 64
+#define ENC_KDF_SALT_SIZE 16
+#define ENC_KDF_PARAMS_SIZE 24
+#define ENC_KDF_MIN_ITERATIONS 1000
+#define ENC_KDF_MAX_ITERATIONS 100000000  // 변조된 헤더로 복호화가 끝나지 않는 일을 막기 위한 상한
+#define ENC_KDF_FLAG_SUBKEYS 0x01          // 마스터 키에서 HKDF-SHA512로 파일별 하위 키 도출 (일괄 암호화)
+#define ENC_CHUNK_PARAMS_SIZE 8
+#define ENC_CHUNK_TRAILER_SIZE 80
+#define ENC_CHUNK_TAG_SIZE 16              // 청크 태그 = HMAC-SHA512 앞 16바이트
+#define ENC_CHUNK_DEFAULT_SIZE (1024 * 1024)
+#define ENC_CHUNK_MIN_SIZE 4096
+#define ENC_CHUNK_MAX_SIZE (64 * 1024 * 1024)  // 청크 하나는 검증 전까지 메모리에 올려 두므로 상한을 둠
+#define ENC_ENGINE_MAX_WORKERS 64
+#define ENC_ENGINE_MAX_INFLIGHT (256 * 1024 * 1024)  // 청크 엔진 작업 스레드 버퍼 합계 상한
 
 // 헤더 구조
 typedef struct {
@@ -26,15 +42,69 @@ typedef struct {
     uint8_t hmac_enabled;      // [7:8] 0x01=enabled
     uint8_t nonce[8];          // [8:16] Nonce
     uint8_t format[8];         // [16:24] Original file extension/signature (e.g., ".hwp", ".png", ".jpeg", ".txt")
-    uint8_t reserved[16];      // [24:40] Reserved
+    uint8_t reserved[16];      // [24:40] Reserved (v2 + ENC_KDF_FLAG_SUBKEYS: 파일별 HKDF 솔트)
 } EncFileHeader;
 
+// v2/v3 키 도출 파라미터 (헤더 바로 뒤에 위치하며 헤더와 함께 HMAC에 포함)
+// 파일 배치: v1    = 헤더(40) | HMAC(64) | 암호문          HMAC(헤더 || 평문)
+//            v2    = 헤더(40) | EncKdfParams(24) | HMAC(64) | 암호문   HMAC(헤더 || 파라미터 || 평문)
+//            v3    = v2와 같음                                          HMAC(헤더 || 파라미터 || 암호문)
+// ENC_KDF_FLAG_SUBKEYS가 없으면 키 = PBKDF2(password, salt, iterations)
+// 있으면 마스터 키 = PBKDF2(password, salt, iterations), 키 = HKDF(헤더 reserved || nonce, 마스터 키)
+// (일괄 암호화한 파일들은 salt가 같아 마스터 키 도출을 한 번만 하면 됨)
+typedef struct {
+    uint8_t salt[16];          // [40:56] 랜덤 솔트 (일괄 암호화에서는 세션 공통)
+    uint8_t iterations[4];     // [56:60] PBKDF2 반복 횟수 (big-endian)
+    uint8_t flags;             // [60:61] ENC_KDF_FLAG_*
+    uint8_t reserved[3];       // [61:64] Reserved
+} EncKdfParams;
+
+// v4 청크 배치: 헤더(40) | EncKdfParams(24) | EncChunkParams(8) | 암호문 | 청크 태그(n × 16) | EncChunkTrailer(80)
+// 암호문은 하나의 CTR 스트림이며 청크 i는 평문 i * chunk_size 바이트 위치의 카운터부터 사용 (마지막 청크만 짧을 수 있음)
+// 청크 태그 i = HMAC(0x00 || nonce || i(8, big-endian) || 청크 i 암호문)의 앞 16바이트
+// 최종 MAC = HMAC(헤더 || 파라미터 || 청크 파라미터 || 태그 0..n-1 || plaintext_size || chunk_count)
+// 최종 MAC으로 인덱스를 확인한 뒤에는 필요한 청크만 읽고 그 청크의 태그만 확인하면 됨
+typedef struct {
+    uint8_t chunk_size[4];     // [64:68] 청크 크기 (big-endian, 16의 배수)
+    uint8_t reserved[4];       // [68:72] Reserved
+} EncChunkParams;
+
+typedef struct {
+    uint8_t plaintext_size[8]; // 평문 크기 (big-endian)
+    uint8_t chunk_count[8];    // 청크 수 (big-endian)
+    uint8_t mac[64];           // 최종 MAC
+} EncChunkTrailer;
+
 // 진행률 콜백 함수 타입
 typedef void (*progress_callback_t)(long processed, long total, void* user_data);
 
 // 패스워드 검증 (영문+숫자, 대소문자, 최대 10자)
 int validate_password(const char* password);
 
+// 새로 암호화하는 파일에 기록할 PBKDF2 반복 횟수 (기본값 10000)
+// pbkdf2_sha512_calibrate의 결과를 넘기면 됨. 복호화 쪽은 헤더의 값을 사용하므로 설정할 필요 없음
+// ENC_KDF_MIN_ITERATIONS ~ ENC_KDF_MAX_ITERATIONS 범위를 벗어나면 0 반환 (설정 유지)
+int set_encrypt_kdf_iterations(uint32_t iterations);
+uint32_t get_encrypt_kdf_iterations(void);
+
+// 새로 암호화하는 파일의 청크 크기 (기본값 ENC_CHUNK_DEFAULT_SIZE, v4로 기록)
+// 0이면 청크 없이 v3로 기록. 16의 배수가 아니거나 ENC_CHUNK_MIN_SIZE ~ ENC_CHUNK_MAX_SIZE를 벗어나면 0 반환 (설정 유지)
+int set_encrypt_chunk_size(size_t chunk_size);
+size_t get_encrypt_chunk_size(void);
+
+// v4 파일을 암호화/복호화/검증할 때 쓰는 스레드 수 (청크 엔진). v1/v2 복호화 파이프라인도 2 이상일 때만 사용
+// 0 = CPU 코어 수(기본값), 1 = 호출한 스레드에서만 처리, 최대 ENC_ENGINE_MAX_WORKERS
+// 스레드마다 청크 하나 크기의 버퍼를 쓰며, 합계가 ENC_ENGINE_MAX_INFLIGHT를 넘지 않도록 스레드 수를 줄임
+// 범위를 벗어나면 0 반환 (설정 유지)
+int set_file_crypto_workers(int workers);
+int get_file_crypto_workers(void);
+
+// 일괄 암호화 세션: 시작할 때 패스워드로 마스터 키를 한 번만 도출해 두고,
+// 세션 동안 같은 패스워드로 호출된 encrypt_file*는 파일별 랜덤 솔트와 nonce로 HKDF-SHA512 하위 키를 만들어 사용
+// 다른 패스워드로 호출되면 세션을 쓰지 않고 파일마다 키를 도출. 세션 중 여러 스레드에서 암호화해도 됨
+int encrypt_batch_begin(const char* password);   // 성공 1, 실패 0
+void encrypt_batch_end(void);                    // 마스터 키를 지우고 세션 종료
+
 // 파일 암호화
 int encrypt_file(const char* input_path, const char* output_path,
                  int aes_key_bits, const char* password);
@@ -56,6 +126,34 @@ int decrypt_file_with_progress(const char* input_path, const char* output_path,
 // 헤더에서 AES 키 길이 읽기
 int read_aes_key_length(const char* input_path);
 
+// 평문을 쓰지 않고 무결성(HMAC)만 확인 (패스워드가 맞고 변조되지 않았으면 1, 아니면 0)
+// v3는 암호문만 읽어 확인하므로 복호화하지 않음. v1/v2는 메모리에서 복호화하면서 확인
+int verify_encrypted_file(const char* input_path, const char* password);
+
+// 부분 복호화: 평문의 [offset, offset + length) 구간에 해당하는 암호문만 읽어 out에 복호화
+// 주의: 인증되지 않은 복호화! HMAC은 평문 전체에 대해 계산되므로 이 함수는 HMAC을 검증하지 않습니다.
+//       패스워드가 틀리거나 파일이 변조되어도 실패하지 않고 잘못된 평문을 돌려줄 수 있습니다.
+//       v4 파일은 인증되는 enc_range_read를 사용하세요.
+// 파일 끝을 넘는 구간은 잘라내며, 실제 복호화한 바이트 수를 out_len에 기록 (성공 1, 실패 0)
+int decrypt_file_range_unauthenticated(const char* input_path, const char* password,
+                                       uint64_t offset, size_t length, uint8_t* out, size_t* out_len);
+
+// v4 파일의 임의 구간 읽기 (인증됨)
+// 여는 시점에 청크 인덱스를 최종 MAC으로 확인하고, 읽을 때는 요청 구간이 걸치는 청크만 읽어 그 태그를 확인
+// 한 리더를 여러 스레드에서 동시에 쓰면 안 됨 (스레드마다 따로 열 것)
+typedef struct EncRangeReader EncRangeReader;
+
+// v4가 아니거나 패스워드가 틀렸거나 인덱스가 변조되었으면 NULL
+EncRangeReader* enc_range_open(const char* input_path, const char* password);
+uint64_t enc_range_size(const EncRangeReader* reader);   // 평문 전체 크기
+// 평문 [offset, offset + length)를 out에 복호화. 파일 끝을 넘는 구간은 잘라내며 실제 길이를 out_len에 기록
+// 청크 태그가 하나라도 맞지 않으면 out을 0으로 지우고 0 반환 (성공 1)
+int enc_range_read(EncRangeReader* reader, uint64_t offset, size_t length, uint8_t* out, size_t* out_len);
+void enc_range_close(EncRangeReader* reader);
+
+// 파일 계층 테스트 (test.c, 성공 0). cli.c는 FILE_CRYPTO_NO_MAIN으로 빌드해 함께 링크
+int test_file_crypto(void);
+
 #ifdef __cplusplus
 }
 #endif
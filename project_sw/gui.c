@@ -63,7 +63,6 @@ static char g_droppedFiles[10][512];  // Stores up to 10 file paths
 static int g_fileCount = 0;
 
 // 진행률 추적을 위한 전역 변수 추가
-static long g_currentFileSize = 0;
 static int g_currentFileIndex = 0;
 static int g_totalFiles = 0;
 
@@ -90,9 +89,9 @@ LRESULT CALLBACK ProgressWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
 
 // 진행률 콜백 함수
 void EncryptionProgressCallback(long processed, long total, void* user_data) {
-    if (g_currentFileSize > 0 && g_hProgressBar) {
-        // 현재 파일 내부 진행률
-        int file_percent = (int)((double)processed / g_currentFileSize * 100.0);
+    if (total > 0 && g_hProgressBar) {
+        // 현재 파일 내부 진행률 (큰 파일은 total이 천분율로 넘어오므로 total 기준으로 계산)
+        int file_percent = (int)((double)processed / total * 100.0);
         if (file_percent > 100) file_percent = 100;
         
         // 전체 진행률 계산: (이전 파일들) + (현재 파일 진행률)
@@ -766,19 +765,14 @@ void EncryptFiles(void) {
     // Create progress window
     CreateProgressWindow();
     
+    // 여러 파일이면 마스터 키를 한 번만 도출하고 파일별 하위 키 사용
+    if (g_fileCount > 1) {
+        encrypt_batch_begin(password);
+    }
+    
     for (int i = 0; i < g_fileCount; i++) {
         g_currentFileIndex = i;
         
-        // 파일 크기 확인
-        FILE* f = platform_fopen(g_droppedFiles[i], "rb");
-        if (f) {
-            fseek(f, 0, SEEK_END);
-            g_currentFileSize = ftell(f);
-            fclose(f);
-        } else {
-            g_currentFileSize = 0;
-        }
-        
         // Update progress window
         UpdateProgressWindow(i, g_fileCount, g_droppedFiles[i]);
         
@@ -826,6 +820,8 @@ void EncryptFiles(void) {
         }
     }
     
+    encrypt_batch_end();
+    
     // Update progress to 100%
     UpdateProgressWindow(g_fileCount, g_fileCount, NULL);
     
@@ -298,6 +298,11 @@ void EncryptFiles(void) {
     // 진행률 바 표시
     ShowProgress(YES);
     
+    // 여러 파일이면 마스터 키를 한 번만 도출하고 파일별 하위 키 사용 (모든 파일이 끝나면 종료)
+    if (total_files > 1) {
+        encrypt_batch_begin(passwordAnsi);
+    }
+    
     for (NSInteger i = 0; i < [g_droppedFiles count]; i++) {
         NSString* filePath = [g_droppedFiles objectAtIndex:i];
         const char* inputPath = [filePath UTF8String];
@@ -339,8 +344,11 @@ void EncryptFiles(void) {
                             NSDictionary* outAttrs = [fm attributesOfItemAtPath:outputPathStr error:nil];
                             if (outAttrs) {
                                 unsigned long long outSize = [[outAttrs objectForKey:NSFileSize] unsignedLongLongValue];
-                                // 헤더(40) + HMAC(64) = 104 바이트 추가
-                                unsigned long long expectedSize = fileSize + 104;
+                                // v4: 헤더(40) + 키 도출 파라미터(24) + 청크 파라미터(8) + 트레일러(80) + 청크마다 태그(16)
+                                unsigned long long chunkSize = get_encrypt_chunk_size();
+                                unsigned long long expectedSize = chunkSize
+                                    ? fileSize + 152 + (fileSize + chunkSize - 1) / chunkSize * ENC_CHUNK_TAG_SIZE
+                                    : fileSize + 128;
                                 if (expectedSize > 0) {
                                     double progress = ((double)outSize / expectedSize) * 100.0;
                                     if (progress > 100.0) progress = 100.0;
@@ -366,6 +374,7 @@ void EncryptFiles(void) {
                     
                     // 모든 파일 처리 완료 시
                     if (completed >= total_files) {
+                        encrypt_batch_end();
                         ShowProgress(NO);
                         NSString* status = [NSString stringWithFormat:@"Encryption completed: %d succeeded, %d failed", success_count, fail_count];
                         UpdateStatus(status);
@@ -384,6 +393,7 @@ void EncryptFiles(void) {
             fail_count++;
             
             if (completed >= total_files) {
+                encrypt_batch_end();
                 ShowProgress(NO);
                 NSString* status = [NSString stringWithFormat:@"Encryption completed: %d succeeded, %d failed", success_count, fail_count];
                 UpdateStatus(status);
@@ -392,6 +402,15 @@ void EncryptFiles(void) {
     }
 }
 
+// decrypt_file_with_progress 진행률 콜백 (복호화 스레드에서 호출, UpdateProgress가 메인 큐로 넘김)
+static void DecryptProgressCallback(long processed, long total, void* user_data) {
+    if (total <= 0) return;
+    NSString* fileName = (__bridge NSString*)user_data;
+    double progress = (double)processed / (double)total * 100.0;
+    if (progress > 100.0) progress = 100.0;
+    UpdateProgress(progress, [NSString stringWithFormat:@"Decrypting: %@ (%.1f%%)", fileName, progress]);
+}
+
 void DecryptFiles(void) {
     if ([g_droppedFiles count] == 0) {
         UpdateStatus(@"Error: Please select files first.");
@@ -438,13 +457,6 @@ void DecryptFiles(void) {
             continue;
         }
         
-        // 파일 크기 확인
-        NSFileManager* fileManager = [NSFileManager defaultManager];
-        NSDictionary* attrs = [fileManager attributesOfItemAtPath:filePath error:nil];
-        unsigned long long fileSize = [[attrs objectForKey:NSFileSize] unsignedLongLongValue];
-        // 헤더(40) + HMAC(64) = 104 바이트 제외
-        unsigned long long expectedOutputSize = (fileSize > 104) ? (fileSize - 104) : 0;
-        
         // Read AES key length
         int aes_key_bits = read_aes_key_length(inputPath);
         if (aes_key_bits > 0) {
@@ -470,39 +482,13 @@ void DecryptFiles(void) {
             strncpy(passwordCopy, passwordAnsi, 31);
             passwordCopy[31] = '\0';
             
-            // 별도 스레드에서 복호화 실행 및 진행률 모니터링
+            // 별도 스레드에서 복호화 실행 (진행률은 콜백으로 받음)
+            // 평문은 임시 파일에 쓰고 검증 후 이름을 바꾸므로 출력 파일 크기로는 진행률을 알 수 없음
             dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-                __block int result = 0;
-                char* final_output_path = (char*)malloc(512);
-                
-                // 진행률 모니터링 스레드 시작
-                dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
-                    NSFileManager* fm = [NSFileManager defaultManager];
-                    while (result == 0) {
-                        usleep(100000); // 0.1초마다 체크
-                        if (final_output_path[0] != '\0' && [fm fileExistsAtPath:[NSString stringWithUTF8String:final_output_path]]) {
-                            NSDictionary* outAttrs = [fm attributesOfItemAtPath:[NSString stringWithUTF8String:final_output_path] error:nil];
-                            if (outAttrs && expectedOutputSize > 0) {
-                                unsigned long long outSize = [[outAttrs objectForKey:NSFileSize] unsignedLongLongValue];
-                                double progress = ((double)outSize / expectedOutputSize) * 100.0;
-                                if (progress > 100.0) progress = 100.0;
-                                UpdateProgress(progress, [NSString stringWithFormat:@"Decrypting: %@ (%.1f%%)", fileName, progress]);
-                            }
-                        } else if ([fm fileExistsAtPath:outputPathStr]) {
-                            NSDictionary* outAttrs = [fm attributesOfItemAtPath:outputPathStr error:nil];
-                            if (outAttrs && expectedOutputSize > 0) {
-                                unsigned long long outSize = [[outAttrs objectForKey:NSFileSize] unsignedLongLongValue];
-                                double progress = ((double)outSize / expectedOutputSize) * 100.0;
-                                if (progress > 100.0) progress = 100.0;
-                                UpdateProgress(progress, [NSString stringWithFormat:@"Decrypting: %@ (%.1f%%)", fileName, progress]);
-                            }
-                        }
-                    }
-                    free(final_output_path);
-                });
-                
-                // 복호화 실행
-                result = decrypt_file(inputPath, outputPath, passwordCopy, final_output_path, 512);
+                char final_output_path[512] = {0};
+                int result = decrypt_file_with_progress(inputPath, outputPath, passwordCopy,
+                                                        final_output_path, sizeof(final_output_path),
+                                                        DecryptProgressCallback, (__bridge void*)fileName);
                 free(passwordCopy);
                 
                 dispatch_async(dispatch_get_main_queue(), ^{
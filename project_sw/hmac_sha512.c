@@ -2,8 +2,12 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include "hmac_sha512.h"
 #include "sha512.h"
+#include "aes.h"             /* 리포트: AES-CTR 처리량 */
+#include "kdf.h"             /* 리포트: PBKDF2 처리량 */
+#include "platform_utils.h"  /* 리포트: 타이머, 파일 열기 */
 
 #ifndef SHA512_DIGEST_SIZE
 #define SHA512_DIGEST_SIZE 64
@@ -17,8 +21,10 @@ void hmac_sha512_init(HMAC_SHA512_CTX* ctx,
     const uint8_t* key, size_t key_len)
 {
     uint8_t key_block[SHA512_BLOCK_SIZE];
+    uint8_t pad[SHA512_BLOCK_SIZE];
     if (!ctx) return;
     ctx->initialized = 0;
+    ctx->keyed = 0;
 
     memset(key_block, 0, sizeof(key_block));
     if (key_len > SHA512_BLOCK_SIZE) {
@@ -31,17 +37,20 @@ void hmac_sha512_init(HMAC_SHA512_CTX* ctx,
         memcpy(key_block, key, key_len);
     }
 
-    for (size_t i = 0; i < SHA512_BLOCK_SIZE; ++i) {
-        ctx->i_key_pad[i] = (uint8_t)(key_block[i] ^ 0x36);
-        ctx->o_key_pad[i] = (uint8_t)(key_block[i] ^ 0x5c);
-    }
-
-    sha512_init(&ctx->ictx);
-    sha512_update(&ctx->ictx, ctx->i_key_pad, SHA512_BLOCK_SIZE);
+    /* 키 패드 블록을 한 번씩만 압축해 두고, 이후 메시지는 이 중간 상태에서 시작 */
+    for (size_t i = 0; i < SHA512_BLOCK_SIZE; ++i) pad[i] = (uint8_t)(key_block[i] ^ 0x36);
+    sha512_init(&ctx->ikey);
+    sha512_update(&ctx->ikey, pad, SHA512_BLOCK_SIZE);
 
+    for (size_t i = 0; i < SHA512_BLOCK_SIZE; ++i) pad[i] = (uint8_t)(key_block[i] ^ 0x5c);
     sha512_init(&ctx->octx);
-    sha512_update(&ctx->octx, ctx->o_key_pad, SHA512_BLOCK_SIZE);
+    sha512_update(&ctx->octx, pad, SHA512_BLOCK_SIZE);
+
+    memset(key_block, 0, sizeof(key_block));
+    memset(pad, 0, sizeof(pad));
 
+    ctx->ictx = ctx->ikey;
+    ctx->keyed = 1;
     ctx->initialized = 1;
 }
 
@@ -60,11 +69,75 @@ void hmac_sha512_final(HMAC_SHA512_CTX* ctx, uint8_t* mac_out)
 
     sha512_final(&ctx->ictx, inner_hash);
 
-    octx2 = ctx->octx; /* copy */
+    octx2 = ctx->octx; /* copy (중간 상태는 reset을 위해 보존) */
     sha512_update(&octx2, inner_hash, SHA512_DIGEST_SIZE);
     sha512_final(&octx2, mac_out);
+    memset(inner_hash, 0, sizeof(inner_hash));
+
+    ctx->initialized = 0; /* 같은 키로 다시 쓰려면 hmac_sha512_reset */
+}
+
+/* ===================== Key reuse ===================== */
+int hmac_sha512_reset(HMAC_SHA512_CTX* ctx)
+{
+    if (!ctx || !ctx->keyed) return 0;
+    ctx->ictx = ctx->ikey;
+    ctx->initialized = 1;
+    return 1;
+}
+
+int hmac_sha512_clone(HMAC_SHA512_CTX* dst, const HMAC_SHA512_CTX* src)
+{
+    if (!dst || !src || !src->keyed) return 0;
+    *dst = *src;
+    return 1;
+}
 
-    ctx->initialized = 0; /* re-init needed for reuse */
+void hmac_sha512_wipe(HMAC_SHA512_CTX* ctx)
+{
+    if (!ctx) return;
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+static void put_be64(uint8_t* p, uint64_t v)
+{
+    for (int i = 0; i < 8; ++i) p[i] = (uint8_t)(v >> (56 - 8 * i));
+}
+
+static uint64_t get_be64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+int hmac_sha512_export_midstate(const HMAC_SHA512_CTX* ctx, uint8_t out[HMAC_SHA512_MIDSTATE_SIZE])
+{
+    if (!ctx || !ctx->keyed || !out) return 0;
+    for (int i = 0; i < 8; ++i) {
+        put_be64(out + 8 * i, ctx->ikey.state[i]);
+        put_be64(out + 64 + 8 * i, ctx->octx.state[i]);
+    }
+    return 1;
+}
+
+int hmac_sha512_import_midstate(HMAC_SHA512_CTX* ctx, const uint8_t in[HMAC_SHA512_MIDSTATE_SIZE])
+{
+    if (!ctx || !in) return 0;
+
+    /* 키 패드 블록(128바이트) 하나를 압축한 직후와 같은 상태로 복원 */
+    sha512_init(&ctx->ikey);
+    sha512_init(&ctx->octx);
+    for (int i = 0; i < 8; ++i) {
+        ctx->ikey.state[i] = get_be64(in + 8 * i);
+        ctx->octx.state[i] = get_be64(in + 64 + 8 * i);
+    }
+    ctx->ikey.bitlen_low = ctx->octx.bitlen_low = SHA512_BLOCK_SIZE * 8;
+
+    ctx->ictx = ctx->ikey;
+    ctx->keyed = 1;
+    ctx->initialized = 1;
+    return 1;
 }
 
 /* ===================== One-shot HMAC ===================== */
@@ -78,3 +151,279 @@ void hmac_sha512(const uint8_t* key, size_t key_len,
     hmac_sha512_final(&ctx, mac_out);
 }
 
+/* ===================== Self-test / benchmark report ===================== */
+#define HMAC_REPORT_BENCH_NS (50u * 1000000u)   /* 측정 항목마다 최소 측정 시간 */
+#define HMAC_REPORT_BENCH_BUF (64u * 1024u)      /* AES-CTR 병렬 임계값보다 작게: 단일 스레드 처리량 */
+#define HMAC_REPORT_PBKDF2_ITERATIONS 1000u
+
+typedef struct {
+    const char* key_str;   /* NULL이면 key_fill로 채움 */
+    uint8_t key_fill;      /* 0이면 0x01, 0x02, ... (Test Case 4) */
+    size_t key_len;
+    const char* data_str;  /* NULL이면 data_fill로 채움 */
+    uint8_t data_fill;
+    size_t data_len;
+    size_t mac_len;        /* Test Case 5는 128비트로 자른 값만 비교 */
+} hmac_rfc4231_case;
+
+static const hmac_rfc4231_case rfc4231_cases[7] = {
+    { NULL, 0x0b, 20, "Hi There", 0, 8, 64 },
+    { "Jefe", 0, 4, "what do ya want for nothing?", 0, 28, 64 },
+    { NULL, 0xaa, 20, NULL, 0xdd, 50, 64 },
+    { NULL, 0x00, 25, NULL, 0xcd, 50, 64 },
+    { NULL, 0x0c, 20, "Test With Truncation", 0, 20, 16 },
+    { NULL, 0xaa, 131, "Test Using Larger Than Block-Size Key - Hash Key First", 0, 54, 64 },
+    { NULL, 0xaa, 131, "This is a test using a larger than block-size key and a larger than block-size data. "
+                       "The key needs to be hashed before being used by the HMAC algorithm.", 0, 152, 64 }
+};
+
+static const uint8_t rfc4231_mac[7][64] = {
+    { /* Test Case 1 */
+        0x87, 0xaa, 0x7c, 0xde, 0xa5, 0xef, 0x61, 0x9d, 0x4f, 0xf0, 0xb4, 0x24, 0x1a, 0x1d, 0x6c, 0xb0,
+        0x23, 0x79, 0xf4, 0xe2, 0xce, 0x4e, 0xc2, 0x78, 0x7a, 0xd0, 0xb3, 0x05, 0x45, 0xe1, 0x7c, 0xde,
+        0xda, 0xa8, 0x33, 0xb7, 0xd6, 0xb8, 0xa7, 0x02, 0x03, 0x8b, 0x27, 0x4e, 0xae, 0xa3, 0xf4, 0xe4,
+        0xbe, 0x9d, 0x91, 0x4e, 0xeb, 0x61, 0xf1, 0x70, 0x2e, 0x69, 0x6c, 0x20, 0x3a, 0x12, 0x68, 0x54
+    },
+    { /* Test Case 2 */
+        0x16, 0x4b, 0x7a, 0x7b, 0xfc, 0xf8, 0x19, 0xe2, 0xe3, 0x95, 0xfb, 0xe7, 0x3b, 0x56, 0xe0, 0xa3,
+        0x87, 0xbd, 0x64, 0x22, 0x2e, 0x83, 0x1f, 0xd6, 0x10, 0x27, 0x0c, 0xd7, 0xea, 0x25, 0x05, 0x54,
+        0x97, 0x58, 0xbf, 0x75, 0xc0, 0x5a, 0x99, 0x4a, 0x6d, 0x03, 0x4f, 0x65, 0xf8, 0xf0, 0xe6, 0xfd,
+        0xca, 0xea, 0xb1, 0xa3, 0x4d, 0x4a, 0x6b, 0x4b, 0x63, 0x6e, 0x07, 0x0a, 0x38, 0xbc, 0xe7, 0x37
+    },
+    { /* Test Case 3 */
+        0xfa, 0x73, 0xb0, 0x08, 0x9d, 0x56, 0xa2, 0x84, 0xef, 0xb0, 0xf0, 0x75, 0x6c, 0x89, 0x0b, 0xe9,
+        0xb1, 0xb5, 0xdb, 0xdd, 0x8e, 0xe8, 0x1a, 0x36, 0x55, 0xf8, 0x3e, 0x33, 0xb2, 0x27, 0x9d, 0x39,
+        0xbf, 0x3e, 0x84, 0x82, 0x79, 0xa7, 0x22, 0xc8, 0x06, 0xb4, 0x85, 0xa4, 0x7e, 0x67, 0xc8, 0x07,
+        0xb9, 0x46, 0xa3, 0x37, 0xbe, 0xe8, 0x94, 0x26, 0x74, 0x27, 0x88, 0x59, 0xe1, 0x32, 0x92, 0xfb
+    },
+    { /* Test Case 4 */
+        0xb0, 0xba, 0x46, 0x56, 0x37, 0x45, 0x8c, 0x69, 0x90, 0xe5, 0xa8, 0xc5, 0xf6, 0x1d, 0x4a, 0xf7,
+        0xe5, 0x76, 0xd9, 0x7f, 0xf9, 0x4b, 0x87, 0x2d, 0xe7, 0x6f, 0x80, 0x50, 0x36, 0x1e, 0xe3, 0xdb,
+        0xa9, 0x1c, 0xa5, 0xc1, 0x1a, 0xa2, 0x5e, 0xb4, 0xd6, 0x79, 0x27, 0x5c, 0xc5, 0x78, 0x80, 0x63,
+        0xa5, 0xf1, 0x97, 0x41, 0x12, 0x0c, 0x4f, 0x2d, 0xe2, 0xad, 0xeb, 0xeb, 0x10, 0xa2, 0x98, 0xdd
+    },
+    { /* Test Case 5 */
+        0x41, 0x5f, 0xad, 0x62, 0x71, 0x58, 0x0a, 0x53, 0x1d, 0x41, 0x79, 0xbc, 0x89, 0x1d, 0x87, 0xa6,
+        0x50, 0x18, 0x87, 0x07, 0x92, 0x2a, 0x4f, 0xbb, 0x36, 0x66, 0x3a, 0x1e, 0xb1, 0x6d, 0xa0, 0x08,
+        0x71, 0x1c, 0x5b, 0x50, 0xdd, 0xd0, 0xfc, 0x23, 0x50, 0x84, 0xeb, 0x9d, 0x33, 0x64, 0xa1, 0x45,
+        0x4f, 0xb2, 0xef, 0x67, 0xcd, 0x1d, 0x29, 0xfe, 0x67, 0x73, 0x06, 0x8e, 0xa2, 0x66, 0xe9, 0x6b
+    },
+    { /* Test Case 6 */
+        0x80, 0xb2, 0x42, 0x63, 0xc7, 0xc1, 0xa3, 0xeb, 0xb7, 0x14, 0x93, 0xc1, 0xdd, 0x7b, 0xe8, 0xb4,
+        0x9b, 0x46, 0xd1, 0xf4, 0x1b, 0x4a, 0xee, 0xc1, 0x12, 0x1b, 0x01, 0x37, 0x83, 0xf8, 0xf3, 0x52,
+        0x6b, 0x56, 0xd0, 0x37, 0xe0, 0x5f, 0x25, 0x98, 0xbd, 0x0f, 0xd2, 0x21, 0x5d, 0x6a, 0x1e, 0x52,
+        0x95, 0xe6, 0x4f, 0x73, 0xf6, 0x3f, 0x0a, 0xec, 0x8b, 0x91, 0x5a, 0x98, 0x5d, 0x78, 0x65, 0x98
+    },
+    { /* Test Case 7 */
+        0xe3, 0x7b, 0x6a, 0x77, 0x5d, 0xc8, 0x7d, 0xba, 0xa4, 0xdf, 0xa9, 0xf9, 0x6e, 0x5e, 0x3f, 0xfd,
+        0xde, 0xbd, 0x71, 0xf8, 0x86, 0x72, 0x89, 0x86, 0x5d, 0xf5, 0xa3, 0x2d, 0x20, 0xcd, 0xc9, 0x44,
+        0xb6, 0x02, 0x2c, 0xac, 0x3c, 0x49, 0x82, 0xb1, 0x0d, 0x5e, 0xeb, 0x55, 0xc3, 0xe4, 0xde, 0x15,
+        0x13, 0x46, 0x76, 0xfb, 0x6d, 0xe0, 0x44, 0x60, 0x65, 0xc9, 0x74, 0x40, 0xfa, 0x8c, 0x6a, 0x58
+    }
+};
+
+static void hmac_report_fill(uint8_t* out, const char* str, uint8_t fill, size_t len)
+{
+    if (str) {
+        memcpy(out, str, len);
+    } else if (fill) {
+        memset(out, fill, len);
+    } else {
+        for (size_t i = 0; i < len; ++i) out[i] = (uint8_t)(i + 1);
+    }
+}
+
+typedef void (*hmac_bench_fn)(void* arg, uint8_t* buf, size_t len);
+
+typedef struct {
+    AES_CTX ctx;
+    uint8_t nonce_counter[AES_BLOCK_SIZE];
+} hmac_bench_aes;
+
+static void hmac_bench_sha512(void* arg, uint8_t* buf, size_t len)
+{
+    SHA512_CTX ctx;
+    uint8_t digest[SHA512_DIGEST_SIZE];
+    (void)arg;
+    sha512_init(&ctx);
+    sha512_update(&ctx, buf, len);
+    sha512_final(&ctx, digest);
+    buf[0] ^= digest[0];  /* 결과를 사용해 호출이 최적화로 사라지지 않게 함 */
+}
+
+static void hmac_bench_hmac(void* arg, uint8_t* buf, size_t len)
+{
+    HMAC_SHA512_CTX* ctx = (HMAC_SHA512_CTX*)arg;
+    uint8_t mac[SHA512_DIGEST_SIZE];
+    hmac_sha512_reset(ctx);
+    hmac_sha512_update(ctx, buf, len);
+    hmac_sha512_final(ctx, mac);
+    buf[0] ^= mac[0];
+}
+
+static void hmac_bench_pbkdf2(void* arg, uint8_t* buf, size_t len)
+{
+    static const uint8_t password[] = "password";
+    static const uint8_t salt[] = "salt";
+    uint8_t out[64];
+    (void)arg;
+    (void)len;
+    pbkdf2_sha512(password, sizeof(password) - 1, salt, sizeof(salt) - 1,
+        HMAC_REPORT_PBKDF2_ITERATIONS, out, sizeof(out));
+    buf[0] ^= out[0];
+}
+
+static void hmac_bench_aes_ctr(void* arg, uint8_t* buf, size_t len)
+{
+    hmac_bench_aes* a = (hmac_bench_aes*)arg;
+    AES_CTR_crypt(&a->ctx, buf, len, buf, a->nonce_counter);
+}
+
+/* fn을 HMAC_REPORT_BENCH_NS 이상 반복 호출하고 처리량을 rep->bench에 추가 */
+static void hmac_report_bench(HMAC_SHA512_Report* rep, const char* name, const char* impl,
+    hmac_bench_fn fn, void* arg, uint8_t* buf, size_t len, uint64_t bytes_per_call)
+{
+    HMAC_SHA512_Bench* b;
+    uint64_t calls = 0, start, cycles, elapsed;
+    if (rep->bench_count >= HMAC_SHA512_REPORT_MAX_BENCH) return;
+
+    fn(arg, buf, len); /* 워밍업 (캐시, 지연 초기화) */
+    start = platform_time_ns();
+    cycles = platform_cycle_counter();
+    do {
+        fn(arg, buf, len);
+        ++calls;
+        elapsed = platform_time_ns() - start;
+    } while (elapsed < HMAC_REPORT_BENCH_NS);
+    cycles = platform_cycle_counter() - cycles;
+
+    b = &rep->bench[rep->bench_count++];
+    b->name = name;
+    b->impl = impl;
+    b->bytes = calls * bytes_per_call;
+    b->ms = (double)elapsed / 1e6;
+    b->mb_per_s = (double)b->bytes * 1000.0 / (double)elapsed;
+    b->cycles_per_byte = cycles ? (double)cycles / (double)b->bytes : 0.0;
+}
+
+static void hmac_report_benchmarks(HMAC_SHA512_Report* rep)
+{
+    static const SHA512_IMPL sha_impls[] = { SHA512_IMPL_SCALAR, SHA512_IMPL_AVX2 };
+    static const AES_IMPL aes_impls[] = {
+        AES_IMPL_TABLE, AES_IMPL_BITSLICE, AES_IMPL_VPAES,
+        AES_IMPL_AESNI, AES_IMPL_VAES_AVX2, AES_IMPL_VAES_AVX512
+    };
+    static const int aes_bits[3] = { 128, 192, 256 };
+    static const char* const aes_names[3] = { "aes-128-ctr", "aes-192-ctr", "aes-256-ctr" };
+    static const uint8_t aes_key[32] = { 0 };
+    uint8_t* buf = (uint8_t*)malloc(HMAC_REPORT_BENCH_BUF);
+    if (!buf) return;
+    for (size_t i = 0; i < HMAC_REPORT_BENCH_BUF; ++i) buf[i] = (uint8_t)i;
+
+    /* SHA-512 계열: 구현마다 해시, HMAC, PBKDF2 */
+    SHA512_IMPL prev_sha = sha512_get_impl();
+    for (size_t i = 0; i < sizeof(sha_impls) / sizeof(sha_impls[0]); ++i) {
+        HMAC_SHA512_CTX hctx;
+        const char* impl = sha512_impl_name(sha_impls[i]);
+        if (!sha512_impl_available(sha_impls[i]) || sha512_set_impl(sha_impls[i]) != CRYPTO_SUCCESS) continue;
+
+        hmac_report_bench(rep, "sha512", impl, hmac_bench_sha512, NULL, buf, HMAC_REPORT_BENCH_BUF,
+            HMAC_REPORT_BENCH_BUF);
+        hmac_sha512_init(&hctx, buf, 64);
+        hmac_report_bench(rep, "hmac-sha512", impl, hmac_bench_hmac, &hctx, buf, HMAC_REPORT_BENCH_BUF,
+            HMAC_REPORT_BENCH_BUF);
+        hmac_sha512_wipe(&hctx);
+        /* 반복마다 SHA-512 블록 두 개(inner, outer)를 압축 */
+        hmac_report_bench(rep, "pbkdf2-sha512", impl, hmac_bench_pbkdf2, NULL, buf, 0,
+            (uint64_t)HMAC_REPORT_PBKDF2_ITERATIONS * 2u * SHA512_BLOCK_SIZE);
+    }
+    sha512_set_impl(prev_sha);
+
+    /* AES-CTR: 키 길이마다 구현별로 */
+    AES_IMPL prev_aes = AES_get_impl();
+    for (int k = 0; k < 3; ++k) {
+        for (size_t i = 0; i < sizeof(aes_impls) / sizeof(aes_impls[0]); ++i) {
+            hmac_bench_aes a;
+            if (!AES_impl_available(aes_impls[i]) || AES_set_impl(aes_impls[i]) != CRYPTO_SUCCESS) continue;
+            if (AES_set_key(&a.ctx, aes_key, aes_bits[k]) != CRYPTO_SUCCESS) continue;
+            memset(a.nonce_counter, 0, sizeof(a.nonce_counter));
+            hmac_report_bench(rep, aes_names[k], AES_impl_name(aes_impls[i]), hmac_bench_aes_ctr, &a,
+                buf, HMAC_REPORT_BENCH_BUF, HMAC_REPORT_BENCH_BUF);
+        }
+    }
+    AES_set_impl(prev_aes);
+
+    free(buf);
+}
+
+int hmac_sha512_run_report(HMAC_SHA512_Report* rep)
+{
+    uint8_t key[131], data[152], mac[SHA512_DIGEST_SIZE];
+    if (!rep) return 0;
+    memset(rep, 0, sizeof(*rep));
+    rep->total = 7;
+
+    for (int c = 0; c < 7; ++c) {
+        const hmac_rfc4231_case* tc = &rfc4231_cases[c];
+        HMAC_SHA512_Case* rc = &rep->cases[c];
+        uint64_t start;
+
+        hmac_report_fill(key, tc->key_str, tc->key_fill, tc->key_len);
+        hmac_report_fill(data, tc->data_str, tc->data_fill, tc->data_len);
+
+        rc->id = c + 1;
+        rc->pass = 1;
+        start = platform_time_ns();
+        for (unsigned int r = 0; r < HMAC_SHA512_REPORT_CASE_REPS; ++r) {
+            hmac_sha512(key, tc->key_len, data, tc->data_len, mac);
+            if (memcmp(mac, rfc4231_mac[c], tc->mac_len) != 0) rc->pass = 0;
+        }
+        rc->ms = (double)(platform_time_ns() - start) / 1e6;
+
+        rep->passed += rc->pass;
+        rep->ms_total += rc->ms;
+    }
+
+    hmac_report_benchmarks(rep);
+    return rep->passed == rep->total;
+}
+
+int hmac_sha512_write_json(const HMAC_SHA512_Report* rep, const char* path)
+{
+    FILE* f;
+    int ok;
+    if (!rep || !path) return 0;
+
+    /* "wb": 플랫폼과 상관없이 같은 바이트 (줄바꿈 변환 없음) */
+    f = platform_fopen(path, "wb");
+    if (!f) return 0;
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"format\": 1,\n");
+    fprintf(f, "  \"hmac_sha512_rfc4231\": {\n");
+    fprintf(f, "    \"total\": %d,\n", rep->total);
+    fprintf(f, "    \"passed\": %d,\n", rep->passed);
+    fprintf(f, "    \"reps\": %u,\n", HMAC_SHA512_REPORT_CASE_REPS);
+    fprintf(f, "    \"ms_total\": %.3f,\n", rep->ms_total);
+    fprintf(f, "    \"cases\": [\n");
+    for (int c = 0; c < 7; ++c) {
+        fprintf(f, "      { \"id\": %d, \"pass\": %s, \"ms\": %.3f }%s\n",
+            rep->cases[c].id, rep->cases[c].pass ? "true" : "false", rep->cases[c].ms, c < 6 ? "," : "");
+    }
+    fprintf(f, "    ]\n");
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"bench\": [\n");
+    for (int i = 0; i < rep->bench_count; ++i) {
+        const HMAC_SHA512_Bench* b = &rep->bench[i];
+        fprintf(f, "    { \"name\": \"%s\", \"impl\": \"%s\", \"bytes\": %llu, \"ms\": %.3f, "
+            "\"mb_per_s\": %.2f, \"cycles_per_byte\": %.2f }%s\n",
+            b->name, b->impl, (unsigned long long)b->bytes, b->ms, b->mb_per_s, b->cycles_per_byte,
+            i + 1 < rep->bench_count ? "," : "");
+    }
+    fprintf(f, "  ]\n");
+    fprintf(f, "}\n");
+
+    ok = !ferror(f);
+    if (fclose(f) != 0) ok = 0;
+    return ok;
+}
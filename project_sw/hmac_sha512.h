@@ -20,11 +20,11 @@ extern "C" {
 
     /* ---- 스트리밍 HMAC-SHA512 ---- */
     typedef struct {
-        uint8_t     o_key_pad[HMAC_SHA512_BLOCK_SIZE];
-        uint8_t     i_key_pad[HMAC_SHA512_BLOCK_SIZE];
+        SHA512_CTX  ikey;   /* ipad 블록을 압축한 직후의 inner 중간 상태 (reset용) */
         SHA512_CTX  ictx;   /* inner hash context  */
-        SHA512_CTX  octx;   /* outer hash context  */
-        int         initialized;
+        SHA512_CTX  octx;   /* outer hash context (opad 블록을 압축한 직후의 중간 상태) */
+        int         initialized;  /* update/final 가능 여부 */
+        int         keyed;        /* 중간 상태가 준비되어 있으면 1 (final 이후에도 유지) */
     } HMAC_SHA512_CTX;
 
     void hmac_sha512_init(HMAC_SHA512_CTX* ctx,
@@ -35,21 +35,55 @@ extern "C" {
 
     void hmac_sha512_final(HMAC_SHA512_CTX* ctx, uint8_t* mac_out);
 
+    /* ---- 키 재사용 ----
+     * init 때 계산한 inner/outer 중간 상태를 보관하므로, 같은 키로 여러 메시지를 MAC할 때
+     * 키 패드 블록 두 개를 다시 압축하지 않습니다. 반환값: 1 = 성공, 0 = 실패 */
+    int hmac_sha512_reset(HMAC_SHA512_CTX* ctx);   /* 같은 키로 새 메시지 시작 (final 이후에도 가능) */
+    int hmac_sha512_clone(HMAC_SHA512_CTX* dst, const HMAC_SHA512_CTX* src); /* 진행 중인 상태까지 복사 */
+    void hmac_sha512_wipe(HMAC_SHA512_CTX* ctx);   /* 키에서 유도된 상태를 모두 지움 */
+
+    /* 중간 상태 내보내기/가져오기: inner 8워드 + outer 8워드 (big-endian, 128바이트)
+     * 키 원문 없이 같은 키의 컨텍스트를 다시 만들 수 있으므로 키와 같은 수준으로 보호해야 함 */
+#define HMAC_SHA512_MIDSTATE_SIZE 128u
+    int hmac_sha512_export_midstate(const HMAC_SHA512_CTX* ctx, uint8_t out[HMAC_SHA512_MIDSTATE_SIZE]);
+    int hmac_sha512_import_midstate(HMAC_SHA512_CTX* ctx, const uint8_t in[HMAC_SHA512_MIDSTATE_SIZE]);
+
     /* 리포트 타입 */
+#define HMAC_SHA512_REPORT_CASE_REPS 1000u   /* 케이스마다 시간을 재는 반복 횟수 */
+
     typedef struct {
         int   id;        /* 1..7 */
         int   pass;      /* 1 or 0 */
-        double ms;       /* elapsed milliseconds */
+        double ms;       /* elapsed milliseconds (HMAC_SHA512_REPORT_CASE_REPS회 반복) */
     } HMAC_SHA512_Case;
 
+    /* 처리량 측정 항목: SHA-512 / HMAC-SHA512 / PBKDF2-SHA512 / AES-128,192,256-CTR,
+     * 이 CPU에서 사용 가능한 구현(백엔드)마다 하나씩 */
+#define HMAC_SHA512_REPORT_MAX_BENCH 32
+
+    typedef struct {
+        const char* name;        /* "sha512", "hmac-sha512", "pbkdf2-sha512", "aes-128-ctr", ... */
+        const char* impl;        /* sha512_impl_name / AES_impl_name */
+        uint64_t bytes;          /* 처리한 바이트 수 (PBKDF2는 압축한 SHA-512 블록의 바이트 수) */
+        double ms;               /* elapsed milliseconds */
+        double mb_per_s;         /* 1 MB = 10^6 bytes */
+        double cycles_per_byte;  /* 타임스탬프 카운터 기준, 측정할 수 없으면 0 */
+    } HMAC_SHA512_Bench;
+
     typedef struct {
         int total;          /* 항상 7 */
         int passed;         /* 0..7 */
         double ms_total;    /* case ms 합 */
         HMAC_SHA512_Case cases[7];
+        int bench_count;    /* 0..HMAC_SHA512_REPORT_MAX_BENCH */
+        HMAC_SHA512_Bench bench[HMAC_SHA512_REPORT_MAX_BENCH];
     } HMAC_SHA512_Report;
 
-    /* ( 리포트 작성 API  */
+    /* 리포트 작성 API
+     * run_report: RFC 4231 케이스 7개 검증 + 시간 측정, 이어서 처리량 측정 (수 초 소요)
+     *             구현 선택(sha512_set_impl / AES_set_impl)은 측정 후 원래대로 돌려놓음
+     *             반환값: 7개 모두 통과하면 1, 아니면 0
+     * write_json: 키 순서와 항목 순서가 고정된 JSON으로 저장 (릴리스 간 diff용). 성공 1, 실패 0 */
     int hmac_sha512_run_report(HMAC_SHA512_Report* rep);
     int hmac_sha512_write_json(const HMAC_SHA512_Report* rep, const char* path);
 
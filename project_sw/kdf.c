@@ -1,11 +1,52 @@
 #include "kdf.h"
 #include "sha512.h"
 #include "hmac_sha512.h"
+#include "platform_utils.h"  // 일괄 처리용 작업자 스레드, 캐시용 뮤텍스/메모리 잠금
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+// 기본 솔트 (salt가 NULL이거나 길이가 0인 경우)
+static const uint8_t default_salt[] = { 0x41, 0x45, 0x53, 0x43 }; // "AESC"
+
+// 해시 상태 8워드를 big-endian 64바이트로 기록
+static void store_be64x8(uint8_t* out, const uint64_t state[8]) {
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            out[i * 8 + j] = (uint8_t)(state[i] >> (56 - 8 * j));
+        }
+    }
+}
+
+// U2 이후의 HMAC 입력은 항상 64바이트이므로 패딩까지 미리 깔아 둔 블록을 압축 한 번으로 처리
+// inner: ipad 블록(128) 뒤의 64바이트 U, outer: opad 블록(128) 뒤의 64바이트 inner 해시
+// 둘 다 메시지 길이 = (128 + 64) * 8 = 1536비트
+static void pbkdf2_pad_block(uint8_t block[128]) {
+    memset(block, 0, 128);
+    block[64] = 0x80;
+    block[126] = (uint8_t)(1536 >> 8);
+    block[127] = (uint8_t)(1536 & 0xff);
+}
+
+// U1 = HMAC-SHA512(password, salt || block_index) (block_index는 1부터, big-endian)
+static void pbkdf2_u1(HMAC_SHA512_CTX* hmac, const uint8_t* salt, size_t salt_len,
+                      size_t block_index, uint8_t u[64]) {
+    uint8_t index_be[4];
+    index_be[0] = (uint8_t)(block_index >> 24);
+    index_be[1] = (uint8_t)(block_index >> 16);
+    index_be[2] = (uint8_t)(block_index >> 8);
+    index_be[3] = (uint8_t)block_index;
+
+    hmac_sha512_reset(hmac);
+    hmac_sha512_update(hmac, salt, salt_len);
+    hmac_sha512_update(hmac, index_be, sizeof(index_be));
+    hmac_sha512_final(hmac, u);
+}
 
 /**
  * PBKDF2-SHA512 구현
  * RFC 2898 기반
+ * 패스워드 HMAC 키는 한 번만 설정하고, 반복 구간은 고정 길이(64바이트) 블록을 압축 함수에 직접 넣어 처리
  */
 void pbkdf2_sha512(const uint8_t* password, size_t password_len,
                    const uint8_t* salt, size_t salt_len,
@@ -16,50 +57,511 @@ void pbkdf2_sha512(const uint8_t* password, size_t password_len,
         return;
     }
 
-    // 기본 솔트 (salt가 NULL이거나 길이가 0인 경우)
-    uint8_t default_salt[] = { 0x41, 0x45, 0x53, 0x43 }; // "AESC"
     const uint8_t* actual_salt = salt;
     size_t actual_salt_len = salt_len;
-    
+
     if (!salt || salt_len == 0) {
         actual_salt = default_salt;
         actual_salt_len = sizeof(default_salt);
     }
 
+    // 패스워드로 HMAC 키를 한 번만 설정 (ipad/opad 중간 상태를 반복마다 재사용)
+    HMAC_SHA512_CTX hmac;
+    hmac_sha512_init(&hmac, password, password_len);
+
+    uint8_t u_block[128], inner_block[128];
+    pbkdf2_pad_block(u_block);
+    pbkdf2_pad_block(inner_block);
+
     // 필요한 블록 수 계산 (SHA512는 64바이트 출력)
     size_t blocks_needed = (output_len + 63) / 64;
-    
+
     for (size_t block = 0; block < blocks_needed; block++) {
-        // U1 = HMAC-SHA512(password, salt || block_index)
-        uint8_t salt_block[256]; // 충분한 크기
-        size_t salt_block_len = actual_salt_len + 4;
-        
-        memcpy(salt_block, actual_salt, actual_salt_len);
-        // Big-endian으로 블록 인덱스 추가
-        salt_block[actual_salt_len] = (uint8_t)((block + 1) >> 24);
-        salt_block[actual_salt_len + 1] = (uint8_t)((block + 1) >> 16);
-        salt_block[actual_salt_len + 2] = (uint8_t)((block + 1) >> 8);
-        salt_block[actual_salt_len + 3] = (uint8_t)(block + 1);
-        
-        // HMAC-SHA512 계산
-        uint8_t u[64];
-        hmac_sha512(password, password_len, salt_block, salt_block_len, u);
-        
+        // U1은 u_block 앞 64바이트에 저장
+        pbkdf2_u1(&hmac, actual_salt, actual_salt_len, block + 1, u_block);
+
         uint8_t t[64];
-        memcpy(t, u, 64);
-        
-        // U2, U3, ... U_iterations 계산 및 XOR
+        memcpy(t, u_block, 64);
+
+        // U2, U3, ... U_iterations 계산 및 XOR: 반복마다 압축 함수 2회
         for (uint32_t i = 1; i < iterations; i++) {
-            hmac_sha512(password, password_len, u, 64, u);
+            uint64_t state[8];
+
+            memcpy(state, hmac.ikey.state, sizeof(state));
+            sha512_compress(state, u_block, 1);
+            store_be64x8(inner_block, state);
+
+            memcpy(state, hmac.octx.state, sizeof(state));
+            sha512_compress(state, inner_block, 1);
+            store_be64x8(u_block, state);
+
             for (size_t j = 0; j < 64; j++) {
-                t[j] ^= u[j];
+                t[j] ^= u_block[j];
             }
         }
-        
+
         // 출력에 복사 (필요한 만큼만)
-        size_t copy_len = (output_len - block * 64 < 64) ? 
+        size_t copy_len = (output_len - block * 64 < 64) ?
                           (output_len - block * 64) : 64;
         memcpy(output + block * 64, t, copy_len);
+        memset(t, 0, sizeof(t));
+    }
+
+    // 패스워드에서 유도된 중간 상태와 U 값 정리
+    hmac_sha512_wipe(&hmac);
+    memset(u_block, 0, sizeof(u_block));
+    memset(inner_block, 0, sizeof(inner_block));
+}
+
+/**
+ * HKDF-SHA512 구현
+ * RFC 5869 기반: PRK = HMAC(salt, IKM), T(i) = HMAC(PRK, T(i-1) || info || i)
+ * 확장 단계는 PRK 키를 한 번만 설정하고 블록마다 hmac_sha512_reset으로 재사용
+ */
+CRYPTO_STATUS hkdf_sha512(const uint8_t* salt, size_t salt_len,
+                          const uint8_t* ikm, size_t ikm_len,
+                          const uint8_t* info, size_t info_len,
+                          uint8_t* output, size_t output_len)
+{
+    static const uint8_t zero_salt[SHA512_DIGEST_LENGTH] = { 0 };
+
+    if (!output || (!ikm && ikm_len > 0) || (!info && info_len > 0)) {
+        return CRYPTO_ERR_NULL_CONTEXT;
+    }
+    if (output_len == 0 || output_len > 255 * SHA512_DIGEST_LENGTH) {
+        return CRYPTO_ERR_INVALID_ARGUMENT;
+    }
+    // salt가 없으면 해시 길이만큼의 0 (RFC 5869 2.2)
+    if (!salt || salt_len == 0) {
+        salt = zero_salt;
+        salt_len = sizeof(zero_salt);
+    }
+
+    HMAC_SHA512_CTX hmac;
+    uint8_t prk[SHA512_DIGEST_LENGTH];
+    uint8_t t[SHA512_DIGEST_LENGTH];
+
+    // 추출
+    hmac_sha512_init(&hmac, salt, salt_len);
+    hmac_sha512_update(&hmac, ikm, ikm_len);
+    hmac_sha512_final(&hmac, prk);
+
+    // 확장
+    hmac_sha512_init(&hmac, prk, sizeof(prk));
+    for (size_t done = 0, block = 1; done < output_len; block++) {
+        uint8_t counter = (uint8_t)block;
+        hmac_sha512_reset(&hmac);
+        if (block > 1) {
+            hmac_sha512_update(&hmac, t, sizeof(t));
+        }
+        hmac_sha512_update(&hmac, info, info_len);
+        hmac_sha512_update(&hmac, &counter, 1);
+        hmac_sha512_final(&hmac, t);
+
+        size_t copy_len = (output_len - done < sizeof(t)) ? (output_len - done) : sizeof(t);
+        memcpy(output + done, t, copy_len);
+        done += copy_len;
+    }
+
+    hmac_sha512_wipe(&hmac);
+    memset(prk, 0, sizeof(prk));
+    memset(t, 0, sizeof(t));
+    return CRYPTO_SUCCESS;
+}
+
+/*****************************************************
+ * 반복 횟수 자동 보정
+ * 짧은 시험 계산으로 이 컴퓨터의 초당 반복 횟수를 재고 목표 시간에 맞는 반복 횟수를 고릅니다.
+ * 한 스레드의 CPU 시간만 필요하므로 clock()으로 잽니다 (다른 프로세스 부하의 영향을 덜 받음).
+ *****************************************************/
+#define KDF_CALIBRATE_SAMPLE_MS 20       // 한 번의 측정이 최소 이 시간은 걸리도록 반복 횟수를 늘림
+#define KDF_CALIBRATE_ROUNDS 3           // 측정 반복 (가장 빠른 값 사용)
+#define KDF_CALIBRATE_MAX_ITERATIONS 100000000u
+
+uint32_t pbkdf2_sha512_calibrate(uint32_t target_ms, uint32_t min_iterations)
+{
+    static const uint8_t password[] = "calibrate";
+    static const uint8_t salt[16] = { 0 };
+    uint8_t out[64];
+    uint32_t trial = 1000;
+    double best_rate = 0.0;  // 밀리초당 반복 횟수
+
+    for (int round = 0; round < KDF_CALIBRATE_ROUNDS; round++) {
+        double elapsed_ms;
+        for (;;) {
+            clock_t start = clock();
+            pbkdf2_sha512(password, sizeof(password) - 1, salt, sizeof(salt), trial, out, sizeof(out));
+            elapsed_ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+            if (elapsed_ms >= KDF_CALIBRATE_SAMPLE_MS || trial >= KDF_CALIBRATE_MAX_ITERATIONS / 2) break;
+            trial *= 2;
+        }
+        if (elapsed_ms <= 0.0) continue;
+        double rate = trial / elapsed_ms;
+        if (rate > best_rate) best_rate = rate;
+    }
+    memset(out, 0, sizeof(out));
+
+    double iterations = best_rate * target_ms;
+    if (iterations > KDF_CALIBRATE_MAX_ITERATIONS) iterations = KDF_CALIBRATE_MAX_ITERATIONS;
+
+    // 1000 단위로 내림 (헤더에 기록되는 값을 읽기 쉽게)
+    uint32_t result = (uint32_t)iterations / 1000 * 1000;
+    return (result < min_iterations) ? min_iterations : result;
+}
+
+/*****************************************************
+ * 일괄 PBKDF2 (여러 작업을 SIMD 레인 + 스레드로 처리)
+ * 작업마다 출력 블록(64바이트) 하나를 단위 작업(task)으로 나누고,
+ * 진행 중인 단위 작업들의 반복 한 단계를 sha512_mb_compress로 한꺼번에 압축합니다.
+ * 반복 횟수가 달라 먼저 끝난 단위 작업의 자리는 대기 중인 다음 작업으로 바로 채웁니다.
+ * 단위 작업 목록은 스레드 수만큼 연속 구간으로 나눠 각 스레드가 독립적으로 처리합니다.
+ *****************************************************/
+#define PBKDF2_BATCH_ACTIVE 32   // 한 스레드에서 동시에 진행하는 단위 작업 수 (레인 수보다 넉넉하게)
+#define PBKDF2_BATCH_MAX_THREADS 64
+
+typedef struct {
+    uint64_t istate[8];        // inner 중간 상태 (ipad 블록 압축 후)
+    uint64_t ostate[8];        // outer 중간 상태 (opad 블록 압축 후)
+    uint64_t work[8];          // 이번 단계에서 압축 중인 상태
+    uint8_t u_block[128];      // U_i + 고정 패딩
+    uint8_t inner_block[128];  // inner 해시 + 고정 패딩
+    uint8_t t[64];             // U_1 ^ U_2 ^ ... 누적
+    uint32_t remaining;        // 남은 반복 횟수 (U2 이후)
+    uint8_t* out;
+    size_t out_len;
+} PBKDF2_TASK;
+
+typedef struct {
+    PBKDF2_TASK* tasks;
+    size_t count;
+} PBKDF2_SLICE;
+
+// 단위 작업 하나의 U1과 중간 상태 준비
+static void pbkdf2_task_init(PBKDF2_TASK* task, HMAC_SHA512_CTX* hmac, const uint8_t* salt, size_t salt_len,
+                             uint32_t iterations, size_t block, uint8_t* out, size_t out_len) {
+    memcpy(task->istate, hmac->ikey.state, sizeof(task->istate));
+    memcpy(task->ostate, hmac->octx.state, sizeof(task->ostate));
+    pbkdf2_pad_block(task->u_block);
+    pbkdf2_pad_block(task->inner_block);
+    pbkdf2_u1(hmac, salt, salt_len, block + 1, task->u_block);
+    memcpy(task->t, task->u_block, 64);
+    task->remaining = (iterations > 1) ? iterations - 1 : 0;
+    task->out = out;
+    task->out_len = out_len;
+}
+
+static void pbkdf2_task_finish(PBKDF2_TASK* task) {
+    memcpy(task->out, task->t, task->out_len);
+    memset(task, 0, sizeof(*task));
+}
+
+static void pbkdf2_batch_worker(void* arg) {
+    PBKDF2_SLICE* slice = (PBKDF2_SLICE*)arg;
+    PBKDF2_TASK* active[PBKDF2_BATCH_ACTIVE];
+    uint64_t* states[PBKDF2_BATCH_ACTIVE];
+    const uint8_t* blocks[PBKDF2_BATCH_ACTIVE];
+    size_t next = 0, n = 0;
+
+    for (;;) {
+        // 빈 자리를 대기 중인 단위 작업으로 채움 (반복이 남지 않은 작업은 바로 완료)
+        while (n < PBKDF2_BATCH_ACTIVE && next < slice->count) {
+            PBKDF2_TASK* task = &slice->tasks[next++];
+            if (task->remaining == 0) pbkdf2_task_finish(task);
+            else active[n++] = task;
+        }
+        if (n == 0) break;
+
+        // inner: istate ← U_i 블록
+        for (size_t k = 0; k < n; k++) {
+            memcpy(active[k]->work, active[k]->istate, sizeof(active[k]->work));
+            states[k] = active[k]->work;
+            blocks[k] = active[k]->u_block;
+        }
+        sha512_mb_compress(states, blocks, n);
+
+        // outer: ostate ← inner 해시 블록
+        for (size_t k = 0; k < n; k++) {
+            store_be64x8(active[k]->inner_block, active[k]->work);
+            memcpy(active[k]->work, active[k]->ostate, sizeof(active[k]->work));
+            blocks[k] = active[k]->inner_block;
+        }
+        sha512_mb_compress(states, blocks, n);
+
+        // U_{i+1} 기록, 누적, 끝난 작업은 자리를 비움 (마지막 작업을 그 자리로 이동)
+        for (size_t k = 0; k < n;) {
+            PBKDF2_TASK* task = active[k];
+            store_be64x8(task->u_block, task->work);
+            for (size_t j = 0; j < 64; j++) task->t[j] ^= task->u_block[j];
+            if (--task->remaining == 0) {
+                pbkdf2_task_finish(task);
+                active[k] = active[--n];
+            } else {
+                k++;
+            }
+        }
+    }
+}
+
+CRYPTO_STATUS pbkdf2_sha512_batch(const PBKDF2_SHA512_JOB* jobs, size_t count, int threads)
+{
+    if (count == 0) return CRYPTO_SUCCESS;
+    if (!jobs) return CRYPTO_ERR_NULL_CONTEXT;
+    if (threads < 0) return CRYPTO_ERR_INVALID_ARGUMENT;
+
+    // 단위 작업 수 = 각 작업의 출력 블록 수 합 (pbkdf2_sha512가 무시하는 잘못된 작업은 건너뜀)
+    size_t task_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        const PBKDF2_SHA512_JOB* job = &jobs[i];
+        if (!job->password || !job->output || job->password_len == 0 || job->output_len == 0) continue;
+        task_count += (job->output_len + 63) / 64;
+    }
+    if (task_count == 0) return CRYPTO_SUCCESS;
+
+    PBKDF2_TASK* tasks = (PBKDF2_TASK*)malloc(task_count * sizeof(PBKDF2_TASK));
+    if (!tasks) return CRYPTO_ERR_INTERNAL_FAILURE;
+
+    // 작업마다 HMAC 키를 한 번 설정하고 출력 블록별 U1 계산
+    size_t t = 0;
+    for (size_t i = 0; i < count; i++) {
+        const PBKDF2_SHA512_JOB* job = &jobs[i];
+        if (!job->password || !job->output || job->password_len == 0 || job->output_len == 0) continue;
+
+        const uint8_t* salt = job->salt;
+        size_t salt_len = job->salt_len;
+        if (!salt || salt_len == 0) {
+            salt = default_salt;
+            salt_len = sizeof(default_salt);
+        }
+
+        HMAC_SHA512_CTX hmac;
+        hmac_sha512_init(&hmac, job->password, job->password_len);
+        for (size_t block = 0; block * 64 < job->output_len; block++) {
+            size_t out_len = (job->output_len - block * 64 < 64) ? job->output_len - block * 64 : 64;
+            pbkdf2_task_init(&tasks[t++], &hmac, salt, salt_len, job->iterations, block,
+                             job->output + block * 64, out_len);
+        }
+        hmac_sha512_wipe(&hmac);
+    }
+
+    // 스레드 수: 0 = CPU 코어 수. 단위 작업 수보다 많이 만들지 않음
+    if (threads == 0) threads = platform_cpu_count();
+    if (threads > PBKDF2_BATCH_MAX_THREADS) threads = PBKDF2_BATCH_MAX_THREADS;
+    if ((size_t)threads > task_count) threads = (int)task_count;
+    if (threads < 1) threads = 1;
+
+    PBKDF2_SLICE slices[PBKDF2_BATCH_MAX_THREADS];
+    platform_thread workers[PBKDF2_BATCH_MAX_THREADS];
+    int started[PBKDF2_BATCH_MAX_THREADS];
+    size_t share = (task_count + (size_t)threads - 1) / (size_t)threads;
+    int n = 0;
+    for (size_t pos = 0; pos < task_count; pos += share, n++) {
+        slices[n].tasks = tasks + pos;
+        slices[n].count = (task_count - pos < share) ? task_count - pos : share;
+    }
+
+    // 첫 구간은 호출한 스레드가 직접 처리. 스레드 생성에 실패한 구간도 여기서 처리
+    for (int i = 1; i < n; i++) started[i] = platform_thread_start(&workers[i], pbkdf2_batch_worker, &slices[i]);
+    pbkdf2_batch_worker(&slices[0]);
+    for (int i = 1; i < n; i++) {
+        if (started[i]) platform_thread_join(&workers[i]);
+        else pbkdf2_batch_worker(&slices[i]);
+    }
+
+    // 단위 작업은 끝날 때 각자 지워졌음
+    free(tasks);
+    return CRYPTO_SUCCESS;
+}
+
+/*****************************************************
+ * 키 도출 캐시
+ * 같은 패스워드/솔트/반복 횟수로 여러 파일을 처리할 때 PBKDF2를 한 번만 수행하도록
+ * 도출 결과를 TTL 동안 프로세스 메모리에 보관합니다.
+ * * 캐시 메모리는 스왑되지 않도록 잠그며, 잠글 수 없으면 캐시를 사용하지 않습니다.
+ * * 항목은 입력 조합의 HMAC 태그(프로세스마다 새로 만든 비밀 키 사용)로 찾으므로 패스워드 원문은 남지 않습니다.
+ * * 만료된 항목은 조회할 때마다, 전체 항목은 kdf_cache_wipe와 프로그램 종료 시 지웁니다.
+ *****************************************************/
+#define KDF_CACHE_ENTRIES 16
+#define KDF_CACHE_MAX_OUTPUT 64
+
+typedef struct {
+    uint8_t tag[HMAC_SHA512_DIGEST_SIZE];  // HMAC(secret, password || salt || iterations || output_len)
+    uint8_t key[KDF_CACHE_MAX_OUTPUT];     // 도출 결과
+    size_t key_len;
+    time_t created;
+    int used;
+} KDF_CACHE_ENTRY;
+
+typedef struct {
+    KDF_CACHE_ENTRY entries[KDF_CACHE_ENTRIES];
+    uint8_t secret[64];                    // 태그용 프로세스별 비밀 키
+} KDF_CACHE;
+
+static KDF_CACHE g_kdf_cache;
+static platform_mutex g_kdf_cache_lock = PLATFORM_MUTEX_INIT;
+static int g_kdf_cache_state = 0;          // 0 = 준비 전, 1 = 사용 가능, -1 = 사용 불가 (메모리 잠금 실패)
+static int g_kdf_cache_atexit = 0;
+static unsigned int g_kdf_cache_ttl = KDF_CACHE_DEFAULT_TTL;
+
+// 컴파일러가 지우지 못하도록 volatile 포인터로 0 채움
+static void kdf_wipe(void* p, size_t n) {
+    volatile uint8_t* v = (volatile uint8_t*)p;
+    while (n--) *v++ = 0;
+}
+
+static int kdf_tag_equal(const uint8_t* a, const uint8_t* b) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < HMAC_SHA512_DIGEST_SIZE; i++) diff |= (uint8_t)(a[i] ^ b[i]);
+    return diff == 0;
+}
+
+static int kdf_cache_expired(const KDF_CACHE_ENTRY* e, time_t now) {
+    // 시계가 뒤로 돌아간 경우도 만료로 처리
+    return now < e->created || (unsigned long long)(now - e->created) >= g_kdf_cache_ttl;
+}
+
+// 잠금을 잡은 상태에서 호출. 처음 사용할 때 메모리를 잠그고 비밀 키를 만듦
+static int kdf_cache_ready(void) {
+    if (g_kdf_cache_state != 0) return g_kdf_cache_state > 0;
+
+    if (!platform_mem_lock(&g_kdf_cache, sizeof(g_kdf_cache))) {
+        g_kdf_cache_state = -1;
+        return 0;
+    }
+    if (crypto_random_bytes(g_kdf_cache.secret, sizeof(g_kdf_cache.secret)) != CRYPTO_SUCCESS) {
+        // 난수원이 없는 빌드: 시간/주소/rand()를 해시해 프로세스마다 다른 값으로 대체
+        // (태그가 프로세스 밖에서 재사용 가능한 패스워드 해시가 되지 않게 하는 용도)
+        SHA512_CTX ctx;
+        struct { time_t t; clock_t c; const void* a; const void* b; int r; } seed;
+        seed.t = time(NULL);
+        seed.c = clock();
+        seed.a = &seed;
+        seed.b = &g_kdf_cache;
+        seed.r = rand();
+        sha512_init(&ctx);
+        sha512_update(&ctx, (const uint8_t*)&seed, sizeof(seed));
+        sha512_final(&ctx, g_kdf_cache.secret);
     }
+    if (!g_kdf_cache_atexit) {
+        atexit(kdf_cache_wipe);
+        g_kdf_cache_atexit = 1;
+    }
+    g_kdf_cache_state = 1;
+    return 1;
 }
 
+static void kdf_cache_tag(const uint8_t* password, size_t password_len,
+                          const uint8_t* salt, size_t salt_len,
+                          uint32_t iterations, size_t output_len, uint8_t tag[HMAC_SHA512_DIGEST_SIZE]) {
+    HMAC_SHA512_CTX hmac;
+    uint8_t lens[20];
+    // 가변 길이 필드 경계가 모호하지 않도록 길이를 함께 넣음
+    for (int i = 0; i < 8; i++) {
+        lens[i] = (uint8_t)((uint64_t)password_len >> (56 - 8 * i));
+        lens[8 + i] = (uint8_t)((uint64_t)salt_len >> (56 - 8 * i));
+    }
+    lens[16] = (uint8_t)(iterations >> 24);
+    lens[17] = (uint8_t)(iterations >> 16);
+    lens[18] = (uint8_t)(iterations >> 8);
+    lens[19] = (uint8_t)iterations;
+
+    hmac_sha512_init(&hmac, g_kdf_cache.secret, sizeof(g_kdf_cache.secret));
+    hmac_sha512_update(&hmac, lens, sizeof(lens));
+    hmac_sha512_update(&hmac, password, password_len);
+    hmac_sha512_update(&hmac, salt, salt_len);
+    hmac_sha512_update(&hmac, (const uint8_t*)&output_len, sizeof(output_len));
+    hmac_sha512_final(&hmac, tag);
+    hmac_sha512_wipe(&hmac);
+}
+
+void pbkdf2_sha512_cached(const uint8_t* password, size_t password_len,
+                          const uint8_t* salt, size_t salt_len,
+                          uint32_t iterations,
+                          uint8_t* output, size_t output_len)
+{
+    uint8_t tag[HMAC_SHA512_DIGEST_SIZE];
+
+    if (!password || !output || password_len == 0 || output_len == 0) {
+        return;
+    }
+    // 기본 솔트를 명시한 호출과 NULL 솔트 호출이 같은 항목을 쓰도록 정규화
+    if (!salt || salt_len == 0) {
+        salt = default_salt;
+        salt_len = sizeof(default_salt);
+    }
+
+    platform_mutex_lock(&g_kdf_cache_lock);
+    if (output_len > KDF_CACHE_MAX_OUTPUT || g_kdf_cache_ttl == 0 || !kdf_cache_ready()) {
+        platform_mutex_unlock(&g_kdf_cache_lock);
+        pbkdf2_sha512(password, password_len, salt, salt_len, iterations, output, output_len);
+        return;
+    }
+
+    kdf_cache_tag(password, password_len, salt, salt_len, iterations, output_len, tag);
+
+    // 만료 항목 정리 + 조회
+    time_t now = time(NULL);
+    for (int i = 0; i < KDF_CACHE_ENTRIES; i++) {
+        KDF_CACHE_ENTRY* e = &g_kdf_cache.entries[i];
+        if (!e->used) continue;
+        if (kdf_cache_expired(e, now)) {
+            kdf_wipe(e, sizeof(*e));
+            continue;
+        }
+        if (e->key_len == output_len && kdf_tag_equal(e->tag, tag)) {
+            memcpy(output, e->key, output_len);
+            platform_mutex_unlock(&g_kdf_cache_lock);
+            kdf_wipe(tag, sizeof(tag));
+            return;
+        }
+    }
+    platform_mutex_unlock(&g_kdf_cache_lock);
+
+    // 없으면 잠금 밖에서 계산 (다른 스레드의 조회를 막지 않음)
+    pbkdf2_sha512(password, password_len, salt, salt_len, iterations, output, output_len);
+
+    // 빈 자리, 없으면 가장 오래된 항목에 저장
+    platform_mutex_lock(&g_kdf_cache_lock);
+    if (g_kdf_cache_state > 0 && g_kdf_cache_ttl > 0) {
+        KDF_CACHE_ENTRY* slot = &g_kdf_cache.entries[0];
+        for (int i = 0; i < KDF_CACHE_ENTRIES; i++) {
+            KDF_CACHE_ENTRY* e = &g_kdf_cache.entries[i];
+            if (!e->used) { slot = e; break; }
+            if (e->created < slot->created) slot = e;
+        }
+        memcpy(slot->tag, tag, sizeof(tag));
+        memcpy(slot->key, output, output_len);
+        slot->key_len = output_len;
+        slot->created = now;
+        slot->used = 1;
+    }
+    platform_mutex_unlock(&g_kdf_cache_lock);
+    kdf_wipe(tag, sizeof(tag));
+}
+
+void kdf_cache_set_ttl(unsigned int seconds)
+{
+    platform_mutex_lock(&g_kdf_cache_lock);
+    g_kdf_cache_ttl = seconds;
+    platform_mutex_unlock(&g_kdf_cache_lock);
+    if (seconds == 0) kdf_cache_wipe();
+}
+
+void kdf_cache_wipe(void)
+{
+    platform_mutex_lock(&g_kdf_cache_lock);
+    kdf_wipe(g_kdf_cache.entries, sizeof(g_kdf_cache.entries));
+    platform_mutex_unlock(&g_kdf_cache_lock);
+}
+
+int kdf_cache_count(void)
+{
+    int count = 0;
+    time_t now = time(NULL);
+    platform_mutex_lock(&g_kdf_cache_lock);
+    for (int i = 0; i < KDF_CACHE_ENTRIES; i++) {
+        const KDF_CACHE_ENTRY* e = &g_kdf_cache.entries[i];
+        if (e->used && !kdf_cache_expired(e, now)) count++;
+    }
+    platform_mutex_unlock(&g_kdf_cache_lock);
+    return count;
+}
@@ -26,6 +26,88 @@ void pbkdf2_sha512(const uint8_t* password, size_t password_len,
                    uint32_t iterations,
                    uint8_t* output, size_t output_len);
 
+/**
+ * HKDF-SHA512 (RFC 5869) 키 도출 함수
+ * 이미 충분히 강한 키 자료(IKM)에서 용도(info)별로 독립된 하위 키를 빠르게 생성
+ * 
+ * @param salt 솔트 (NULL 또는 길이 0이면 64바이트 0)
+ * @param salt_len 솔트 길이
+ * @param ikm 입력 키 자료
+ * @param ikm_len 입력 키 자료 길이
+ * @param info 용도 구분 문자열 (NULL 가능)
+ * @param info_len info 길이
+ * @param output 출력 버퍼
+ * @param output_len 출력 길이 (바이트, 최대 255 * 64)
+ * @return 성공 시 CRYPTO_SUCCESS, output이 NULL이면 CRYPTO_ERR_NULL_CONTEXT,
+ *         output_len이 0이거나 너무 길면 CRYPTO_ERR_INVALID_ARGUMENT
+ */
+CRYPTO_STATUS hkdf_sha512(const uint8_t* salt, size_t salt_len,
+                          const uint8_t* ikm, size_t ikm_len,
+                          const uint8_t* info, size_t info_len,
+                          uint8_t* output, size_t output_len);
+
+/**
+ * 이 컴퓨터에서 pbkdf2_sha512 한 번이 target_ms 밀리초 정도 걸리는 반복 횟수를 측정
+ * 시험 계산을 몇 번 수행해 가장 빠른 측정값을 기준으로 하며, 결과는 1000 단위로 내림
+ * 
+ * @param target_ms 목표 소요 시간 (KDF_TARGET_INTERACTIVE_MS, KDF_TARGET_ARCHIVE_MS 등)
+ * @param min_iterations 결과의 하한 (측정이 느리게 나와도 이 값 미만으로는 내리지 않음)
+ * @return 선택한 반복 횟수
+ */
+uint32_t pbkdf2_sha512_calibrate(uint32_t target_ms, uint32_t min_iterations);
+
+#define KDF_DEFAULT_ITERATIONS 10000       // v1 파일과 보정하지 않은 경우의 반복 횟수
+#define KDF_TARGET_INTERACTIVE_MS 50       // 대화형 사용 (파일 하나를 열 때마다 기다리는 시간)
+#define KDF_TARGET_ARCHIVE_MS 1000         // 보관용 파일 (자주 열지 않으므로 더 강하게)
+
+/**
+ * 일괄 PBKDF2-SHA512 작업 하나 (인자는 pbkdf2_sha512와 같음)
+ */
+typedef struct {
+    const uint8_t* password;
+    size_t password_len;
+    const uint8_t* salt;      // NULL이면 기본 솔트 사용
+    size_t salt_len;
+    uint32_t iterations;
+    uint8_t* output;
+    size_t output_len;
+} PBKDF2_SHA512_JOB;
+
+/**
+ * 여러 PBKDF2-SHA512 계산을 한꺼번에 수행
+ * 작업들의 반복 단계를 다중 버퍼 SHA-512 레인(sha512_mb_*)에 나눠 넣고, 작업을 여러 스레드에 분배
+ * 각 작업의 출력은 pbkdf2_sha512를 따로 호출한 것과 같음
+ * 
+ * @param jobs 작업 배열
+ * @param count 작업 수
+ * @param threads 스레드 수 (0 = CPU 코어 수, 1 = 호출한 스레드에서만 처리)
+ * @return 성공 시 CRYPTO_SUCCESS, jobs가 NULL이면 CRYPTO_ERR_NULL_CONTEXT,
+ *         threads가 음수면 CRYPTO_ERR_INVALID_ARGUMENT, 메모리 할당 실패 시 CRYPTO_ERR_INTERNAL_FAILURE
+ */
+CRYPTO_STATUS pbkdf2_sha512_batch(const PBKDF2_SHA512_JOB* jobs, size_t count, int threads);
+
+/**
+ * 캐시를 거치는 PBKDF2-SHA512 (인자와 결과는 pbkdf2_sha512와 같음)
+ * 같은 (password, salt, iterations, output_len) 조합을 TTL 안에 다시 요청하면 저장된 결과를 돌려줌
+ * 캐시는 스왑되지 않도록 잠근 메모리에 두며, 패스워드 원문 대신 프로세스별 비밀 키로 만든 HMAC 태그로 찾음
+ * 출력이 64바이트보다 길거나 메모리를 잠글 수 없으면 캐시 없이 바로 계산
+ */
+void pbkdf2_sha512_cached(const uint8_t* password, size_t password_len,
+                          const uint8_t* salt, size_t salt_len,
+                          uint32_t iterations,
+                          uint8_t* output, size_t output_len);
+
+#define KDF_CACHE_DEFAULT_TTL 300  // 초
+
+// 캐시 항목 유효 시간 (초, 항목을 만든 시점부터). 0이면 캐시를 끄고 모든 항목을 지움
+void kdf_cache_set_ttl(unsigned int seconds);
+
+// 캐시된 키 자료를 모두 지움 (프로그램이 정상 종료할 때도 자동으로 호출됨)
+void kdf_cache_wipe(void);
+
+// 만료되지 않은 캐시 항목 수
+int kdf_cache_count(void);
+
 #ifdef __cplusplus
 }
 #endif
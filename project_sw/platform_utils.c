@@ -5,6 +5,7 @@
 
 #ifdef PLATFORM_WINDOWS
 #include <windows.h>
+#include <io.h>
 #ifndef CP_UTF8
 #define CP_UTF8 65001
 #endif
@@ -64,3 +65,442 @@ int platform_path_to_utf8(const char* input_path, char* output_path, size_t outp
 }
 #endif
 
+
+// Runtime CPU feature detection
+#ifdef PLATFORM_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+static void platform_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)subleaf);
+    regs[0] = (uint32_t)r[0]; regs[1] = (uint32_t)r[1];
+    regs[2] = (uint32_t)r[2]; regs[3] = (uint32_t)r[3];
+}
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+static void platform_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+}
+#endif
+
+// XCR0: which register states the OS saves on context switch
+static uint64_t platform_xgetbv(void) {
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+static uint32_t platform_detect_cpu(void) {
+    uint32_t regs[4];
+    uint32_t features = 0;
+
+    platform_cpuid(0, 0, regs);
+    if (regs[0] < 1) return 0;
+
+    platform_cpuid(1, 0, regs);
+    if (regs[2] & (1u << 9))  features |= PLATFORM_CPU_SSSE3;
+    if (regs[2] & (1u << 19)) features |= PLATFORM_CPU_SSE41;
+    if (regs[2] & (1u << 25)) features |= PLATFORM_CPU_AESNI;
+
+    // AVX/AVX-512 are only usable if the OS enabled XSAVE for their registers
+    int os_ymm = 0, os_zmm = 0;
+    if (regs[2] & (1u << 27)) {
+        uint64_t xcr0 = platform_xgetbv();
+        os_ymm = (xcr0 & 0x06) == 0x06;
+        os_zmm = os_ymm && (xcr0 & 0xe0) == 0xe0;
+    }
+
+    platform_cpuid(0, 0, regs);
+    if (regs[0] < 7) return features;
+    platform_cpuid(7, 0, regs);
+    if (os_ymm && (regs[1] & (1u << 5)))  features |= PLATFORM_CPU_AVX2;
+    if (regs[1] & (1u << 8))              features |= PLATFORM_CPU_BMI2;
+    if (os_zmm && (regs[1] & (1u << 16))) features |= PLATFORM_CPU_AVX512F;
+    if (os_zmm && (regs[1] & (1u << 30))) features |= PLATFORM_CPU_AVX512BW;
+    if (os_ymm && (regs[2] & (1u << 9)))  features |= PLATFORM_CPU_VAES;
+    return features;
+}
+#else
+static uint32_t platform_detect_cpu(void) {
+    return 0;
+}
+#endif
+
+uint32_t platform_cpu_features(void) {
+    // A single aligned 32-bit word: every thread computes the same value,
+    // so a concurrent first call at worst runs CPUID twice.
+    static volatile uint32_t cached = 0;
+    uint32_t features = cached;
+    if (features & PLATFORM_CPU_DETECTED) return features;
+
+    features = platform_detect_cpu() | PLATFORM_CPU_DETECTED;
+    cached = features;
+    return features;
+}
+
+uint64_t platform_cycle_counter(void) {
+#ifdef PLATFORM_X86
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+// Threads
+#ifdef PLATFORM_WINDOWS
+static DWORD WINAPI platform_thread_entry(LPVOID arg) {
+    platform_thread* thread = (platform_thread*)arg;
+    thread->fn(thread->arg);
+    return 0;
+}
+
+int platform_thread_start(platform_thread* thread, platform_thread_fn fn, void* arg) {
+    thread->fn = fn;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, platform_thread_entry, thread, 0, NULL);
+    return thread->handle != NULL;
+}
+
+void platform_thread_join(platform_thread* thread) {
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+
+int platform_cpu_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+void platform_mutex_init(platform_mutex* mutex) {
+    InitializeSRWLock(mutex);
+}
+
+void platform_mutex_destroy(platform_mutex* mutex) {
+    (void)mutex;  // SRW locks hold no resources
+}
+
+void platform_mutex_lock(platform_mutex* mutex) {
+    AcquireSRWLockExclusive(mutex);
+}
+
+void platform_mutex_unlock(platform_mutex* mutex) {
+    ReleaseSRWLockExclusive(mutex);
+}
+
+void platform_cond_init(platform_cond* cond) {
+    InitializeConditionVariable(cond);
+}
+
+void platform_cond_destroy(platform_cond* cond) {
+    (void)cond;  // condition variables hold no resources
+}
+
+void platform_cond_wait(platform_cond* cond, platform_mutex* mutex) {
+    SleepConditionVariableSRW(cond, mutex, INFINITE, 0);
+}
+
+void platform_cond_signal(platform_cond* cond) {
+    WakeConditionVariable(cond);
+}
+
+void platform_cond_broadcast(platform_cond* cond) {
+    WakeAllConditionVariable(cond);
+}
+
+int platform_mem_lock(void* addr, size_t len) {
+    return VirtualLock(addr, len) != 0;
+}
+
+void platform_mem_unlock(void* addr, size_t len) {
+    VirtualUnlock(addr, len);
+}
+
+// BCryptGenRandom is resolved at runtime so callers don't need to link bcrypt.lib
+typedef LONG (WINAPI *bcrypt_gen_random_fn)(void* alg, PUCHAR buf, ULONG len, ULONG flags);
+
+int platform_random_bytes(uint8_t* buf, size_t len) {
+    static bcrypt_gen_random_fn gen_random = NULL;
+    if (!gen_random) {
+        HMODULE bcrypt = LoadLibraryA("bcrypt.dll");
+        if (!bcrypt) return 0;
+        gen_random = (bcrypt_gen_random_fn)(void*)GetProcAddress(bcrypt, "BCryptGenRandom");
+        if (!gen_random) return 0;
+    }
+    while (len > 0) {
+        ULONG n = (len > 0x10000000) ? 0x10000000 : (ULONG)len;
+        if (gen_random(NULL, buf, n, 0x00000002 /* BCRYPT_USE_SYSTEM_PREFERRED_RNG */) != 0) return 0;
+        buf += n;
+        len -= n;
+    }
+    return 1;
+}
+
+int platform_fsync(FILE* file) {
+    if (fflush(file) != 0) return 0;
+    return _commit(_fileno(file)) == 0;
+}
+
+int platform_fseek64(FILE* file, int64_t offset, int origin) {
+    return _fseeki64(file, offset, origin);
+}
+
+int64_t platform_ftell64(FILE* file) {
+    return _ftelli64(file);
+}
+
+// OVERLAPPED with an explicit offset makes ReadFile/WriteFile positional on a synchronous handle
+int64_t platform_pread(FILE* file, void* buf, size_t len, int64_t offset) {
+    HANDLE handle = (HANDLE)_get_osfhandle(_fileno(file));
+    if (handle == INVALID_HANDLE_VALUE) return -1;
+    size_t total = 0;
+    while (total < len) {
+        OVERLAPPED ov;
+        memset(&ov, 0, sizeof(ov));
+        uint64_t pos = (uint64_t)offset + total;
+        ov.Offset = (DWORD)pos;
+        ov.OffsetHigh = (DWORD)(pos >> 32);
+        DWORD want = (len - total > 0x40000000) ? 0x40000000 : (DWORD)(len - total);
+        DWORD got = 0;
+        if (!ReadFile(handle, (uint8_t*)buf + total, want, &got, &ov)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) break;
+            return -1;
+        }
+        if (got == 0) break;
+        total += got;
+    }
+    return (int64_t)total;
+}
+
+int64_t platform_pwrite(FILE* file, const void* buf, size_t len, int64_t offset) {
+    HANDLE handle = (HANDLE)_get_osfhandle(_fileno(file));
+    if (handle == INVALID_HANDLE_VALUE) return -1;
+    size_t total = 0;
+    while (total < len) {
+        OVERLAPPED ov;
+        memset(&ov, 0, sizeof(ov));
+        uint64_t pos = (uint64_t)offset + total;
+        ov.Offset = (DWORD)pos;
+        ov.OffsetHigh = (DWORD)(pos >> 32);
+        DWORD want = (len - total > 0x40000000) ? 0x40000000 : (DWORD)(len - total);
+        DWORD put = 0;
+        if (!WriteFile(handle, (const uint8_t*)buf + total, want, &put, &ov) || put == 0) return -1;
+        total += put;
+    }
+    return (int64_t)total;
+}
+
+int platform_rename_replace(const char* from_path, const char* to_path) {
+    wchar_t wfrom[512];
+    wchar_t wto[512];
+    if (MultiByteToWideChar(CP_UTF8, 0, from_path, -1, wfrom, 512) == 0 ||
+        MultiByteToWideChar(CP_UTF8, 0, to_path, -1, wto, 512) == 0) {
+        return 0;
+    }
+    return MoveFileExW(wfrom, wto, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+int platform_remove(const char* path) {
+    wchar_t wpath[512];
+    if (MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, 512) == 0) return 0;
+    return _wremove(wpath) == 0;
+}
+
+uint64_t platform_time_ns(void) {
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)(now.QuadPart / freq.QuadPart) * 1000000000ull +
+           (uint64_t)(now.QuadPart % freq.QuadPart) * 1000000000ull / (uint64_t)freq.QuadPart;
+}
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <time.h>
+
+static void* platform_thread_entry(void* arg) {
+    platform_thread* thread = (platform_thread*)arg;
+    thread->fn(thread->arg);
+    return NULL;
+}
+
+int platform_thread_start(platform_thread* thread, platform_thread_fn fn, void* arg) {
+    thread->fn = fn;
+    thread->arg = arg;
+    return pthread_create(&thread->handle, NULL, platform_thread_entry, thread) == 0;
+}
+
+void platform_thread_join(platform_thread* thread) {
+    pthread_join(thread->handle, NULL);
+}
+
+int platform_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+void platform_mutex_init(platform_mutex* mutex) {
+    pthread_mutex_init(mutex, NULL);
+}
+
+void platform_mutex_destroy(platform_mutex* mutex) {
+    pthread_mutex_destroy(mutex);
+}
+
+void platform_mutex_lock(platform_mutex* mutex) {
+    pthread_mutex_lock(mutex);
+}
+
+void platform_mutex_unlock(platform_mutex* mutex) {
+    pthread_mutex_unlock(mutex);
+}
+
+void platform_cond_init(platform_cond* cond) {
+    pthread_cond_init(cond, NULL);
+}
+
+void platform_cond_destroy(platform_cond* cond) {
+    pthread_cond_destroy(cond);
+}
+
+void platform_cond_wait(platform_cond* cond, platform_mutex* mutex) {
+    pthread_cond_wait(cond, mutex);
+}
+
+void platform_cond_signal(platform_cond* cond) {
+    pthread_cond_signal(cond);
+}
+
+void platform_cond_broadcast(platform_cond* cond) {
+    pthread_cond_broadcast(cond);
+}
+
+int platform_mem_lock(void* addr, size_t len) {
+    return mlock(addr, len) == 0;
+}
+
+void platform_mem_unlock(void* addr, size_t len) {
+    munlock(addr, len);
+}
+
+#ifdef PLATFORM_MAC
+int platform_random_bytes(uint8_t* buf, size_t len) {
+    arc4random_buf(buf, len);
+    return 1;
+}
+#else
+int platform_random_bytes(uint8_t* buf, size_t len) {
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    size_t total = 0;
+    while (total < len) {
+        ssize_t got = read(fd, buf + total, len - total);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        total += (size_t)got;
+    }
+    close(fd);
+    return total == len;
+}
+#endif
+
+int platform_fsync(FILE* file) {
+    if (fflush(file) != 0) return 0;
+    return fsync(fileno(file)) == 0;
+}
+
+int platform_fseek64(FILE* file, int64_t offset, int origin) {
+    return fseeko(file, (off_t)offset, origin);
+}
+
+int64_t platform_ftell64(FILE* file) {
+    return (int64_t)ftello(file);
+}
+
+int64_t platform_pread(FILE* file, void* buf, size_t len, int64_t offset) {
+    int fd = fileno(file);
+    size_t total = 0;
+    while (total < len) {
+        ssize_t got = pread(fd, (uint8_t*)buf + total, len - total, (off_t)(offset + (int64_t)total));
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (got == 0) break;
+        total += (size_t)got;
+    }
+    return (int64_t)total;
+}
+
+int64_t platform_pwrite(FILE* file, const void* buf, size_t len, int64_t offset) {
+    int fd = fileno(file);
+    size_t total = 0;
+    while (total < len) {
+        ssize_t put = pwrite(fd, (const uint8_t*)buf + total, len - total, (off_t)(offset + (int64_t)total));
+        if (put < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (put == 0) return -1;
+        total += (size_t)put;
+    }
+    return (int64_t)total;
+}
+
+int platform_rename_replace(const char* from_path, const char* to_path) {
+    if (rename(from_path, to_path) != 0) return 0;
+
+    // Persist the directory entry as well (best effort: some filesystems refuse fsync on directories)
+    char dir[512];
+    const char* slash = strrchr(to_path, '/');
+    size_t len = slash ? (size_t)(slash - to_path) : 0;
+    if (len >= sizeof(dir)) return 1;
+    if (len == 0) {
+        strcpy(dir, slash ? "/" : ".");
+    } else {
+        memcpy(dir, to_path, len);
+        dir[len] = '\0';
+    }
+    int fd = open(dir, O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    return 1;
+}
+
+int platform_remove(const char* path) {
+    return remove(path) == 0;
+}
+
+uint64_t platform_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+// Temporary files
+FILE* platform_create_temp_beside(const char* target_path, char* temp_path, size_t temp_size) {
+    static unsigned int counter = 0;
+    for (int attempt = 0; attempt < 16; attempt++) {
+        // The name only needs to be unlikely to exist; "x" makes creation fail instead of reusing a file
+        uint64_t r = platform_time_ns() ^ ((uint64_t)(uintptr_t)temp_path << 16) ^
+                     (uint64_t)(++counter) * 0x9E3779B97F4A7C15ull;
+        int n = snprintf(temp_path, temp_size, "%s.%08x.tmp", target_path, (unsigned int)(r ^ (r >> 32)));
+        if (n < 0 || (size_t)n >= temp_size) return NULL;
+
+        FILE* file = platform_fopen(temp_path, "wbx");
+        if (file) return file;
+    }
+    return NULL;
+}
@@ -7,6 +7,7 @@ extern "C" {
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stddef.h>
 
 // Platform detection
 #ifdef _WIN32
@@ -26,6 +27,124 @@ extern "C" {
 FILE* platform_fopen(const char* path, const char* mode);
 int platform_path_to_utf8(const char* input_path, char* output_path, size_t output_size);
 
+// Architecture detection (x86/x64 only: SIMD backends are compiled out elsewhere, e.g. Apple Silicon)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define PLATFORM_X86 1
+#endif
+
+// Runtime CPU feature flags (returned by platform_cpu_features)
+#define PLATFORM_CPU_DETECTED 0x80000000u  // internal: detection already ran
+#define PLATFORM_CPU_SSSE3    0x00000001u
+#define PLATFORM_CPU_SSE41    0x00000002u
+#define PLATFORM_CPU_AESNI    0x00000004u
+#define PLATFORM_CPU_AVX2     0x00000008u  // includes OS support for YMM state
+#define PLATFORM_CPU_AVX512F  0x00000010u  // includes OS support for ZMM/opmask state
+#define PLATFORM_CPU_AVX512BW 0x00000020u
+#define PLATFORM_CPU_VAES     0x00000040u
+#define PLATFORM_CPU_BMI2     0x00000080u
+
+// Detects CPU features once (CPUID) and caches the result
+uint32_t platform_cpu_features(void);
+
+// Minimal threads (Win32 threads / pthreads)
+#ifndef PLATFORM_WINDOWS
+#include <pthread.h>
+#endif
+
+typedef void (*platform_thread_fn)(void* arg);
+
+// Caller-owned; must stay alive until platform_thread_join returns
+typedef struct {
+#ifdef PLATFORM_WINDOWS
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    platform_thread_fn fn;
+    void* arg;
+} platform_thread;
+
+// Starts fn(arg) on a new thread. Returns 1 on success, 0 if the thread could not be created
+int platform_thread_start(platform_thread* thread, platform_thread_fn fn, void* arg);
+void platform_thread_join(platform_thread* thread);
+
+// Number of online logical CPUs (at least 1)
+int platform_cpu_count(void);
+
+// Minimal mutex that can be statically initialised with PLATFORM_MUTEX_INIT (SRW lock / pthread mutex)
+#ifdef PLATFORM_WINDOWS
+typedef SRWLOCK platform_mutex;
+#define PLATFORM_MUTEX_INIT SRWLOCK_INIT
+#else
+typedef pthread_mutex_t platform_mutex;
+#define PLATFORM_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+#endif
+
+// For a mutex inside another object (PLATFORM_MUTEX_INIT only works as a static initialiser).
+// Destroy it once no thread uses it; copying an initialised mutex is not allowed
+void platform_mutex_init(platform_mutex* mutex);
+void platform_mutex_destroy(platform_mutex* mutex);
+void platform_mutex_lock(platform_mutex* mutex);
+void platform_mutex_unlock(platform_mutex* mutex);
+
+// Condition variable paired with a platform_mutex (CONDITION_VARIABLE / pthread condvar)
+#ifdef PLATFORM_WINDOWS
+typedef CONDITION_VARIABLE platform_cond;
+#else
+typedef pthread_cond_t platform_cond;
+#endif
+
+void platform_cond_init(platform_cond* cond);
+void platform_cond_destroy(platform_cond* cond);
+// Releases mutex (held by the caller) while waiting and holds it again on return.
+// Wake-ups may be spurious, so wait in a loop that re-checks the condition
+void platform_cond_wait(platform_cond* cond, platform_mutex* mutex);
+void platform_cond_signal(platform_cond* cond);
+void platform_cond_broadcast(platform_cond* cond);
+
+// 64-bit fseek/ftell (_fseeki64 / fseeko): long is 32 bits on Windows, too small for large files.
+// platform_fseek64 returns 0 on success like fseek
+int platform_fseek64(FILE* file, int64_t offset, int origin);
+int64_t platform_ftell64(FILE* file);
+
+// Positional read/write on the FILE's descriptor (pread/pwrite; ReadFile/WriteFile with an OVERLAPPED offset on Windows).
+// The file position is not used, so several threads may call these on the same FILE at once.
+// They bypass stdio buffering: fflush before mixing with fwrite. Return bytes transferred
+// (a read is short only at end of file), or -1 on error
+int64_t platform_pread(FILE* file, void* buf, size_t len, int64_t offset);
+int64_t platform_pwrite(FILE* file, const void* buf, size_t len, int64_t offset);
+
+// Flushes stdio buffers and forces the file's data to disk (fsync / _commit). Returns 1 on success
+int platform_fsync(FILE* file);
+
+// Atomically replaces to_path with from_path (rename / MoveFileEx); both must be on the same volume.
+// On POSIX the containing directory is synced too so the new entry survives a crash. Returns 1 on success
+int platform_rename_replace(const char* from_path, const char* to_path);
+
+// Deletes a file given as a UTF-8 path. Returns 1 on success
+int platform_remove(const char* path);
+
+// Creates and exclusively opens ("wbx") a new file named "<target_path>.<random>.tmp" in the same
+// directory as target_path, so it can later be renamed over it. The chosen name is written to temp_path.
+// Returns NULL if no file could be created
+FILE* platform_create_temp_beside(const char* target_path, char* temp_path, size_t temp_size);
+
+// Monotonic wall-clock time in nanoseconds (QueryPerformanceCounter / CLOCK_MONOTONIC)
+uint64_t platform_time_ns(void);
+
+// CPU timestamp counter (RDTSC) for cycles-per-byte estimates; 0 on non-x86.
+// Ticks at the constant nominal frequency on modern CPUs, not the current core clock
+uint64_t platform_cycle_counter(void);
+
+// Keeps the pages covering [addr, addr + len) out of swap (VirtualLock / mlock).
+// Returns 1 on success, 0 if the OS refused (e.g. locked-memory limit reached)
+int platform_mem_lock(void* addr, size_t len);
+void platform_mem_unlock(void* addr, size_t len);
+
+// Fills buf with bytes from the OS CSPRNG (BCryptGenRandom / arc4random_buf / /dev/urandom).
+// Returns 1 on success, 0 if no secure source is available
+int platform_random_bytes(uint8_t* buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
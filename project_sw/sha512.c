@@ -8,6 +8,18 @@
 #include <stddef.h>
 #include "crypto_api.h"
 #include "sha512.h"
+#include "platform_utils.h"  // PLATFORM_X86, 런타임 CPU 기능 감지
+
+// x86에서는 AVX2 + BMI2 압축 함수를 함께 빌드 (실제 사용 여부는 런타임에 CPUID로 결정)
+#ifdef PLATFORM_X86
+#define SHA512_HAVE_AVX2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define SHA512_TARGET(features)   // MSVC는 별도 컴파일 옵션 없이 intrinsic 사용 가능
+#else
+#define SHA512_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
 
 #define SHA512_BLOCK_SIZE 128 // 128 바이트 = 1024비트
 #define SHA512_DIGEST_LENGTH 64
@@ -43,71 +55,241 @@ static const uint64_t K[80] = {
 #define SIG0(x) (ROTR(x,1)^ROTR(x,8)^((x)>>7))
 #define SIG1(x) (ROTR(x,19)^ROTR(x,61)^((x)>>6))
 
-static void transform(SHA512_CTX* ctx, const uint8_t data[SHA512_BLOCK_SIZE]) {
-    uint64_t W[80];
-    register uint64_t a, b, c, d, e, f, g, h;
-    register uint64_t t1, t2;
-
-    // --- 1. 초기 16개 워드 (Big-endian → uint64_t 변환)
-    const uint64_t* p = (const uint64_t*)data;
-#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-    for (int i = 0; i < 16; i++) {
-        uint64_t v = p[i];
-        W[i] = ((v & 0x00000000000000FF) << 56) |
-            ((v & 0x000000000000FF00) << 40) |
-            ((v & 0x0000000000FF0000) << 24) |
-            ((v & 0x00000000FF000000) << 8) |
-            ((v & 0x000000FF00000000) >> 8) |
-            ((v & 0x0000FF0000000000) >> 24) |
-            ((v & 0x00FF000000000000) >> 40) |
-            ((v & 0xFF00000000000000) >> 56);
+// 64비트 big-endian 로드: memcpy로 읽어 정렬/strict-aliasing 문제가 없고, 컴파일러가 한 번의 로드로 바꿔 줌
+#if defined(_MSC_VER)
+#define SHA512_BSWAP64(x) _byteswap_uint64(x)
+#define SHA512_LITTLE_ENDIAN 1
+#elif defined(__GNUC__) || defined(__clang__)
+#define SHA512_BSWAP64(x) __builtin_bswap64(x)
+#define SHA512_LITTLE_ENDIAN (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#endif
+
+static inline uint64_t load_be64(const uint8_t* p) {
+#ifdef SHA512_BSWAP64
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if SHA512_LITTLE_ENDIAN
+    v = SHA512_BSWAP64(v);
+#endif
+    return v;
+#else
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+           ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+#endif
+}
+
+// 한 라운드: d와 h만 갱신하고, 나머지 상태는 호출할 때마다 변수 이름을 한 칸씩 돌려서 전달 (복사 없음)
+// K+W는 e에 의존하지 않으므로 먼저 h에 더해 두어 임계 경로에서 뺌. Ch/Maj는 연산 수가 적은 형태 사용
+#define SHA512_SCALAR_RND(a, b, c, d, e, f, g, h, k, w) do { \
+        (h) += (k) + (w); \
+        (h) += EP1(e) + ((((f) ^ (g)) & (e)) ^ (g)); \
+        (d) += (h); \
+        (h) += EP0(a) + ((((a) | (b)) & (c)) | ((a) & (b))); \
+    } while (0)
+
+// 메시지 스케줄: 최근 16워드만 원형 버퍼로 유지 (W[t]가 W[t-16] 자리를 덮어씀)
+#define SHA512_W_LOADED(i) W[i]
+#define SHA512_W_NEXT(i) (W[i] += SIG1(W[((i) + 14) & 15]) + W[((i) + 9) & 15] + SIG0(W[((i) + 1) & 15]))
+
+// 16라운드 (t = 라운드 시작 번호, WX = 워드를 구하는 방법). 8라운드마다 이름이 제자리로 돌아옴
+#define SHA512_SCALAR_RND16(t, WX) do { \
+        SHA512_SCALAR_RND(a, b, c, d, e, f, g, h, K[(t) + 0], WX(0)); \
+        SHA512_SCALAR_RND(h, a, b, c, d, e, f, g, K[(t) + 1], WX(1)); \
+        SHA512_SCALAR_RND(g, h, a, b, c, d, e, f, K[(t) + 2], WX(2)); \
+        SHA512_SCALAR_RND(f, g, h, a, b, c, d, e, K[(t) + 3], WX(3)); \
+        SHA512_SCALAR_RND(e, f, g, h, a, b, c, d, K[(t) + 4], WX(4)); \
+        SHA512_SCALAR_RND(d, e, f, g, h, a, b, c, K[(t) + 5], WX(5)); \
+        SHA512_SCALAR_RND(c, d, e, f, g, h, a, b, K[(t) + 6], WX(6)); \
+        SHA512_SCALAR_RND(b, c, d, e, f, g, h, a, K[(t) + 7], WX(7)); \
+        SHA512_SCALAR_RND(a, b, c, d, e, f, g, h, K[(t) + 8], WX(8)); \
+        SHA512_SCALAR_RND(h, a, b, c, d, e, f, g, K[(t) + 9], WX(9)); \
+        SHA512_SCALAR_RND(g, h, a, b, c, d, e, f, K[(t) + 10], WX(10)); \
+        SHA512_SCALAR_RND(f, g, h, a, b, c, d, e, K[(t) + 11], WX(11)); \
+        SHA512_SCALAR_RND(e, f, g, h, a, b, c, d, K[(t) + 12], WX(12)); \
+        SHA512_SCALAR_RND(d, e, f, g, h, a, b, c, K[(t) + 13], WX(13)); \
+        SHA512_SCALAR_RND(c, d, e, f, g, h, a, b, K[(t) + 14], WX(14)); \
+        SHA512_SCALAR_RND(b, c, d, e, f, g, h, a, K[(t) + 15], WX(15)); \
+    } while (0)
+
+// 포터블 스칼라 압축 함수 (SIMD가 없는 환경의 기본 경로). 연속된 blocks개 블록을 처리
+static void transform(uint64_t state[8], const uint8_t* data, size_t blocks) {
+    uint64_t W[16];
+    uint64_t a, b, c, d, e, f, g, h;
+
+    for (; blocks > 0; blocks--, data += SHA512_BLOCK_SIZE) {
+        // --- 1. 초기 16개 워드 (Big-endian → uint64_t 변환)
+        for (int i = 0; i < 16; i++) W[i] = load_be64(data + 8 * i);
+
+        // --- 2. 초기 해시 상태 로드
+        a = state[0]; b = state[1]; c = state[2]; d = state[3];
+        e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+        // --- 3. 메인 압축 루프 (80라운드): 0~15는 입력 워드, 16~79는 스케줄을 라운드마다 계산
+        SHA512_SCALAR_RND16(0, SHA512_W_LOADED);
+        for (int t = 16; t < 80; t += 16) SHA512_SCALAR_RND16(t, SHA512_W_NEXT);
+
+        // --- 4. 중간 해시 상태 업데이트
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
     }
+    memset(W, 0, sizeof(W));
+}
+
+/*****************************************************
+ * AVX2 + BMI2 압축 함수
+ * * 메시지 스케줄 W[16..79]를 256비트 레지스터로 4워드씩 계산하고 K를 미리 더해 둡니다 (W+K).
+ *   W[t]의 σ1 항은 W[t-2], W[t-1]에 의존하므로, 4워드 중 앞 2워드를 먼저 구한 뒤 그 값으로 뒤 2워드를 구합니다.
+ * * 라운드는 스칼라로 수행하되 BMI2 RORX(플래그를 건드리지 않는 3-피연산자 회전)로 컴파일되며,
+ *   레지스터 이름을 돌려 가며 8라운드를 펼쳐 상태 변수 간 복사를 없앴습니다.
+ * * 스케줄 계산(벡터 유닛)을 라운드(정수 유닛) 사이에 끼워 넣어 두 유닛이 동시에 일하도록 합니다.
+ * * 여러 블록을 연속 처리하는 동안 상태는 레지스터에 유지합니다.
+ *****************************************************/
+#ifdef SHA512_HAVE_AVX2
+
+#define SHA512_ROR256(x, n) _mm256_or_si256(_mm256_srli_epi64((x), (n)), _mm256_slli_epi64((x), 64 - (n)))
+
+SHA512_TARGET("avx2,bmi2")
+static __m256i sha512_sig0_avx2(__m256i x) {
+    return _mm256_xor_si256(_mm256_xor_si256(SHA512_ROR256(x, 1), SHA512_ROR256(x, 8)), _mm256_srli_epi64(x, 7));
+}
+
+SHA512_TARGET("avx2,bmi2")
+static __m256i sha512_sig1_avx2(__m256i x) {
+    return _mm256_xor_si256(_mm256_xor_si256(SHA512_ROR256(x, 19), SHA512_ROR256(x, 61)), _mm256_srli_epi64(x, 6));
+}
+
+// W[t..t+3] 계산. x0 = W[t-16..t-13], x1 = W[t-12..t-9], x2 = W[t-8..t-5], x3 = W[t-4..t-1]
+SHA512_TARGET("avx2,bmi2")
+static inline __m256i sha512_schedule4_avx2(__m256i x0, __m256i x1, __m256i x2, __m256i x3) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i w15 = _mm256_permute4x64_epi64(_mm256_blend_epi32(x0, x1, 0x03), 0x39); // W[t-15..t-12]
+    __m256i w7 = _mm256_permute4x64_epi64(_mm256_blend_epi32(x2, x3, 0x03), 0x39);  // W[t-7..t-4]
+    __m256i w = _mm256_add_epi64(_mm256_add_epi64(x0, w7), sha512_sig0_avx2(w15));
+
+    __m256i s1 = sha512_sig1_avx2(_mm256_permute4x64_epi64(x3, 0xEE)); // σ1(W[t-2]), σ1(W[t-1])
+    w = _mm256_add_epi64(w, _mm256_blend_epi32(s1, zero, 0xF0));        // W[t], W[t+1] 완성
+    s1 = sha512_sig1_avx2(_mm256_permute4x64_epi64(w, 0x44));           // σ1(W[t]), σ1(W[t+1])
+    return _mm256_add_epi64(w, _mm256_blend_epi32(zero, s1, 0xF0));     // W[t+2], W[t+3] 완성
+}
+
+// 한 라운드 (h, d만 갱신되고 나머지는 호출마다 이름을 돌려서 전달)
+// Maj(a,b,c) = ((a^b) & (b^c)) ^ b: 이번 라운드의 a^b(ab)가 다음 라운드의 b^c(bc)가 되므로 재사용
+#define SHA512_RND(a, b, c, d, e, f, g, h, wk, ab, bc) do { \
+        h += (wk) + EP1(e) + ((((f) ^ (g)) & (e)) ^ (g)); \
+        ab = (a) ^ (b); \
+        d += h; \
+        h += EP0(a) + (((ab) & (bc)) ^ (b)); \
+    } while (0)
+
+#define SHA512_RND8(wk) do { \
+        SHA512_RND(a, b, c, d, e, f, g, h, (wk)[0], m0, m1); SHA512_RND(h, a, b, c, d, e, f, g, (wk)[1], m1, m0); \
+        SHA512_RND(g, h, a, b, c, d, e, f, (wk)[2], m0, m1); SHA512_RND(f, g, h, a, b, c, d, e, (wk)[3], m1, m0); \
+        SHA512_RND(e, f, g, h, a, b, c, d, (wk)[4], m0, m1); SHA512_RND(d, e, f, g, h, a, b, c, (wk)[5], m1, m0); \
+        SHA512_RND(c, d, e, f, g, h, a, b, (wk)[6], m0, m1); SHA512_RND(b, c, d, e, f, g, h, a, (wk)[7], m1, m0); \
+    } while (0)
+
+SHA512_TARGET("avx2,bmi2")
+static void transform_avx2(uint64_t state[8], const uint8_t* data, size_t blocks) {
+    // 64비트 워드 단위 바이트 반전 (big-endian 로드)
+    const __m256i bswap = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+                                          8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    uint64_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint64_t e = state[4], f = state[5], g = state[6], h = state[7];
+#ifdef _MSC_VER
+    __declspec(align(32)) uint64_t wk[80];
 #else
-    memcpy(W, data, 128);
+    uint64_t wk[80] __attribute__((aligned(32)));
+#endif
+
+    for (; blocks > 0; blocks--, data += SHA512_BLOCK_SIZE) {
+        uint64_t m0, m1 = b ^ c; // Maj 재사용 값 (첫 라운드의 b^c)
+        __m256i x[4];
+        for (int i = 0; i < 4; i++) {
+            x[i] = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(data + i * 32)), bswap);
+            _mm256_store_si256((__m256i*)(wk + i * 4), _mm256_add_epi64(x[i], _mm256_loadu_si256((const __m256i*)(K + i * 4))));
+        }
+
+        // 라운드 0~63: 8라운드마다 8워드(W+K)를 미리 스케줄
+        for (int t = 0; t < 64; t += 8) {
+            __m256i n0 = sha512_schedule4_avx2(x[0], x[1], x[2], x[3]);
+            __m256i n1 = sha512_schedule4_avx2(x[1], x[2], x[3], n0);
+            _mm256_store_si256((__m256i*)(wk + t + 16), _mm256_add_epi64(n0, _mm256_loadu_si256((const __m256i*)(K + t + 16))));
+            _mm256_store_si256((__m256i*)(wk + t + 20), _mm256_add_epi64(n1, _mm256_loadu_si256((const __m256i*)(K + t + 20))));
+            x[0] = x[2]; x[1] = x[3]; x[2] = n0; x[3] = n1;
+            SHA512_RND8(wk + t);
+        }
+        // 라운드 64~79
+        SHA512_RND8(wk + 64);
+        SHA512_RND8(wk + 72);
+
+        a += state[0]; b += state[1]; c += state[2]; d += state[3];
+        e += state[4]; f += state[5]; g += state[6]; h += state[7];
+        state[0] = a; state[1] = b; state[2] = c; state[3] = d;
+        state[4] = e; state[5] = f; state[6] = g; state[7] = h;
+    }
+    _mm256_zeroupper();
+}
+
+#endif // SHA512_HAVE_AVX2
+
+
+/*****************************************************
+ * 구현 선택 (런타임 디스패치)
+ * 기본값(AUTO)은 CPU 기능을 보고 가장 빠른 구현을 고르며,
+ * 테스트에서는 sha512_set_impl로 특정 구현을 강제할 수 있습니다.
+ *****************************************************/
+static SHA512_IMPL g_sha512_forced_impl = SHA512_IMPL_AUTO;
+
+int sha512_impl_available(SHA512_IMPL impl) {
+    switch (impl) {
+        case SHA512_IMPL_AUTO:
+        case SHA512_IMPL_SCALAR:
+            return 1;
+#ifdef SHA512_HAVE_AVX2
+        case SHA512_IMPL_AVX2: {
+            uint32_t f = platform_cpu_features();
+            return (f & PLATFORM_CPU_AVX2) && (f & PLATFORM_CPU_BMI2);
+        }
+#endif
+        default:
+            return 0;
+    }
+}
+
+CRYPTO_STATUS sha512_set_impl(SHA512_IMPL impl) {
+    if (!sha512_impl_available(impl)) return CRYPTO_ERR_INVALID_ARGUMENT;
+    g_sha512_forced_impl = impl;
+    return CRYPTO_SUCCESS;
+}
+
+SHA512_IMPL sha512_get_impl(void) {
+    if (g_sha512_forced_impl != SHA512_IMPL_AUTO) return g_sha512_forced_impl;
+    if (sha512_impl_available(SHA512_IMPL_AVX2)) return SHA512_IMPL_AVX2;
+    return SHA512_IMPL_SCALAR;
+}
+
+const char* sha512_impl_name(SHA512_IMPL impl) {
+    switch (impl) {
+        case SHA512_IMPL_AUTO:   return "auto";
+        case SHA512_IMPL_SCALAR: return "scalar";
+        case SHA512_IMPL_AVX2:   return "avx2-bmi2";
+        default:                 return "unknown";
+    }
+}
+
+// 연속된 128바이트 블록들을 선택된 구현으로 state에 압축
+void sha512_compress(uint64_t state[8], const uint8_t* data, size_t blocks) {
+#ifdef SHA512_HAVE_AVX2
+    if (sha512_get_impl() == SHA512_IMPL_AVX2) {
+        transform_avx2(state, data, blocks);
+        return;
+    }
 #endif
+    transform(state, data, blocks);
+}
 
-    // --- 2. 나머지 64개 워드 계산 (Message Schedule)
-    for (int i = 16; i < 80; i++) {
-        uint64_t s0 = SIG0(W[i - 15]);
-        uint64_t s1 = SIG1(W[i - 2]);
-        W[i] = W[i - 16] + s0 + W[i - 7] + s1;
-    }
-
-    // --- 3. 초기 해시 상태 로드
-    a = ctx->state[0];
-    b = ctx->state[1];
-    c = ctx->state[2];
-    d = ctx->state[3];
-    e = ctx->state[4];
-    f = ctx->state[5];
-    g = ctx->state[6];
-    h = ctx->state[7];
-
-    // --- 4. 메인 압축 루프 (80라운드)
-    for (int i = 0; i < 80; i++) {
-        t1 = h + EP1(e) + CH(e, f, g) + K[i] + W[i];
-        t2 = EP0(a) + MAJ(a, b, c);
-
-        // 레지스터 회전 (의미 그대로 유지)
-        h = g;
-        g = f;
-        f = e;
-        e = d + t1;
-        d = c;
-        c = b;
-        b = a;
-        a = t1 + t2;
-    }
-
-    // --- 5. 중간 해시 상태 업데이트
-    ctx->state[0] += a;
-    ctx->state[1] += b;
-    ctx->state[2] += c;
-    ctx->state[3] += d;
-    ctx->state[4] += e;
-    ctx->state[5] += f;
-    ctx->state[6] += g;
-    ctx->state[7] += h;
+static void sha512_blocks(SHA512_CTX* ctx, const uint8_t* data, size_t blocks) {
+    sha512_compress(ctx->state, data, blocks);
 }
 
 CRYPTO_STATUS sha512_init(SHA512_CTX* ctx) { // 초기 해시값 H(0) 설정
@@ -138,20 +320,21 @@ CRYPTO_STATUS sha512_update(SHA512_CTX* ctx, const uint8_t* data, size_t len) {
         }
         memcpy(ctx->buffer + ctx->datalen, data, fill);
 
-        // 버퍼가 SHA512_BLOCK_SIZE(128 바이트 = 1024비트)만큼 차면 transform()을 호출해 한 블록을 처리
-        transform(ctx, ctx->buffer);
+        // 버퍼가 SHA512_BLOCK_SIZE(128 바이트 = 1024비트)만큼 차면 한 블록을 압축
+        sha512_blocks(ctx, ctx->buffer, 1);
         add_bitlen(ctx, SHA512_BLOCK_SIZE);
         data += fill;
         len -= fill;
         ctx->datalen = 0;
     }
 
-    // 이제 남은 입력 데이터를 128바이트(=SHA512_BLOCK_SIZE) 단위로 처리
-    while (len >= SHA512_BLOCK_SIZE) {
-        transform(ctx, data);
-        add_bitlen(ctx, SHA512_BLOCK_SIZE);
-        data += SHA512_BLOCK_SIZE;
-        len -= SHA512_BLOCK_SIZE;
+    // 이제 남은 입력 데이터를 128바이트(=SHA512_BLOCK_SIZE) 단위로 한꺼번에 처리 (상태를 레지스터에 유지)
+    if (len >= SHA512_BLOCK_SIZE) {
+        size_t blocks = len / SHA512_BLOCK_SIZE;
+        sha512_blocks(ctx, data, blocks);
+        add_bitlen(ctx, blocks * SHA512_BLOCK_SIZE);
+        data += blocks * SHA512_BLOCK_SIZE;
+        len -= blocks * SHA512_BLOCK_SIZE;
     }
 
     // 마지막으로 남은 (<128바이트) 부분을 버퍼에 복사
@@ -162,39 +345,39 @@ CRYPTO_STATUS sha512_update(SHA512_CTX* ctx, const uint8_t* data, size_t len) {
     return CRYPTO_SUCCESS;
 }
 
-CRYPTO_STATUS sha512_final(SHA512_CTX* ctx, uint8_t* hash) {
+// 버퍼에 남은 데이터에 패딩과 길이 필드를 붙여 마지막 블록(1개 또는 2개)을 out에 만들고 블록 수를 반환
+// (sha512_final과 sha512_mb_final이 공유)
+static size_t sha512_pad(SHA512_CTX* ctx, uint8_t out[2 * SHA512_BLOCK_SIZE]) {
     // i = 현재 버퍼에 남아 있는 데이터 바이트 수
     size_t i = ctx->datalen;
+    size_t blocks;
+    uint8_t* len_field;
 
     // 남은 메시지 바이트 수를 비트 길이에 더함 (패딩 바이트는 포함하지 않음)
     if (i > 0) add_bitlen(ctx, i);
 
     // 메시지 끝에 '1' 비트를 추가 (0x80)하고 필요한 만큼 0으로 패딩할 준비
-    ctx->buffer[i++] = 0x80;
+    memcpy(out, ctx->buffer, i);
+    out[i++] = 0x80;
 
-    // 남은 공간이 16바이트(길이 필드)보다 적으면, 현재 블록을 0으로 채워서 처리하고 새 블록에서 이어서 작업
-    if (i > 112) {
-        // 남은 부분을 0으로 패딩
-        if (i < SHA512_BLOCK_SIZE) memset(ctx->buffer + i, 0, SHA512_BLOCK_SIZE - i);
-        transform(ctx, ctx->buffer);
-        // 새 블록 시작
-        i = 0;
-    }
+    // 남은 공간이 16바이트(길이 필드)보다 적으면, 현재 블록을 0으로 채우고 새 블록에서 이어서 작업
+    blocks = (i > 112) ? 2 : 1;
 
-    // 블록의 112바이트(=128-16) 지점까지 0으로 패딩
-    if (i < 112) memset(ctx->buffer + i, 0, 112 - i);
+    // 마지막 블록의 112바이트(=128-16) 지점까지 0으로 패딩
+    len_field = out + blocks * SHA512_BLOCK_SIZE - 16;
+    memset(out + i, 0, (size_t)(len_field - (out + i)));
 
     // 마지막 16바이트(128비트)에 메시지 전체 길이를 big-endian으로 기록
     // bitlen_high와 bitlen_low는 각각 64비트이며, 상위 64비트가 먼저 옴
     for (int j = 0; j < 8; ++j) {
-        ctx->buffer[112 + j] = (uint8_t)(ctx->bitlen_high >> (56 - 8 * j));
-        ctx->buffer[120 + j] = (uint8_t)(ctx->bitlen_low >> (56 - 8 * j));
+        len_field[j] = (uint8_t)(ctx->bitlen_high >> (56 - 8 * j));
+        len_field[8 + j] = (uint8_t)(ctx->bitlen_low >> (56 - 8 * j));
     }
+    return blocks;
+}
 
-    // 마지막 블록을 처리
-    transform(ctx, ctx->buffer);
-
-    // 내부 상태(state[8])를 big-endian 바이트 배열(64바이트)로 변환하여 해시 결과에 저장
+// 내부 상태(state[8])를 big-endian 바이트 배열(64바이트)로 변환하여 해시 결과에 저장하고 컨텍스트를 지움
+static void sha512_output(SHA512_CTX* ctx, uint8_t* hash) {
     for (int j = 0; j < 8; ++j) {
         uint64_t v = ctx->state[j];
         hash[j * 8 + 0] = (uint8_t)(v >> 56);
@@ -212,7 +395,379 @@ CRYPTO_STATUS sha512_final(SHA512_CTX* ctx, uint8_t* hash) {
     ctx->datalen = 0;
     ctx->bitlen_low = ctx->bitlen_high = 0;
     for (int j = 0; j < 8; ++j) ctx->state[j] = 0;
+}
 
+CRYPTO_STATUS sha512_final(SHA512_CTX* ctx, uint8_t* hash) {
+    uint8_t last[2 * SHA512_BLOCK_SIZE];
+
+    // 패딩된 마지막 블록(들)을 처리
+    size_t blocks = sha512_pad(ctx, last);
+    sha512_blocks(ctx, last, blocks);
+
+    sha512_output(ctx, hash);
+    memset(last, 0, sizeof(last));
     return CRYPTO_SUCCESS;
 }
 
+
+/*****************************************************
+ * 다중 버퍼(Multi-buffer) SHA-512
+ * * 서로 독립적인 여러 스트림을 SIMD 레인에 하나씩 배정해 한 블록씩 함께 압축합니다.
+ *   (AVX2: 256비트 레지스터 = 4레인, AVX-512: 512비트 레지스터 = 8레인)
+ *   라운드 사이의 의존성은 레인 안에만 있으므로 한 스트림을 처리할 때보다 명령어 수준 병렬성이 큽니다.
+ * * 레인마다 남은 블록 수가 다르므로, 블록을 다 쓴 레인에는 대기 중인 다음 스트림을 바로 넣고
+ *   더 넣을 스트림이 없으면 더미 블록을 넣어 결과를 버립니다 (레인 마스킹).
+ * * 스트림이 하나만 남으면 단일 스트림 구현(sha512_blocks)으로 마무리합니다.
+ * * 패딩은 sha512_final과 같은 sha512_pad를 사용합니다.
+ *****************************************************/
+#define SHA512_MB_MAX_LANES 8
+#define SHA512_MB_BATCH 32   // 한 번에 스케줄하는 스트림 수 (스택 사용량 제한)
+
+// 한 스트림에 대해 압축할 블록: head(있으면 1블록) 다음 data의 blocks개 블록
+typedef struct {
+    SHA512_CTX* ctx;
+    const uint8_t* head;
+    const uint8_t* data;
+    size_t blocks;
+} SHA512_MB_JOB;
+
+// st[j][l] = 레인 l의 state[j]. p[l] = 레인 l이 이번에 압축할 128바이트 블록
+typedef void (*sha512_mb_kernel_fn)(uint64_t st[8][SHA512_MB_MAX_LANES], const uint8_t* const p[SHA512_MB_MAX_LANES]);
+
+#ifdef SHA512_HAVE_AVX2
+
+// 레인 4개의 블록에서 off 위치의 4워드씩을 읽어 워드별 벡터로 전치 (out[k] = 레인 0~3의 k번째 워드)
+SHA512_TARGET("avx2,bmi2")
+static inline void sha512_mb_load4x4_avx2(const uint8_t* const p[4], size_t off, __m256i out[4]) {
+    const __m256i bswap = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+                                          8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i r0 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(p[0] + off)), bswap);
+    __m256i r1 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(p[1] + off)), bswap);
+    __m256i r2 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(p[2] + off)), bswap);
+    __m256i r3 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(p[3] + off)), bswap);
+    __m256i t0 = _mm256_unpacklo_epi64(r0, r1), t1 = _mm256_unpackhi_epi64(r0, r1);
+    __m256i t2 = _mm256_unpacklo_epi64(r2, r3), t3 = _mm256_unpackhi_epi64(r2, r3);
+    out[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    out[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    out[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    out[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+#define SHA512_MB_EP0_256(x) _mm256_xor_si256(_mm256_xor_si256(SHA512_ROR256(x, 28), SHA512_ROR256(x, 34)), SHA512_ROR256(x, 39))
+#define SHA512_MB_EP1_256(x) _mm256_xor_si256(_mm256_xor_si256(SHA512_ROR256(x, 14), SHA512_ROR256(x, 18)), SHA512_ROR256(x, 41))
+
+// 4레인 AVX2 압축 함수
+SHA512_TARGET("avx2,bmi2")
+static void sha512_mb_kernel_avx2(uint64_t st[8][SHA512_MB_MAX_LANES], const uint8_t* const p[SHA512_MB_MAX_LANES]) {
+    __m256i w[16], s[8];
+    for (int k = 0; k < 4; k++) sha512_mb_load4x4_avx2(p, (size_t)k * 32, w + 4 * k);
+    for (int j = 0; j < 8; j++) s[j] = _mm256_load_si256((const __m256i*)st[j]);
+
+    __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int t = 0; t < 80; t++) {
+        // 메시지 스케줄은 최근 16워드만 유지 (W[t]가 W[t-16] 자리를 덮어씀)
+        if (t >= 16) {
+            w[t & 15] = _mm256_add_epi64(_mm256_add_epi64(w[t & 15], w[(t - 7) & 15]),
+                                         _mm256_add_epi64(sha512_sig0_avx2(w[(t - 15) & 15]), sha512_sig1_avx2(w[(t - 2) & 15])));
+        }
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(_mm256_xor_si256(f, g), e), g);
+        __m256i maj = _mm256_xor_si256(_mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(b, c)), b);
+        __m256i t1 = _mm256_add_epi64(_mm256_add_epi64(h, SHA512_MB_EP1_256(e)),
+                                      _mm256_add_epi64(ch, _mm256_add_epi64(_mm256_set1_epi64x((long long)K[t]), w[t & 15])));
+        __m256i t2 = _mm256_add_epi64(SHA512_MB_EP0_256(a), maj);
+        h = g; g = f; f = e; e = _mm256_add_epi64(d, t1);
+        d = c; c = b; b = a; a = _mm256_add_epi64(t1, t2);
+    }
+
+    s[0] = _mm256_add_epi64(s[0], a); s[1] = _mm256_add_epi64(s[1], b);
+    s[2] = _mm256_add_epi64(s[2], c); s[3] = _mm256_add_epi64(s[3], d);
+    s[4] = _mm256_add_epi64(s[4], e); s[5] = _mm256_add_epi64(s[5], f);
+    s[6] = _mm256_add_epi64(s[6], g); s[7] = _mm256_add_epi64(s[7], h);
+    for (int j = 0; j < 8; j++) _mm256_store_si256((__m256i*)st[j], s[j]);
+    _mm256_zeroupper();
+}
+
+// 8레인 AVX-512 압축 함수: 회전은 VPRORQ, Ch/Maj/3중 XOR은 VPTERNLOGQ 한 번으로 계산
+#define SHA512_MB_XOR3_512(x, y, z) _mm512_ternarylogic_epi64((x), (y), (z), 0x96)
+#define SHA512_MB_ROR512(x, n) _mm512_ror_epi64((x), (n))
+
+SHA512_TARGET("avx512f,avx2,bmi2")
+static void sha512_mb_kernel_avx512(uint64_t st[8][SHA512_MB_MAX_LANES], const uint8_t* const p[SHA512_MB_MAX_LANES]) {
+    __m512i w[16], s[8];
+    for (int k = 0; k < 4; k++) {
+        __m256i lo[4], hi[4];
+        sha512_mb_load4x4_avx2(p, (size_t)k * 32, lo);
+        sha512_mb_load4x4_avx2(p + 4, (size_t)k * 32, hi);
+        for (int i = 0; i < 4; i++) w[4 * k + i] = _mm512_inserti64x4(_mm512_castsi256_si512(lo[i]), hi[i], 1);
+    }
+    for (int j = 0; j < 8; j++) s[j] = _mm512_load_si512((const void*)st[j]);
+
+    __m512i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int t = 0; t < 80; t++) {
+        if (t >= 16) {
+            __m512i w15 = w[(t - 15) & 15], w2 = w[(t - 2) & 15];
+            __m512i s0 = SHA512_MB_XOR3_512(SHA512_MB_ROR512(w15, 1), SHA512_MB_ROR512(w15, 8), _mm512_srli_epi64(w15, 7));
+            __m512i s1 = SHA512_MB_XOR3_512(SHA512_MB_ROR512(w2, 19), SHA512_MB_ROR512(w2, 61), _mm512_srli_epi64(w2, 6));
+            w[t & 15] = _mm512_add_epi64(_mm512_add_epi64(w[t & 15], w[(t - 7) & 15]), _mm512_add_epi64(s0, s1));
+        }
+        __m512i ch = _mm512_ternarylogic_epi64(e, f, g, 0xCA);  // e ? f : g
+        __m512i maj = _mm512_ternarylogic_epi64(a, b, c, 0xE8); // 다수결
+        __m512i ep1 = SHA512_MB_XOR3_512(SHA512_MB_ROR512(e, 14), SHA512_MB_ROR512(e, 18), SHA512_MB_ROR512(e, 41));
+        __m512i ep0 = SHA512_MB_XOR3_512(SHA512_MB_ROR512(a, 28), SHA512_MB_ROR512(a, 34), SHA512_MB_ROR512(a, 39));
+        __m512i t1 = _mm512_add_epi64(_mm512_add_epi64(h, ep1),
+                                      _mm512_add_epi64(ch, _mm512_add_epi64(_mm512_set1_epi64((long long)K[t]), w[t & 15])));
+        __m512i t2 = _mm512_add_epi64(ep0, maj);
+        h = g; g = f; f = e; e = _mm512_add_epi64(d, t1);
+        d = c; c = b; b = a; a = _mm512_add_epi64(t1, t2);
+    }
+
+    s[0] = _mm512_add_epi64(s[0], a); s[1] = _mm512_add_epi64(s[1], b);
+    s[2] = _mm512_add_epi64(s[2], c); s[3] = _mm512_add_epi64(s[3], d);
+    s[4] = _mm512_add_epi64(s[4], e); s[5] = _mm512_add_epi64(s[5], f);
+    s[6] = _mm512_add_epi64(s[6], g); s[7] = _mm512_add_epi64(s[7], h);
+    for (int j = 0; j < 8; j++) _mm512_store_si512((void*)st[j], s[j]);
+    _mm256_zeroupper();
+}
+
+#endif // SHA512_HAVE_AVX2
+
+static int g_sha512_mb_forced_lanes = 0; // 0 = 자동
+
+static int sha512_mb_lanes_available(int lanes) {
+    switch (lanes) {
+        case 1:
+            return 1;
+#ifdef SHA512_HAVE_AVX2
+        case 4:
+            return sha512_impl_available(SHA512_IMPL_AVX2);
+        case 8:
+            return sha512_impl_available(SHA512_IMPL_AVX2) && (platform_cpu_features() & PLATFORM_CPU_AVX512F);
+#endif
+        default:
+            return 0;
+    }
+}
+
+CRYPTO_STATUS sha512_mb_set_lanes(int lanes) {
+    if (lanes != 0 && !sha512_mb_lanes_available(lanes)) return CRYPTO_ERR_INVALID_ARGUMENT;
+    g_sha512_mb_forced_lanes = lanes;
+    return CRYPTO_SUCCESS;
+}
+
+int sha512_mb_lanes(void) {
+    if (g_sha512_mb_forced_lanes != 0) return g_sha512_mb_forced_lanes;
+    // sha512_set_impl로 스칼라를 강제했다면 다중 버퍼도 스칼라로 처리
+    if (sha512_get_impl() == SHA512_IMPL_SCALAR) return 1;
+    if (sha512_mb_lanes_available(8)) return 8;
+    if (sha512_mb_lanes_available(4)) return 4;
+    return 1;
+}
+
+// 작업 하나에 남은 블록을 단일 스트림 구현으로 모두 처리
+static void sha512_mb_finish_job(SHA512_MB_JOB* job) {
+    if (job->head != NULL) sha512_blocks(job->ctx, job->head, 1);
+    if (job->blocks > 0) sha512_blocks(job->ctx, job->data, job->blocks);
+    job->head = NULL;
+    job->blocks = 0;
+}
+
+// 레인 수에 맞는 압축 커널 (1레인이면 NULL = 단일 스트림 구현 사용)
+static sha512_mb_kernel_fn sha512_mb_kernel(int lanes) {
+#ifdef SHA512_HAVE_AVX2
+    if (lanes == 8) return sha512_mb_kernel_avx512;
+    if (lanes == 4) return sha512_mb_kernel_avx2;
+#else
+    (void)lanes;
+#endif
+    return NULL;
+}
+
+static const uint8_t sha512_mb_idle_block[SHA512_BLOCK_SIZE] = { 0 }; // 빈 레인에 넣는 더미 입력
+
+// 작업 목록을 레인에 배정하며 모두 압축 (작업 항목의 포인터/블록 수는 소모됨)
+static void sha512_mb_run(SHA512_MB_JOB* jobs, size_t count) {
+    int lanes = sha512_mb_lanes();
+    sha512_mb_kernel_fn kernel = sha512_mb_kernel(lanes);
+
+    if (kernel == NULL) {
+        for (size_t i = 0; i < count; i++) sha512_mb_finish_job(&jobs[i]);
+        return;
+    }
+
+#ifdef _MSC_VER
+    __declspec(align(64)) uint64_t st[8][SHA512_MB_MAX_LANES];
+#else
+    uint64_t st[8][SHA512_MB_MAX_LANES] __attribute__((aligned(64)));
+#endif
+    SHA512_MB_JOB* lane_job[SHA512_MB_MAX_LANES] = { NULL };
+    const uint8_t* p[SHA512_MB_MAX_LANES];
+    size_t next = 0;
+    int active = 0;
+
+    for (int l = 0; l < SHA512_MB_MAX_LANES; l++) p[l] = sha512_mb_idle_block;
+    memset(st, 0, sizeof(st));
+
+    for (;;) {
+        // 빈 레인에 대기 중인 작업을 배정
+        for (int l = 0; l < lanes; l++) {
+            while (lane_job[l] == NULL && next < count) {
+                SHA512_MB_JOB* job = &jobs[next++];
+                if (job->head == NULL && job->blocks == 0) continue;
+                lane_job[l] = job;
+                for (int j = 0; j < 8; j++) st[j][l] = job->ctx->state[j];
+                active++;
+            }
+        }
+        if (active == 0) break;
+
+        // 마지막 한 스트림은 레인을 비워 둔 채 돌리지 않고 단일 스트림 구현으로 마무리
+        if (active == 1 && next == count) {
+            for (int l = 0; l < lanes; l++) {
+                if (lane_job[l] == NULL) continue;
+                for (int j = 0; j < 8; j++) lane_job[l]->ctx->state[j] = st[j][l];
+                sha512_mb_finish_job(lane_job[l]);
+            }
+            break;
+        }
+
+        for (int l = 0; l < lanes; l++) {
+            SHA512_MB_JOB* job = lane_job[l];
+            p[l] = (job == NULL) ? sha512_mb_idle_block : (job->head != NULL ? job->head : job->data);
+        }
+        kernel(st, p);
+
+        // 레인별로 한 블록 소모. 다 끝난 스트림은 상태를 되돌려 놓고 레인을 비움
+        for (int l = 0; l < lanes; l++) {
+            SHA512_MB_JOB* job = lane_job[l];
+            if (job == NULL) continue;
+            if (job->head != NULL) job->head = NULL;
+            else { job->data += SHA512_BLOCK_SIZE; job->blocks--; }
+            if (job->head == NULL && job->blocks == 0) {
+                for (int j = 0; j < 8; j++) job->ctx->state[j] = st[j][l];
+                lane_job[l] = NULL;
+                active--;
+            }
+        }
+    }
+    memset(st, 0, sizeof(st));
+}
+
+void sha512_mb_compress(uint64_t* const states[], const uint8_t* const blocks[], size_t count) {
+    int lanes = sha512_mb_lanes();
+    sha512_mb_kernel_fn kernel = sha512_mb_kernel(lanes);
+#ifdef _MSC_VER
+    __declspec(align(64)) uint64_t st[8][SHA512_MB_MAX_LANES];
+#else
+    uint64_t st[8][SHA512_MB_MAX_LANES] __attribute__((aligned(64)));
+#endif
+    const uint8_t* p[SHA512_MB_MAX_LANES];
+    size_t i = 0;
+
+    // 두 개 이상 남아 있는 동안은 SIMD 커널, 마지막 하나는 단일 스트림 구현
+    if (kernel != NULL) {
+        while (count - i >= 2) {
+            size_t n = (count - i < (size_t)lanes) ? count - i : (size_t)lanes;
+            for (int l = 0; l < SHA512_MB_MAX_LANES; l++) {
+                p[l] = ((size_t)l < n) ? blocks[i + l] : sha512_mb_idle_block;
+                for (int j = 0; j < 8; j++) st[j][l] = ((size_t)l < n) ? states[i + l][j] : 0;
+            }
+            kernel(st, p);
+            for (size_t l = 0; l < n; l++) {
+                for (int j = 0; j < 8; j++) states[i + l][j] = st[j][l];
+            }
+            i += n;
+        }
+        memset(st, 0, sizeof(st));
+    }
+    for (; i < count; i++) sha512_compress(states[i], blocks[i], 1);
+}
+
+CRYPTO_STATUS sha512_mb_update(SHA512_CTX* const ctxs[], const uint8_t* const data[], const size_t lens[], size_t count) {
+    if (count == 0) return CRYPTO_SUCCESS;
+    if (ctxs == NULL || data == NULL || lens == NULL) return CRYPTO_ERR_NULL_CONTEXT;
+    for (size_t i = 0; i < count; i++) {
+        if (ctxs[i] == NULL) return CRYPTO_ERR_NULL_CONTEXT;
+        if (data[i] == NULL && lens[i] > 0) return CRYPTO_ERR_INVALID_INPUT;
+    }
+
+    for (size_t base = 0; base < count; base += SHA512_MB_BATCH) {
+        size_t n = (count - base < SHA512_MB_BATCH) ? count - base : SHA512_MB_BATCH;
+        SHA512_MB_JOB jobs[SHA512_MB_BATCH];
+        const uint8_t* rest[SHA512_MB_BATCH]; // 압축 후 버퍼에 남길 꼬리 (NULL이면 버퍼를 그대로 둠)
+        size_t rest_len[SHA512_MB_BATCH];
+
+        // sha512_update와 같은 순서로 블록을 나눔: 버퍼 채우기 → 연속 블록 → 남은 꼬리
+        for (size_t i = 0; i < n; i++) {
+            SHA512_CTX* ctx = ctxs[base + i];
+            const uint8_t* in = data[base + i];
+            size_t len = lens[base + i];
+            SHA512_MB_JOB* job = &jobs[i];
+
+            job->ctx = ctx;
+            job->head = NULL;
+            job->blocks = 0;
+            job->data = in;
+            rest[i] = NULL;
+            rest_len[i] = 0;
+
+            if (ctx->datalen > 0) {
+                size_t fill = SHA512_BLOCK_SIZE - ctx->datalen;
+                if (len < fill) {
+                    if (len > 0) memcpy(ctx->buffer + ctx->datalen, in, len);
+                    ctx->datalen += len;
+                    continue;
+                }
+                memcpy(ctx->buffer + ctx->datalen, in, fill);
+                job->head = ctx->buffer;
+                add_bitlen(ctx, SHA512_BLOCK_SIZE);
+                in += fill;
+                len -= fill;
+            }
+            if (len == 0 && job->head == NULL) continue;
+
+            job->data = in;
+            job->blocks = len / SHA512_BLOCK_SIZE;
+            add_bitlen(ctx, job->blocks * SHA512_BLOCK_SIZE);
+            rest[i] = in + job->blocks * SHA512_BLOCK_SIZE;
+            rest_len[i] = len % SHA512_BLOCK_SIZE;
+        }
+
+        sha512_mb_run(jobs, n);
+
+        // 버퍼 블록이 압축된 뒤에 꼬리를 버퍼로 옮김
+        for (size_t i = 0; i < n; i++) {
+            SHA512_CTX* ctx = ctxs[base + i];
+            if (rest[i] == NULL) continue;
+            if (rest_len[i] > 0) memcpy(ctx->buffer, rest[i], rest_len[i]);
+            ctx->datalen = rest_len[i];
+        }
+    }
+    return CRYPTO_SUCCESS;
+}
+
+CRYPTO_STATUS sha512_mb_final(SHA512_CTX* const ctxs[], uint8_t* const hashes[], size_t count) {
+    if (count == 0) return CRYPTO_SUCCESS;
+    if (ctxs == NULL || hashes == NULL) return CRYPTO_ERR_NULL_CONTEXT;
+    for (size_t i = 0; i < count; i++) {
+        if (ctxs[i] == NULL || hashes[i] == NULL) return CRYPTO_ERR_NULL_CONTEXT;
+    }
+
+    for (size_t base = 0; base < count; base += SHA512_MB_BATCH) {
+        size_t n = (count - base < SHA512_MB_BATCH) ? count - base : SHA512_MB_BATCH;
+        SHA512_MB_JOB jobs[SHA512_MB_BATCH];
+        uint8_t last[SHA512_MB_BATCH][2 * SHA512_BLOCK_SIZE];
+
+        for (size_t i = 0; i < n; i++) {
+            jobs[i].ctx = ctxs[base + i];
+            jobs[i].head = NULL;
+            jobs[i].data = last[i];
+            jobs[i].blocks = sha512_pad(ctxs[base + i], last[i]);
+        }
+
+        sha512_mb_run(jobs, n);
+
+        for (size_t i = 0; i < n; i++) sha512_output(ctxs[base + i], hashes[base + i]);
+        memset(last, 0, sizeof(last));
+    }
+    return CRYPTO_SUCCESS;
+}
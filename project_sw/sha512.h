@@ -12,6 +12,36 @@ extern "C" {
 	CRYPTO_STATUS sha512_update(SHA512_CTX* ctx, const uint8_t* data, size_t len);
 	CRYPTO_STATUS sha512_final(SHA512_CTX* ctx, uint8_t* hash);
 
+	// 저수준 압축: 128바이트 블록 blocks개를 state(8워드)에 바로 압축 (버퍼/길이 관리와 패딩 없음)
+	// 패딩을 미리 깔아 둔 고정 길이 블록을 반복 압축하는 HMAC/PBKDF2 내부 루프용
+	void sha512_compress(uint64_t state[8], const uint8_t* data, size_t blocks);
+
+	// SHA-512 압축 함수 구현 종류 - 런타임에 CPU 기능을 보고 자동 선택됨
+	typedef enum {
+		SHA512_IMPL_AUTO = 0, // 자동 선택 (사용 가능한 가장 빠른 구현)
+		SHA512_IMPL_SCALAR,   // 포터블 C 구현
+		SHA512_IMPL_AVX2      // AVX2 메시지 스케줄 + BMI2(RORX) 라운드 (x86)
+	} SHA512_IMPL;
+
+	// 구현 강제 지정 (테스트/벤치마크용). 사용 불가능한 구현이면 CRYPTO_ERR_INVALID_ARGUMENT
+	CRYPTO_STATUS sha512_set_impl(SHA512_IMPL impl);
+	SHA512_IMPL sha512_get_impl(void);              // 현재 사용 중인 구현 (AUTO는 실제 구현으로 변환됨)
+	int sha512_impl_available(SHA512_IMPL impl);    // 이 CPU에서 사용 가능하면 1
+	const char* sha512_impl_name(SHA512_IMPL impl);
+
+	// 다중 버퍼(Multi-buffer) SHA-512: 서로 독립적인 여러 스트림을 SIMD 레인에 나눠 함께 압축
+	// ctxs[i]에 data[i] (lens[i] 바이트)를 입력. 스트림마다 sha512_update/sha512_final을 호출한 것과 결과가 같음
+	// 스트림 길이가 서로 달라도 되며, 같은 컨텍스트를 두 번 넣으면 안 됨
+	CRYPTO_STATUS sha512_mb_update(SHA512_CTX* const ctxs[], const uint8_t* const data[], const size_t lens[], size_t count);
+	CRYPTO_STATUS sha512_mb_final(SHA512_CTX* const ctxs[], uint8_t* const hashes[], size_t count);
+	// 레인 수: 1 = 스트림별 단일 구현, 4 = AVX2, 8 = AVX-512. 기본값(0)은 CPU 기능을 보고 자동 선택
+	// 사용 불가능한 값이면 CRYPTO_ERR_INVALID_ARGUMENT
+	CRYPTO_STATUS sha512_mb_set_lanes(int lanes);
+	int sha512_mb_lanes(void);                      // 현재 사용 중인 레인 수
+	// 저수준 다중 버퍼 압축: states[i](8워드)에 blocks[i] (128바이트 1블록)를 압축
+	// i마다 sha512_compress(states[i], blocks[i], 1)을 호출한 것과 결과가 같음 (PBKDF2 일괄 처리용)
+	void sha512_mb_compress(uint64_t* const states[], const uint8_t* const blocks[], size_t count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,10 +1,18 @@
 ﻿#include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <stdint.h>
 #include "aes.h"
 #include "sha512.h"
 #include "hmac_sha512.h"
 #include "kdf.h"
+#include "file_crypto.h"
+#include "platform_utils.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <glob.h>
+#endif
 
 // 헬퍼 함수: 데이터를 16진수 문자열로 출력
 void print_hex(const char* label, const unsigned char* data, int len) {
@@ -20,12 +28,17 @@ int compare_hex(const unsigned char* d1, const unsigned char* d2, int len) {
     return memcmp(d1, d2, len) == 0;
 }
 
-// SHA512 테스트
-int test_sha512(void) {
-    printf("=======================================\n");
-    printf("  SHA-512 Test Vectors\n");
-    printf("=======================================\n");
-    
+// 테스트용 결정적 의사난수 (xorshift32)
+static uint32_t test_rand_state = 0x12345678u;
+static uint8_t test_rand_byte(void) {
+    test_rand_state ^= test_rand_state << 13;
+    test_rand_state ^= test_rand_state >> 17;
+    test_rand_state ^= test_rand_state << 5;
+    return (uint8_t)test_rand_state;
+}
+
+// SHA512 테스트 (현재 선택된 구현으로 표준 벡터 검증)
+static int test_sha512_vectors(void) {
     int pass_count = 0;
     int total_count = 0;
     
@@ -81,10 +94,161 @@ int test_sha512(void) {
         }
     }
     
+    // Test 3: "a" x 1,000,000 (여러 블록을 한 번에 압축하는 경로)
+    {
+        total_count++;
+        static uint8_t msg[1000000];
+        const uint8_t expected[64] = {
+            0xe7, 0x18, 0x48, 0x3d, 0x0c, 0xe7, 0x69, 0x64, 0x4e, 0x2e, 0x42, 0xc7, 0xbc, 0x15, 0xb4, 0x63,
+            0x8e, 0x1f, 0x98, 0xb1, 0x3b, 0x20, 0x44, 0x28, 0x56, 0x32, 0xa8, 0x03, 0xaf, 0xa9, 0x73, 0xeb,
+            0xde, 0x0f, 0xf2, 0x44, 0x87, 0x7e, 0xa6, 0x0a, 0x4c, 0xb0, 0x43, 0x2c, 0xe5, 0x77, 0xc3, 0x1b,
+            0xeb, 0x00, 0x9c, 0x5c, 0x2c, 0x49, 0xaa, 0x2e, 0x4e, 0xad, 0xb2, 0x17, 0xad, 0x8c, 0xc0, 0x9b
+        };
+
+        SHA512_CTX ctx;
+        uint8_t digest[64];
+        memset(msg, 'a', sizeof(msg));
+        sha512_init(&ctx);
+        sha512_update(&ctx, msg, 1);               // 버퍼에 1바이트를 남긴 뒤
+        sha512_update(&ctx, msg + 1, sizeof(msg) - 1); // 나머지를 한 번에
+        sha512_final(&ctx, digest);
+
+        if (compare_hex(digest, expected, 64)) {
+            printf("Test 3 (\"a\" x 1,000,000): PASS\n");
+            pass_count++;
+        } else {
+            printf("Test 3 (\"a\" x 1,000,000): FAIL\n");
+            print_hex("Expected", expected, 64);
+            print_hex("Got", digest, 64);
+        }
+    }
+    
     printf("\nSHA-512 Tests: %d/%d passed\n\n", pass_count, total_count);
     return (pass_count == total_count) ? 0 : 1;
 }
 
+// 구현 간 교차 검증: 임의 길이 입력을 임의 조각으로 나눠 넣은 결과를 스칼라 구현의 한 번 호출 결과와 비교
+static int test_sha512_impl_consistency(SHA512_IMPL impl) {
+    static uint8_t msg[3000];
+    for (int iter = 0; iter < 200; iter++) {
+        size_t len = (iter < 130) ? (size_t)iter * 23 % sizeof(msg) : (size_t)(test_rand_byte() * 11 + iter);
+        uint8_t ref[64], digest[64];
+        SHA512_CTX ctx;
+        for (size_t i = 0; i < len; i++) msg[i] = test_rand_byte();
+
+        sha512_set_impl(SHA512_IMPL_SCALAR);
+        sha512_init(&ctx);
+        sha512_update(&ctx, msg, len);
+        sha512_final(&ctx, ref);
+
+        sha512_set_impl(impl);
+        sha512_init(&ctx);
+        for (size_t pos = 0; pos < len;) {
+            size_t n = (size_t)test_rand_byte() * 3 + 1;
+            if (n > len - pos) n = len - pos;
+            sha512_update(&ctx, msg + pos, n);
+            pos += n;
+        }
+        sha512_final(&ctx, digest);
+        if (memcmp(digest, ref, 64) != 0) {
+            printf("SHA-512 mismatch, length %zu (%s)\n", len, sha512_impl_name(impl));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 다중 버퍼 SHA-512: 길이가 제각각인 스트림들을 여러 번에 나눠 넣은 결과를 스트림별 단일 해시와 비교
+static int test_sha512_mb(int lanes) {
+    enum { STREAMS = 37, MAX_LEN = 2100 };
+    static uint8_t msg[STREAMS][MAX_LEN];
+    SHA512_CTX ctx[STREAMS];
+    SHA512_CTX* ctxs[STREAMS];
+    const uint8_t* data[STREAMS];
+    size_t lens[STREAMS], total[STREAMS], pos[STREAMS];
+    uint8_t digest[STREAMS][64];
+    uint8_t* hashes[STREAMS];
+
+    for (int i = 0; i < STREAMS; i++) {
+        // 0, 1, 111, 112, 127, 128 등 패딩 경계 길이를 포함
+        static const size_t edge[] = { 0, 1, 111, 112, 113, 127, 128, 129, 255, 256 };
+        total[i] = (i < 10) ? edge[i] : (size_t)(test_rand_byte() * 8 + test_rand_byte()) % MAX_LEN;
+        for (size_t k = 0; k < total[i]; k++) msg[i][k] = test_rand_byte();
+        ctxs[i] = &ctx[i];
+        hashes[i] = digest[i];
+        sha512_init(&ctx[i]);
+        // 일부 스트림은 버퍼에 데이터가 남아 있는 상태에서 시작
+        pos[i] = (i % 3 == 0 && total[i] > 0) ? (size_t)test_rand_byte() % total[i] : 0;
+        sha512_update(&ctx[i], msg[i], pos[i]);
+    }
+
+    // 세 번에 나눠 입력 (스트림마다 조각 크기가 다름)
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < STREAMS; i++) {
+            size_t n = (round == 2) ? total[i] - pos[i] : (size_t)test_rand_byte() * 4;
+            if (n > total[i] - pos[i]) n = total[i] - pos[i];
+            data[i] = msg[i] + pos[i];
+            lens[i] = n;
+            pos[i] += n;
+        }
+        if (sha512_mb_update(ctxs, data, lens, STREAMS) != CRYPTO_SUCCESS) return 1;
+    }
+    if (sha512_mb_final(ctxs, hashes, STREAMS) != CRYPTO_SUCCESS) return 1;
+
+    for (int i = 0; i < STREAMS; i++) {
+        uint8_t ref[64];
+        SHA512_CTX one;
+        sha512_init(&one);
+        sha512_update(&one, msg[i], total[i]);
+        sha512_final(&one, ref);
+        if (memcmp(ref, digest[i], 64) != 0) {
+            printf("SHA-512 multi-buffer mismatch, stream %d length %zu (%d lanes)\n", i, total[i], lanes);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// SHA512 테스트: 사용 가능한 모든 구현에 대해 표준 벡터 + 교차 검증 수행
+int test_sha512(void) {
+    const SHA512_IMPL impls[] = { SHA512_IMPL_SCALAR, SHA512_IMPL_AVX2 };
+    int failed = 0;
+
+    printf("=======================================\n");
+    printf("  SHA-512 Test Vectors\n");
+    printf("=======================================\n");
+
+    for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+        if (!sha512_impl_available(impls[i])) {
+            printf("[%s] not available on this CPU, skipped\n\n", sha512_impl_name(impls[i]));
+            continue;
+        }
+        printf("[%s]\n", sha512_impl_name(impls[i]));
+        sha512_set_impl(impls[i]);
+        failed |= test_sha512_vectors();
+
+        int mismatch = test_sha512_impl_consistency(impls[i]);
+        printf("Cross-check vs scalar: %s\n\n", mismatch ? "FAIL" : "PASS");
+        failed |= mismatch;
+    }
+
+    sha512_set_impl(SHA512_IMPL_AUTO);
+
+    const int lane_counts[] = { 1, 4, 8 };
+    for (size_t i = 0; i < sizeof(lane_counts) / sizeof(lane_counts[0]); i++) {
+        if (sha512_mb_set_lanes(lane_counts[i]) != CRYPTO_SUCCESS) {
+            printf("[multi-buffer x%d] not available on this CPU, skipped\n", lane_counts[i]);
+            continue;
+        }
+        int mismatch = test_sha512_mb(lane_counts[i]);
+        printf("[multi-buffer x%d] vs single-stream: %s\n", lane_counts[i], mismatch ? "FAIL" : "PASS");
+        failed |= mismatch;
+    }
+    sha512_mb_set_lanes(0);
+    printf("\n");
+    return failed ? 1 : 0;
+}
+
 // HMAC-SHA512 테스트 (RFC 4231)
 int test_hmac_sha512(void) {
     printf("=======================================\n");
@@ -148,10 +312,104 @@ int test_hmac_sha512(void) {
         }
     }
     
+    // 키 재사용: reset / clone / 중간 상태 내보내기·가져오기 결과가 원샷 HMAC과 같은지 확인
+    {
+        total_count++;
+        uint8_t key[200], msg[300], mac[64], ref[64], midstate[HMAC_SHA512_MIDSTATE_SIZE];
+        size_t key_lens[] = { 4, 20, 128, 200 }; // 블록 크기보다 긴 키(해시로 줄임)도 포함
+        int ok = 1;
+        for (size_t i = 0; i < sizeof(key); i++) key[i] = test_rand_byte();
+        for (size_t i = 0; i < sizeof(msg); i++) msg[i] = test_rand_byte();
+
+        for (size_t k = 0; k < sizeof(key_lens) / sizeof(key_lens[0]); k++) {
+            HMAC_SHA512_CTX ctx, copy, imported;
+            hmac_sha512_init(&ctx, key, key_lens[k]);
+            hmac_sha512_export_midstate(&ctx, midstate);
+            hmac_sha512_import_midstate(&imported, midstate);
+
+            for (size_t len = 0; len <= sizeof(msg); len += 37) {
+                hmac_sha512(key, key_lens[k], msg, len, ref);
+
+                // 같은 컨텍스트를 final 이후 reset해서 재사용
+                hmac_sha512_reset(&ctx);
+                hmac_sha512_update(&ctx, msg, len / 2);
+                hmac_sha512_clone(&copy, &ctx); // 메시지 중간에서 복제
+                hmac_sha512_update(&ctx, msg + len / 2, len - len / 2);
+                hmac_sha512_final(&ctx, mac);
+                ok &= (memcmp(mac, ref, 64) == 0);
+
+                hmac_sha512_update(&copy, msg + len / 2, len - len / 2);
+                hmac_sha512_final(&copy, mac);
+                ok &= (memcmp(mac, ref, 64) == 0);
+
+                hmac_sha512_reset(&imported);
+                hmac_sha512_update(&imported, msg, len);
+                hmac_sha512_final(&imported, mac);
+                ok &= (memcmp(mac, ref, 64) == 0);
+            }
+            hmac_sha512_wipe(&ctx);
+            ok &= (hmac_sha512_reset(&ctx) == 0); // 지운 뒤에는 재사용 불가
+        }
+
+        if (ok) {
+            printf("Key reuse (reset/clone/midstate): PASS\n");
+            pass_count++;
+        } else {
+            printf("Key reuse (reset/clone/midstate): FAIL\n");
+        }
+    }
+    
+    // 리포트: RFC 4231 7개 케이스 통과, 측정 항목이 채워지고 구현 선택이 그대로인지, JSON 저장
+    {
+        static HMAC_SHA512_Report rep;
+        const char* json_path = "hmac_sha512_report_test.json";
+        SHA512_IMPL sha_impl = sha512_get_impl();
+        AES_IMPL aes_impl = AES_get_impl();
+        int ok = 1;
+
+        total_count++;
+        ok &= (hmac_sha512_run_report(&rep) == 1) && (rep.total == 7) && (rep.passed == 7);
+        ok &= (rep.bench_count >= 5); // SHA-512/HMAC/PBKDF2 1개 이상 + AES-CTR 키 길이 3개
+        for (int i = 0; i < rep.bench_count; i++) {
+            ok &= (rep.bench[i].bytes > 0) && (rep.bench[i].mb_per_s > 0.0);
+        }
+        ok &= (sha512_get_impl() == sha_impl) && (AES_get_impl() == aes_impl);
+
+        ok &= (hmac_sha512_write_json(&rep, json_path) == 1);
+        FILE* f = fopen(json_path, "rb");
+        char head[16] = {0};
+        ok &= (f != NULL) && (fread(head, 1, 15, f) == 15) && (strncmp(head, "{\n  \"format\": 1", 15) == 0);
+        if (f) fclose(f);
+        remove(json_path);
+
+        if (ok) {
+            printf("Report (RFC 4231 x7, %d benchmarks, JSON): PASS\n", rep.bench_count);
+            pass_count++;
+        } else {
+            printf("Report (RFC 4231 x7, %d benchmarks, JSON): FAIL\n", rep.bench_count);
+        }
+    }
+    
     printf("\nHMAC-SHA512 Tests: %d/%d passed\n\n", pass_count, total_count);
     return (pass_count == total_count) ? 0 : 1;
 }
 
+// PBKDF2 결과를 기대값과 비교해 출력 (test_pbkdf2_sha512 보조)
+static int check_pbkdf2(const char* name, const char* password, const char* salt, uint32_t iterations,
+                        const uint8_t* expected, size_t len) {
+    uint8_t output[128];
+    pbkdf2_sha512((const uint8_t*)password, strlen(password),
+                  (const uint8_t*)salt, strlen(salt), iterations, output, len);
+    if (compare_hex(output, expected, len)) {
+        printf("%s: PASS\n", name);
+        return 1;
+    }
+    printf("%s: FAIL\n", name);
+    print_hex("Expected", expected, len);
+    print_hex("Got", output, len);
+    return 0;
+}
+
 // PBKDF2-SHA512 테스트
 int test_pbkdf2_sha512(void) {
     printf("=======================================\n");
@@ -161,46 +419,182 @@ int test_pbkdf2_sha512(void) {
     int pass_count = 0;
     int total_count = 0;
     
-    // Test Case 1: RFC 6070 style (simplified)
+    // Test Case 1: "password" / "salt", 1회 (U1만 사용)
     {
         total_count++;
-        const char* password = "password";
-        const uint8_t salt[] = {0x73, 0x61, 0x6c, 0x74}; // "salt"
-        uint8_t output[64];
-        
-        pbkdf2_sha512((const uint8_t*)password, strlen(password),
-                     salt, sizeof(salt), 1, output, 64);
-        
-        // Note: This is a basic test - actual RFC test vectors may differ
-        // We're mainly checking that the function runs without error
-        printf("Test Case 1 (basic): PASS (function executed)\n");
-        pass_count++;
+        const uint8_t expected[64] = {
+            0x86, 0x7f, 0x70, 0xcf, 0x1a, 0xde, 0x02, 0xcf, 0xf3, 0x75, 0x25, 0x99, 0xa3, 0xa5, 0x3d, 0xc4,
+            0xaf, 0x34, 0xc7, 0xa6, 0x69, 0x81, 0x5a, 0xe5, 0xd5, 0x13, 0x55, 0x4e, 0x1c, 0x8c, 0xf2, 0x52,
+            0xc0, 0x2d, 0x47, 0x0a, 0x28, 0x5a, 0x05, 0x01, 0xba, 0xd9, 0x99, 0xbf, 0xe9, 0x43, 0xc0, 0x8f,
+            0x05, 0x02, 0x35, 0xd7, 0xd6, 0x8b, 0x1d, 0xa5, 0x5e, 0x63, 0xf7, 0x3b, 0x60, 0xa5, 0x7f, 0xce
+        };
+        pass_count += check_pbkdf2("Test Case 1 (1 iteration)", "password", "salt", 1, expected, 64);
     }
     
-    // Test Case 2: With iterations
+    // Test Case 2: 앱 기본 솔트("AESC")와 기본 반복 횟수
     {
         total_count++;
-        const char* password = "test";
-        const uint8_t salt[] = {0x41, 0x45, 0x53, 0x43}; // "AESC"
-        uint8_t output[64];
-        
-        pbkdf2_sha512((const uint8_t*)password, strlen(password),
-                     salt, sizeof(salt), 10000, output, 64);
-        
-        printf("Test Case 2 (10000 iterations): PASS (function executed)\n");
-        pass_count++;
+        const uint8_t expected[64] = {
+            0xd4, 0xcf, 0x47, 0x63, 0x26, 0x87, 0x1a, 0x9c, 0x7d, 0x83, 0x11, 0x7b, 0x31, 0x07, 0x52, 0xec,
+            0x74, 0xfd, 0xb9, 0xf3, 0x30, 0x10, 0xc7, 0xc6, 0x2c, 0xdb, 0x01, 0x16, 0xb0, 0x31, 0x06, 0x81,
+            0x65, 0x51, 0x1d, 0xd6, 0x7c, 0x69, 0xee, 0xa6, 0x89, 0x97, 0xef, 0x0e, 0x5d, 0xf9, 0xdb, 0x9f,
+            0xea, 0x5c, 0x4a, 0xa6, 0x11, 0x55, 0x5c, 0xc0, 0x86, 0xc5, 0x39, 0xa4, 0x5d, 0x9b, 0x21, 0xdf
+        };
+        pass_count += check_pbkdf2("Test Case 2 (10000 iterations)", "test", "AESC", 10000, expected, 64);
+    }
+    
+    // Test Case 3: 출력이 두 블록에 걸치는 경우 (100바이트)
+    {
+        total_count++;
+        const uint8_t expected[100] = {
+            0x8c, 0x05, 0x11, 0xf4, 0xc6, 0xe5, 0x97, 0xc6, 0xac, 0x63, 0x15, 0xd8, 0xf0, 0x36, 0x2e, 0x22,
+            0x5f, 0x3c, 0x50, 0x14, 0x95, 0xba, 0x23, 0xb8, 0x68, 0xc0, 0x05, 0x17, 0x4d, 0xc4, 0xee, 0x71,
+            0x11, 0x5b, 0x59, 0xf9, 0xe6, 0x0c, 0xd9, 0x53, 0x2f, 0xa3, 0x3e, 0x0f, 0x75, 0xae, 0xfe, 0x30,
+            0x22, 0x5c, 0x58, 0x3a, 0x18, 0x6c, 0xd8, 0x2b, 0xd4, 0xda, 0xea, 0x97, 0x24, 0xa3, 0xd3, 0xb8,
+            0x04, 0xf7, 0x5b, 0xdd, 0x41, 0x49, 0x4f, 0xa3, 0x24, 0xca, 0xb2, 0x4b, 0xcc, 0x68, 0x0f, 0xb3,
+            0xb9, 0x6a, 0x30, 0xcf, 0x5d, 0x21, 0xfa, 0xc3, 0xc2, 0x87, 0x59, 0x13, 0x91, 0x9f, 0x33, 0x99,
+            0xb1, 0xd9, 0xce, 0x7e
+        };
+        pass_count += check_pbkdf2("Test Case 3 (4096 iterations, 100 bytes)", "passwordPASSWORDpassword",
+                                   "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096, expected, 100);
+    }
+    
+    // 일괄 처리: 반복 횟수/출력 길이/솔트가 제각각인 작업들을 레인 수 · 스레드 수를 바꿔 가며 개별 호출과 비교
+    {
+        enum { JOBS = 13 };
+        PBKDF2_SHA512_JOB jobs[JOBS];
+        uint8_t password[JOBS][16], salt[JOBS][24], out[JOBS][130], ref[JOBS][130];
+        const int lane_counts[] = { 1, 4, 8 };
+        const int thread_counts[] = { 1, 3 };
+        int ok = 1;
+
+        for (int i = 0; i < JOBS; i++) {
+            for (int k = 0; k < 16; k++) password[i][k] = test_rand_byte();
+            for (int k = 0; k < 24; k++) salt[i][k] = test_rand_byte();
+            jobs[i].password = password[i];
+            jobs[i].password_len = 1 + i % 16;
+            jobs[i].salt = (i == 5) ? NULL : salt[i]; // 기본 솔트 사용
+            jobs[i].salt_len = (i == 5) ? 0 : (size_t)(i % 24);
+            jobs[i].iterations = (uint32_t)(1 + i * 37);
+            jobs[i].output = out[i];
+            jobs[i].output_len = (i % 4 == 0) ? 130 : 32 + i; // 일부는 여러 블록
+            pbkdf2_sha512(jobs[i].password, jobs[i].password_len, jobs[i].salt, jobs[i].salt_len,
+                          jobs[i].iterations, ref[i], jobs[i].output_len);
+        }
+
+        for (size_t l = 0; l < sizeof(lane_counts) / sizeof(lane_counts[0]); l++) {
+            if (sha512_mb_set_lanes(lane_counts[l]) != CRYPTO_SUCCESS) continue;
+            for (size_t th = 0; th < sizeof(thread_counts) / sizeof(thread_counts[0]); th++) {
+                memset(out, 0, sizeof(out));
+                if (pbkdf2_sha512_batch(jobs, JOBS, thread_counts[th]) != CRYPTO_SUCCESS) ok = 0;
+                for (int i = 0; i < JOBS; i++) {
+                    if (memcmp(out[i], ref[i], jobs[i].output_len) != 0) ok = 0;
+                }
+            }
+        }
+        sha512_mb_set_lanes(0);
+
+        total_count++;
+        if (ok) {
+            printf("Batch (lanes x threads) vs single: PASS\n");
+            pass_count++;
+        } else {
+            printf("Batch (lanes x threads) vs single: FAIL\n");
+        }
+    }
+    
+    // 키 도출 캐시: 캐시를 거친 결과가 직접 계산과 같고, 같은 입력은 항목 하나를 재사용하는지 확인
+    {
+        const uint8_t salt[] = { 0x41, 0x45, 0x53, 0x43 }; // 기본 솔트를 명시한 호출도 NULL 솔트와 같은 항목
+        uint8_t ref_a[64], ref_b[64], out[64];
+        int ok = 1;
+
+        total_count++;
+        pbkdf2_sha512((const uint8_t*)"alpha1", 6, NULL, 0, 1000, ref_a, 64);
+        pbkdf2_sha512((const uint8_t*)"bravo2", 6, NULL, 0, 1000, ref_b, 64);
+
+        kdf_cache_wipe();
+        pbkdf2_sha512_cached((const uint8_t*)"alpha1", 6, NULL, 0, 1000, out, 64);
+        ok &= (memcmp(out, ref_a, 64) == 0);
+        int cached = kdf_cache_count();
+        pbkdf2_sha512_cached((const uint8_t*)"alpha1", 6, salt, sizeof(salt), 1000, out, 64);
+        ok &= (memcmp(out, ref_a, 64) == 0);
+        pbkdf2_sha512_cached((const uint8_t*)"bravo2", 6, NULL, 0, 1000, out, 64);
+        ok &= (memcmp(out, ref_b, 64) == 0);
+        if (cached == 1) {
+            ok &= (kdf_cache_count() == 2);
+        } else {
+            printf("(key cache unavailable: memory could not be locked)\n");
+        }
+
+        kdf_cache_wipe();
+        ok &= (kdf_cache_count() == 0);
+        kdf_cache_set_ttl(0); // 캐시를 꺼도 결과는 같고 항목이 남지 않아야 함
+        pbkdf2_sha512_cached((const uint8_t*)"alpha1", 6, NULL, 0, 1000, out, 64);
+        ok &= (memcmp(out, ref_a, 64) == 0) && (kdf_cache_count() == 0);
+        kdf_cache_set_ttl(KDF_CACHE_DEFAULT_TTL);
+
+        if (ok) {
+            printf("Key cache (hit/miss/wipe/TTL off): PASS\n");
+            pass_count++;
+        } else {
+            printf("Key cache (hit/miss/wipe/TTL off): FAIL\n");
+        }
+    }
+    
+    // HKDF-SHA512: RFC 5869 테스트 케이스 1, 3의 입력을 SHA-512로 계산한 값
+    {
+        static const uint8_t okm1[42] = {
+            0x83, 0x23, 0x90, 0x08, 0x6c, 0xda, 0x71, 0xfb, 0x47, 0x62, 0x5b, 0xb5, 0xce, 0xb1,
+            0x68, 0xe4, 0xc8, 0xe2, 0x6a, 0x1a, 0x16, 0xed, 0x34, 0xd9, 0xfc, 0x7f, 0xe9, 0x2c,
+            0x14, 0x81, 0x57, 0x93, 0x38, 0xda, 0x36, 0x2c, 0xb8, 0xd9, 0xf9, 0x25, 0xd7, 0xcb
+        };
+        static const uint8_t okm3[42] = {
+            0xf5, 0xfa, 0x02, 0xb1, 0x82, 0x98, 0xa7, 0x2a, 0x8c, 0x23, 0x89, 0x8a, 0x87, 0x03,
+            0x47, 0x2c, 0x6e, 0xb1, 0x79, 0xdc, 0x20, 0x4c, 0x03, 0x42, 0x5c, 0x97, 0x0e, 0x3b,
+            0x16, 0x4b, 0xf9, 0x0f, 0xff, 0x22, 0xd0, 0x48, 0x36, 0xd0, 0xe2, 0x34, 0x3b, 0xac
+        };
+        uint8_t ikm[22], salt[13], info[10], out[42];
+        memset(ikm, 0x0b, sizeof(ikm));
+        for (int i = 0; i < 13; i++) salt[i] = (uint8_t)i;
+        for (int i = 0; i < 10; i++) info[i] = (uint8_t)(0xf0 + i);
+
+        total_count++;
+        int ok = (hkdf_sha512(salt, sizeof(salt), ikm, sizeof(ikm), info, sizeof(info), out, 42) == CRYPTO_SUCCESS) &&
+                 (memcmp(out, okm1, 42) == 0);
+        ok &= (hkdf_sha512(NULL, 0, ikm, sizeof(ikm), NULL, 0, out, 42) == CRYPTO_SUCCESS) &&
+              (memcmp(out, okm3, 42) == 0);
+        ok &= (hkdf_sha512(NULL, 0, ikm, sizeof(ikm), NULL, 0, out, 0) == CRYPTO_ERR_INVALID_ARGUMENT);
+        ok &= (hkdf_sha512(NULL, 0, ikm, sizeof(ikm), NULL, 0, NULL, 42) == CRYPTO_ERR_NULL_CONTEXT);
+        if (ok) {
+            printf("HKDF-SHA512 (RFC 5869 cases 1, 3): PASS\n");
+            pass_count++;
+        } else {
+            printf("HKDF-SHA512 (RFC 5869 cases 1, 3): FAIL\n");
+        }
+    }
+    
+    // 반복 횟수 보정: 하한 적용, 1000 단위, 목표 시간이 길수록 반복 횟수도 큼
+    {
+        total_count++;
+        uint32_t fast = pbkdf2_sha512_calibrate(5, 1000);
+        uint32_t slow = pbkdf2_sha512_calibrate(200, 1000);
+        uint32_t floor_only = pbkdf2_sha512_calibrate(1, 50000000);
+        if (fast >= 1000 && fast % 1000 == 0 && slow % 1000 == 0 && slow > fast &&
+            floor_only == 50000000) {
+            printf("Calibrate (5 ms: %u, 200 ms: %u iterations): PASS\n", (unsigned int)fast, (unsigned int)slow);
+            pass_count++;
+        } else {
+            printf("Calibrate (5 ms: %u, 200 ms: %u iterations): FAIL\n", (unsigned int)fast, (unsigned int)slow);
+        }
     }
     
     printf("\nPBKDF2-SHA512 Tests: %d/%d passed\n\n", pass_count, total_count);
     return (pass_count == total_count) ? 0 : 1;
 }
 
-// AES 테스트
-int test_aes(void) {
-    printf("=======================================\n");
-    printf("  NIST SP 800-38A CTR Mode Test Vector\n");
-    printf("=======================================\n");
-    
+// AES 테스트 (현재 선택된 구현으로 NIST 벡터 검증)
+static int test_aes_nist_ctr(void) {
     AES_CTX ctx;
     int pass_count = 0;
     int total_count = 0;
@@ -341,6 +735,1040 @@ int test_aes(void) {
     return (pass_count == total_count) ? 0 : 1;
 }
 
+// NIST SP 800-38A F.5.1/F.5.3/F.5.5 (4블록) 벡터를 1KB 버퍼 앞부분에 두고 암호화
+// 광폭(16/32블록) CTR 커널의 레인 배치와 카운터 증가까지 검증
+static int test_aes_nist_ctr_multiblock(void) {
+    static const uint8_t pt[64] = {
+        0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+        0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+        0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+        0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+    };
+    static const uint8_t key[32] = {
+        0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+        0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+    };
+    static const uint8_t key128[16] = {
+        0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+    };
+    static const uint8_t key192[24] = {
+        0x8e, 0x73, 0xb0, 0xf7, 0xda, 0x0e, 0x64, 0x52, 0xc8, 0x10, 0xf3, 0x2b, 0x80, 0x90, 0x79, 0xe5,
+        0x62, 0xf8, 0xea, 0xd2, 0x52, 0x2c, 0x6b, 0x7b
+    };
+    static const uint8_t expected[3][64] = {
+        { 0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+          0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+          0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+          0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee },
+        { 0x1a, 0xbc, 0x93, 0x24, 0x17, 0x52, 0x1c, 0xa2, 0x4f, 0x2b, 0x04, 0x59, 0xfe, 0x7e, 0x6e, 0x0b,
+          0x09, 0x03, 0x39, 0xec, 0x0a, 0xa6, 0xfa, 0xef, 0xd5, 0xcc, 0xc2, 0xc6, 0xf4, 0xce, 0x8e, 0x94,
+          0x1e, 0x36, 0xb2, 0x6b, 0xd1, 0xeb, 0xc6, 0x70, 0xd1, 0xbd, 0x1d, 0x66, 0x56, 0x20, 0xab, 0xf7,
+          0x4f, 0x78, 0xa7, 0xf6, 0xd2, 0x98, 0x09, 0x58, 0x5a, 0x97, 0xda, 0xec, 0x58, 0xc6, 0xb0, 0x50 },
+        { 0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57, 0x89, 0xa5, 0xb7, 0xa7, 0xf5, 0x04, 0xbb, 0xf3, 0xd2, 0x28,
+          0xf4, 0x43, 0xe3, 0xca, 0x4d, 0x62, 0xb5, 0x9a, 0xca, 0x84, 0xe9, 0x90, 0xca, 0xca, 0xf5, 0xc5,
+          0x2b, 0x09, 0x30, 0xda, 0xa2, 0x3d, 0xe9, 0x4c, 0xe8, 0x70, 0x17, 0xba, 0x2d, 0x84, 0x98, 0x8d,
+          0xdf, 0xc9, 0xc5, 0x8d, 0xb6, 0x7a, 0xad, 0xa6, 0x13, 0xc2, 0xdd, 0x08, 0x45, 0x79, 0x41, 0xa6 }
+    };
+    const uint8_t* keys[3] = { key128, key192, key };
+    static uint8_t buf[1024];
+    int failed = 0;
+
+    for (int k = 0; k < 3; k++) {
+        uint8_t iv[AES_BLOCK_SIZE] = { 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                       0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff };
+        AES_CTX ctx;
+        memset(buf, 0, sizeof(buf));
+        memcpy(buf, pt, sizeof(pt));
+        AES_set_key(&ctx, keys[k], 128 + 64 * k);
+        AES_CTR_crypt(&ctx, buf, sizeof(buf), buf, iv);
+
+        int ok = compare_hex(buf, expected[k], 64);
+        printf("AES-%d CTR 4-block (1KB buffer): %s\n", 128 + 64 * k, ok ? "PASS" : "FAIL");
+        if (!ok) {
+            print_hex("Expected", expected[k], 64);
+            print_hex("Got", buf, 64);
+            failed = 1;
+        }
+    }
+    return failed;
+}
+
+// NIST SP 800-38A F.2.1/F.2.3/F.2.5 CBC (4블록) 벡터를 1KB 버퍼 앞부분에 두고 암호화한 뒤,
+// 같은 버퍼를 in-place로 복호화해 원문 복원 확인 (광폭 CBC 복호화 커널의 레인 간 체이닝 검증)
+static int test_aes_nist_cbc_multiblock(void) {
+    static const uint8_t pt[64] = {
+        0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+        0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+        0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+        0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+    };
+    static const uint8_t key[32] = {
+        0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+        0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+    };
+    static const uint8_t key128[16] = {
+        0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+    };
+    static const uint8_t key192[24] = {
+        0x8e, 0x73, 0xb0, 0xf7, 0xda, 0x0e, 0x64, 0x52, 0xc8, 0x10, 0xf3, 0x2b, 0x80, 0x90, 0x79, 0xe5,
+        0x62, 0xf8, 0xea, 0xd2, 0x52, 0x2c, 0x6b, 0x7b
+    };
+    static const uint8_t expected[3][64] = {
+        { 0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d,
+          0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+          0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+          0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7 },
+        { 0x4f, 0x02, 0x1d, 0xb2, 0x43, 0xbc, 0x63, 0x3d, 0x71, 0x78, 0x18, 0x3a, 0x9f, 0xa0, 0x71, 0xe8,
+          0xb4, 0xd9, 0xad, 0xa9, 0xad, 0x7d, 0xed, 0xf4, 0xe5, 0xe7, 0x38, 0x76, 0x3f, 0x69, 0x14, 0x5a,
+          0x57, 0x1b, 0x24, 0x20, 0x12, 0xfb, 0x7a, 0xe0, 0x7f, 0xa9, 0xba, 0xac, 0x3d, 0xf1, 0x02, 0xe0,
+          0x08, 0xb0, 0xe2, 0x79, 0x88, 0x59, 0x88, 0x81, 0xd9, 0x20, 0xa9, 0xe6, 0x4f, 0x56, 0x15, 0xcd },
+        { 0xf5, 0x8c, 0x4c, 0x04, 0xd6, 0xe5, 0xf1, 0xba, 0x77, 0x9e, 0xab, 0xfb, 0x5f, 0x7b, 0xfb, 0xd6,
+          0x9c, 0xfc, 0x4e, 0x96, 0x7e, 0xdb, 0x80, 0x8d, 0x67, 0x9f, 0x77, 0x7b, 0xc6, 0x70, 0x2c, 0x7d,
+          0x39, 0xf2, 0x33, 0x69, 0xa9, 0xd9, 0xba, 0xcf, 0xa5, 0x30, 0xe2, 0x63, 0x04, 0x23, 0x14, 0x61,
+          0xb2, 0xeb, 0x05, 0xe2, 0xc3, 0x9b, 0xe9, 0xfc, 0xda, 0x6c, 0x19, 0x07, 0x8c, 0x6a, 0x9d, 0x1b }
+    };
+    const uint8_t* keys[3] = { key128, key192, key };
+    static uint8_t buf[1024], orig[1024];
+    int failed = 0;
+
+    for (int k = 0; k < 3; k++) {
+        uint8_t iv[AES_BLOCK_SIZE], iv_dec[AES_BLOCK_SIZE];
+        AES_CTX ctx;
+        for (int i = 0; i < AES_BLOCK_SIZE; i++) iv[i] = iv_dec[i] = (uint8_t)i;
+        for (size_t i = 0; i < sizeof(orig); i++) orig[i] = (uint8_t)(i * 7);
+        memcpy(orig, pt, sizeof(pt));
+        memcpy(buf, orig, sizeof(buf));
+        AES_set_key(&ctx, keys[k], 128 + 64 * k);
+        AES_CBC_encrypt(&ctx, buf, sizeof(buf), buf, iv);
+
+        int ok = compare_hex(buf, expected[k], 64);
+        AES_CBC_decrypt(&ctx, buf, sizeof(buf), buf, iv_dec);
+        ok = ok && compare_hex(buf, orig, sizeof(buf)) && compare_hex(iv, iv_dec, AES_BLOCK_SIZE);
+        printf("AES-%d CBC 4-block (1KB buffer): %s\n", 128 + 64 * k, ok ? "PASS" : "FAIL");
+        if (!ok) {
+            print_hex("Expected", expected[k], 64);
+            print_hex("Got", buf, 64);
+            failed = 1;
+        }
+    }
+    return failed;
+}
+
+// 구현 간 교차 검증: 다양한 길이와 카운터 자리올림 경계에서 T-tables 결과와 비교
+static int test_aes_impl_consistency(AES_IMPL impl) {
+    static uint8_t pt[4099], ct_ref[4099], ct[4099];
+    const size_t lengths[] = { 1, 15, 16, 17, 127, 128, 129, 255, 1000, 4099 };
+    const int key_bits[] = { 128, 192, 256 };
+
+    for (int k = 0; k < 3; k++) {
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            uint8_t key[32], iv[AES_BLOCK_SIZE], iv_ref[AES_BLOCK_SIZE], iv_impl[AES_BLOCK_SIZE];
+            AES_CTX ctx_ref, ctx;
+            size_t len = lengths[l];
+
+            for (int i = 0; i < 32; i++) key[i] = test_rand_byte();
+            for (int i = 0; i < AES_BLOCK_SIZE; i++) iv[i] = test_rand_byte();
+            if (l % 2) memset(iv + 8, 0xff, 7); // 하위 64비트 자리올림 경계 근처
+            for (size_t i = 0; i < len; i++) pt[i] = test_rand_byte();
+            memcpy(iv_ref, iv, AES_BLOCK_SIZE);
+            memcpy(iv_impl, iv, AES_BLOCK_SIZE);
+
+            AES_set_impl(AES_IMPL_TABLE);
+            AES_set_key(&ctx_ref, key, key_bits[k]);
+            AES_CTR_crypt(&ctx_ref, pt, len, ct_ref, iv_ref);
+
+            AES_set_impl(impl);
+            AES_set_key(&ctx, key, key_bits[k]);
+            if (memcmp(ctx.round_keys, ctx_ref.round_keys, (ctx.Nr + 1) * AES_BLOCK_SIZE) != 0) {
+                printf("AES-%d key schedule mismatch (%s)\n", key_bits[k], AES_impl_name(impl));
+                return 1;
+            }
+            memcpy(ct, pt, len);
+            AES_CTR_crypt(&ctx, ct, len, ct, iv_impl); // in-place
+            if (memcmp(ct, ct_ref, len) != 0 || memcmp(iv_impl, iv_ref, AES_BLOCK_SIZE) != 0) {
+                printf("AES-%d CTR mismatch, length %zu (%s)\n", key_bits[k], len, AES_impl_name(impl));
+                return 1;
+            }
+
+            // 랜덤 액세스: 임의 오프셋(블록 중간 포함)부터의 결과가 전체 스트림의 같은 구간과 일치해야 함
+            size_t off = (len > 1) ? (size_t)test_rand_byte() * 31 % len : 0;
+            memcpy(iv_impl, iv, AES_BLOCK_SIZE);
+            AES_CTR_crypt_at(&ctx, iv_impl, off, pt + off, len - off, ct);
+            if (memcmp(ct, ct_ref + off, len - off) != 0 || memcmp(iv_impl, iv, AES_BLOCK_SIZE) != 0) {
+                printf("AES-%d CTR_crypt_at mismatch, offset %zu (%s)\n", key_bits[k], off, AES_impl_name(impl));
+                return 1;
+            }
+
+            // 단일 블록 암복호화도 임의 입력으로 T-tables 구현과 비교
+            uint8_t blk[AES_BLOCK_SIZE], enc_ref[AES_BLOCK_SIZE], enc[AES_BLOCK_SIZE], dec[AES_BLOCK_SIZE];
+            for (int i = 0; i < AES_BLOCK_SIZE; i++) blk[i] = test_rand_byte();
+            AES_set_impl(AES_IMPL_TABLE);
+            AES_encrypt_block(&ctx_ref, blk, enc_ref);
+            AES_set_impl(impl);
+            AES_encrypt_block(&ctx, blk, enc);
+            AES_decrypt_block(&ctx, enc, dec);
+            if (memcmp(enc, enc_ref, AES_BLOCK_SIZE) != 0 || memcmp(dec, blk, AES_BLOCK_SIZE) != 0) {
+                printf("AES-%d block encrypt/decrypt mismatch (%s)\n", key_bits[k], AES_impl_name(impl));
+                return 1;
+            }
+
+            // ECB/CBC: 블록 배수 길이로 T-tables 결과와 비교 (복호화는 in-place)
+            size_t blocks = len / AES_BLOCK_SIZE;
+            if (memcmp(ctx.dec_round_keys, ctx_ref.dec_round_keys, (ctx.Nr + 1) * AES_BLOCK_SIZE) != 0) {
+                printf("AES-%d decryption key schedule mismatch (%s)\n", key_bits[k], AES_impl_name(impl));
+                return 1;
+            }
+            AES_set_impl(AES_IMPL_TABLE);
+            AES_ECB_encrypt_blocks(&ctx_ref, pt, blocks, ct_ref);
+            AES_set_impl(impl);
+            AES_ECB_encrypt_blocks(&ctx, pt, blocks, ct);
+            if (memcmp(ct, ct_ref, blocks * AES_BLOCK_SIZE) != 0) {
+                printf("AES-%d ECB encrypt mismatch, %zu blocks (%s)\n", key_bits[k], blocks, AES_impl_name(impl));
+                return 1;
+            }
+            AES_ECB_decrypt_blocks(&ctx, ct, blocks, ct);
+            if (memcmp(ct, pt, blocks * AES_BLOCK_SIZE) != 0) {
+                printf("AES-%d ECB decrypt mismatch, %zu blocks (%s)\n", key_bits[k], blocks, AES_impl_name(impl));
+                return 1;
+            }
+
+            memcpy(iv_ref, iv, AES_BLOCK_SIZE);
+            memcpy(iv_impl, iv, AES_BLOCK_SIZE);
+            AES_set_impl(AES_IMPL_TABLE);
+            AES_CBC_encrypt(&ctx_ref, pt, blocks * AES_BLOCK_SIZE, ct_ref, iv_ref);
+            AES_set_impl(impl);
+            AES_CBC_encrypt(&ctx, pt, blocks * AES_BLOCK_SIZE, ct, iv_impl);
+            if (memcmp(ct, ct_ref, blocks * AES_BLOCK_SIZE) != 0 || memcmp(iv_impl, iv_ref, AES_BLOCK_SIZE) != 0) {
+                printf("AES-%d CBC encrypt mismatch, %zu blocks (%s)\n", key_bits[k], blocks, AES_impl_name(impl));
+                return 1;
+            }
+            memcpy(iv_impl, iv, AES_BLOCK_SIZE);
+            AES_CBC_decrypt(&ctx, ct, blocks * AES_BLOCK_SIZE, ct, iv_impl);
+            if (memcmp(ct, pt, blocks * AES_BLOCK_SIZE) != 0 || memcmp(iv_impl, iv_ref, AES_BLOCK_SIZE) != 0) {
+                printf("AES-%d CBC decrypt mismatch, %zu blocks (%s)\n", key_bits[k], blocks, AES_impl_name(impl));
+                return 1;
+            }
+        }
+    }
+
+    // 블록 중간 오프셋: 첫 부분 블록의 키스트림도 선택된 구현의 CTR 커널로 만들어야 함
+    // (비트슬라이스가 선택되면 T-tables 단일 블록 경로를 타지 않아야 하므로 모든 오프셋 나머지와 짧은 길이를 확인)
+    if (impl == AES_IMPL_BITSLICE) {
+        uint8_t key[32], iv[AES_BLOCK_SIZE];
+        AES_CTX ctx_ref, ctx;
+        for (int i = 0; i < 32; i++) key[i] = test_rand_byte();
+        for (int i = 0; i < AES_BLOCK_SIZE; i++) iv[i] = test_rand_byte();
+        memset(iv + 8, 0xff, 8); // 첫 블록 직후 자리올림
+        for (size_t i = 0; i < 96; i++) pt[i] = test_rand_byte();
+        AES_set_impl(AES_IMPL_TABLE);
+        AES_set_key(&ctx_ref, key, 128);
+        uint8_t iv_ref[AES_BLOCK_SIZE];
+        memcpy(iv_ref, iv, AES_BLOCK_SIZE);
+        AES_CTR_crypt(&ctx_ref, pt, 96, ct_ref, iv_ref);
+
+        AES_set_impl(impl);
+        AES_set_key(&ctx, key, 128);
+        for (size_t off = 1; off < 48; off++) {
+            if (off % AES_BLOCK_SIZE == 0) continue;
+            size_t rest = AES_BLOCK_SIZE - off % AES_BLOCK_SIZE;
+            const size_t lengths[] = { 1, rest, rest + 1, 96 - off };
+            for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+                AES_CTR_crypt_at_serial(&ctx, iv, off, pt + off, lengths[l], ct);
+                if (memcmp(ct, ct_ref + off, lengths[l]) != 0) {
+                    printf("AES CTR_crypt_at unaligned mismatch, offset %zu, length %zu (%s)\n",
+                           off, lengths[l], AES_impl_name(impl));
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// 멀티스레드 CTR: 작업자 수를 강제해 직렬 결과(출력, 증가된 카운터)와 바이트 단위로 같은지 확인
+// 길이는 작업자 수로 나누어떨어지지 않게, 카운터는 하위 64비트 자리올림이 구간 경계에 걸리게 설정
+static int test_aes_ctr_parallel(void) {
+    static uint8_t pt[(1 << 20) + 5], ct_ref[(1 << 20) + 5], ct[(1 << 20) + 5];
+    const size_t lengths[] = { 200003, sizeof(pt) };
+    const int workers[] = { 2, 3, 7 };
+    uint8_t key[32];
+    AES_CTX ctx;
+
+    for (int i = 0; i < 32; i++) key[i] = test_rand_byte();
+    for (size_t i = 0; i < sizeof(pt); i++) pt[i] = test_rand_byte();
+    AES_set_key(&ctx, key, 256);
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        for (size_t w = 0; w < sizeof(workers) / sizeof(workers[0]); w++) {
+            uint8_t iv_ref[AES_BLOCK_SIZE], iv[AES_BLOCK_SIZE];
+            for (int i = 0; i < AES_BLOCK_SIZE; i++) iv_ref[i] = test_rand_byte();
+            memset(iv_ref + 8, 0xff, 6); // 약 65536블록(1MB) 이내에서 자리올림
+            memcpy(iv, iv_ref, AES_BLOCK_SIZE);
+
+            AES_CTR_set_parallel(0, 1);
+            AES_CTR_crypt(&ctx, pt, lengths[l], ct_ref, iv_ref);
+            AES_CTR_set_parallel(0, workers[w]);
+            memcpy(ct, pt, lengths[l]);
+            AES_CTR_crypt(&ctx, ct, lengths[l], ct, iv); // in-place
+            AES_CTR_set_parallel(256 * 1024, 0); // 기본값 복원
+
+            if (memcmp(ct, ct_ref, lengths[l]) != 0 || memcmp(iv, iv_ref, AES_BLOCK_SIZE) != 0) {
+                printf("AES CTR parallel mismatch, length %zu, %d workers\n", lengths[l], workers[w]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// AES 테스트: 사용 가능한 모든 구현에 대해 NIST 벡터 + 교차 검증 수행
+int test_aes(void) {
+    const AES_IMPL impls[] = { AES_IMPL_TABLE, AES_IMPL_BITSLICE, AES_IMPL_VPAES, AES_IMPL_AESNI, AES_IMPL_VAES_AVX2, AES_IMPL_VAES_AVX512 };
+    int failed = 0;
+
+    printf("=======================================\n");
+    printf("  NIST SP 800-38A CTR Mode Test Vector\n");
+    printf("=======================================\n");
+
+    for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+        if (!AES_impl_available(impls[i])) {
+            printf("[%s] not available on this CPU, skipped\n\n", AES_impl_name(impls[i]));
+            continue;
+        }
+        printf("[%s]\n", AES_impl_name(impls[i]));
+        AES_set_impl(impls[i]);
+        failed |= test_aes_nist_ctr();
+        failed |= test_aes_nist_ctr_multiblock();
+        failed |= test_aes_nist_cbc_multiblock();
+
+        int mismatch = test_aes_impl_consistency(impls[i]);
+        printf("Cross-check vs table: %s\n", mismatch ? "FAIL" : "PASS");
+        failed |= mismatch;
+
+        mismatch = test_aes_ctr_parallel();
+        printf("Multi-threaded CTR vs serial: %s\n\n", mismatch ? "FAIL" : "PASS");
+        failed |= mismatch;
+    }
+
+    AES_set_impl(AES_IMPL_AUTO);
+    return failed ? 1 : 0;
+}
+
+// ---- 파일 계층 테스트 (cli.c를 FILE_CRYPTO_NO_MAIN으로 함께 링크) ----
+// 작업 디렉터리에 아래 이름의 파일을 만들고 끝나면 지움
+#define FC_PLAIN "fc_test_plain.bin"
+#define FC_ENC "fc_test.enc"
+#define FC_ENC2 "fc_test2.enc"
+#define FC_ENC3 "fc_test3.enc"
+#define FC_BAD "fc_test_bad.enc"
+#define FC_OUT "fc_test_out.bin"
+#define FC_PASSWORD "Test1234"
+#define FC_CHUNK 65536
+
+// 진행률 콜백: 출력 없이 마지막 값만 기록
+typedef struct {
+    long processed;
+    long total;
+} FcProgress;
+
+static void fc_progress(long processed, long total, void* user_data) {
+    FcProgress* p = (FcProgress*)user_data;
+    p->processed = processed;
+    p->total = total;
+}
+
+static int fc_encrypt(const char* in, const char* out, int aes_key_bits, const char* password) {
+    FcProgress p = { 0, 0 };
+    return encrypt_file_with_progress(in, out, aes_key_bits, password, fc_progress, &p);
+}
+
+static int fc_decrypt(const char* in, const char* out, const char* password) {
+    FcProgress p = { 0, 0 };
+    char final_path[512];
+    int ok = decrypt_file_with_progress(in, out, password, final_path, sizeof(final_path), fc_progress, &p);
+    return ok && strcmp(final_path, out) == 0 && p.processed == p.total;
+}
+
+// 파일 전체를 메모리로 읽음 (실패하면 NULL)
+static uint8_t* fc_load(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* data = (uint8_t*)malloc(n > 0 ? (size_t)n : 1);
+    if (data && fread(data, 1, (size_t)n, f) != (size_t)n) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    if (data) *size = (size_t)n;
+    return data;
+}
+
+static int fc_store(const char* path, const uint8_t* data, size_t size) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return 0;
+    int ok = fwrite(data, 1, size, f) == size;
+    return fclose(f) == 0 && ok;
+}
+
+static int fc_same(const char* path, const uint8_t* data, size_t size) {
+    size_t n = 0;
+    uint8_t* got = fc_load(path, &n);
+    int same = got && n == size && memcmp(got, data, size) == 0;
+    free(got);
+    return same;
+}
+
+static int fc_exists(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f) fclose(f);
+    return f != NULL;
+}
+
+// target 옆에 복호화 임시 파일(target.xxxxxxxx.tmp)이 남아 있는지
+static int fc_temp_left(const char* target) {
+    char pattern[256];
+    snprintf(pattern, sizeof(pattern), "%s.*.tmp", target);
+#ifdef _WIN32
+    WIN32_FIND_DATAA fd;
+    HANDLE h = FindFirstFileA(pattern, &fd);
+    if (h == INVALID_HANDLE_VALUE) return 0;
+    FindClose(h);
+    return 1;
+#else
+    glob_t g;
+    int found = glob(pattern, 0, NULL, &g) == 0 && g.gl_pathc > 0;
+    globfree(&g);
+    return found;
+#endif
+}
+
+// 복호화가 실패해야 하는 파일: 복호화/검증이 모두 실패하고, 출력 경로의 기존 파일이 그대로이며 임시 파일이 없어야 함
+// 구간 리더는 열리지 않거나, 열리더라도 전체 읽기가 실패해야 함
+static int fc_expect_rejected(const char* name, const uint8_t* data, size_t size) {
+    static const uint8_t keep[] = "existing output";
+    int failed = 0;
+
+    fc_store(FC_BAD, data, size);
+    fc_store(FC_OUT, keep, sizeof(keep));
+    if (fc_decrypt(FC_BAD, FC_OUT, FC_PASSWORD) || verify_encrypted_file(FC_BAD, FC_PASSWORD)) {
+        printf("Rejected file accepted: %s\n", name);
+        failed = 1;
+    }
+    if (!fc_same(FC_OUT, keep, sizeof(keep)) || fc_temp_left(FC_OUT)) {
+        printf("Output path touched after failure: %s\n", name);
+        failed = 1;
+    }
+
+    EncRangeReader* reader = enc_range_open(FC_BAD, FC_PASSWORD);
+    if (reader) {
+        size_t len = (size_t)enc_range_size(reader);
+        uint8_t* buf = (uint8_t*)malloc(len > 0 ? len : 1);
+        size_t got = 0;
+        if (!buf || enc_range_read(reader, 0, len, buf, &got)) {
+            printf("Range read accepted: %s\n", name);
+            failed = 1;
+        }
+        free(buf);
+        enc_range_close(reader);
+    }
+    platform_remove(FC_BAD);
+    platform_remove(FC_OUT);
+    return failed;
+}
+
+// 암호화 -> 검증 -> 복호화 후 원문과 비교하고, v4면 청크 경계에 걸친 구간을 enc_range_read로 읽어 비교
+static int test_file_roundtrip(size_t size, int aes_key_bits) {
+    uint8_t* plain = (uint8_t*)malloc(size > 0 ? size : 1);
+    uint8_t* buf = (uint8_t*)malloc(size > 0 ? size : 1);
+    int failed = 0;
+    if (!plain || !buf) {
+        free(plain);
+        free(buf);
+        return 1;
+    }
+    for (size_t i = 0; i < size; i++) plain[i] = test_rand_byte();
+
+    if (!fc_store(FC_PLAIN, plain, size) ||
+        !fc_encrypt(FC_PLAIN, FC_ENC, aes_key_bits, FC_PASSWORD) ||
+        !verify_encrypted_file(FC_ENC, FC_PASSWORD) ||
+        !fc_decrypt(FC_ENC, FC_OUT, FC_PASSWORD) || !fc_same(FC_OUT, plain, size)) {
+        printf("File round trip failed, %zu bytes, AES-%d\n", size, aes_key_bits);
+        failed = 1;
+    }
+    if (get_encrypt_chunk_size() == 0) {   // v3는 구간 읽기를 지원하지 않음
+        platform_remove(FC_PLAIN);
+        platform_remove(FC_ENC);
+        platform_remove(FC_OUT);
+        free(plain);
+        free(buf);
+        return failed;
+    }
+
+    // 구간: 전체, 첫 청크 경계 앞에서 세 청크에 걸침, 끝 3바이트부터 파일 끝 너머(잘림), 파일 끝(0바이트)
+    const uint64_t offsets[] = { 0, FC_CHUNK - 5, size > 3 ? size - 3 : 0, size };
+    const size_t lengths[] = { size, 2 * FC_CHUNK + 10, 100, 1 };
+    EncRangeReader* reader = enc_range_open(FC_ENC, FC_PASSWORD);
+    if (!reader || enc_range_size(reader) != size) {
+        printf("Range reader open failed, %zu bytes\n", size);
+        failed = 1;
+    }
+    for (size_t i = 0; reader && i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        if (offsets[i] > size) continue;
+        size_t expect = (lengths[i] < size - offsets[i]) ? lengths[i] : (size_t)(size - offsets[i]);
+        size_t got = 0;
+        if (!enc_range_read(reader, offsets[i], lengths[i], buf, &got) || got != expect ||
+            memcmp(buf, plain + offsets[i], expect) != 0) {
+            printf("Range read mismatch, %zu bytes, offset %llu\n", size, (unsigned long long)offsets[i]);
+            failed = 1;
+        }
+    }
+    if (reader && enc_range_read(reader, (uint64_t)size + 1, 1, buf, NULL)) {
+        printf("Range read past end accepted, %zu bytes\n", size);
+        failed = 1;
+    }
+    enc_range_close(reader);
+
+    platform_remove(FC_PLAIN);
+    platform_remove(FC_ENC);
+    platform_remove(FC_OUT);
+    free(plain);
+    free(buf);
+    return failed;
+}
+
+// v4 변조: 청크 교환, 암호문/태그/트레일러/반복 횟수/청크 크기 수정, 잘림, 덧붙임, 틀린 패스워드
+static int test_file_tamper(void) {
+    const size_t size = 3 * FC_CHUNK + 100;   // 청크 4개 (마지막은 짧음)
+    const size_t data_pos = ENC_HEADER_SIZE + ENC_KDF_PARAMS_SIZE + ENC_CHUNK_PARAMS_SIZE;
+    const size_t tags_pos = data_pos + size;
+    uint8_t* plain = (uint8_t*)malloc(size);
+    uint8_t* enc = NULL;
+    size_t enc_size = 0;
+    int failed = 0;
+    if (!plain) return 1;
+    for (size_t i = 0; i < size; i++) plain[i] = test_rand_byte();
+    if (!fc_store(FC_PLAIN, plain, size) || !fc_encrypt(FC_PLAIN, FC_ENC, 256, FC_PASSWORD) ||
+        !(enc = fc_load(FC_ENC, &enc_size)) || enc_size != tags_pos + 4 * ENC_CHUNK_TAG_SIZE + ENC_CHUNK_TRAILER_SIZE) {
+        printf("Cannot prepare v4 file\n");
+        free(plain);
+        free(enc);
+        return 1;
+    }
+    const size_t trailer_pos = enc_size - ENC_CHUNK_TRAILER_SIZE;
+    uint8_t* bad = (uint8_t*)malloc(enc_size + 1);
+    if (!bad) {
+        free(plain);
+        free(enc);
+        return 1;
+    }
+
+    // 청크 0과 1 교환 (태그는 청크 번호를 덮으므로 실패해야 함)
+    memcpy(bad, enc, enc_size);
+    memcpy(bad + data_pos, enc + data_pos + FC_CHUNK, FC_CHUNK);
+    memcpy(bad + data_pos + FC_CHUNK, enc + data_pos, FC_CHUNK);
+    failed |= fc_expect_rejected("swapped chunks", bad, enc_size);
+
+    // 단일 바이트 수정: 마지막 청크 암호문, 청크 태그, 트레일러의 크기/청크 수/MAC, 반복 횟수, 청크 크기, 헤더
+    const struct { const char* name; size_t pos; } flips[] = {
+        { "ciphertext byte", data_pos + 3 * FC_CHUNK + 7 },
+        { "chunk tag", tags_pos + ENC_CHUNK_TAG_SIZE + 3 },
+        { "trailer plaintext size", trailer_pos + 7 },
+        { "trailer chunk count", trailer_pos + 15 },
+        { "trailer MAC", trailer_pos + 16 + 20 },
+        { "iteration count", ENC_HEADER_SIZE + 19 },
+        { "chunk size", ENC_HEADER_SIZE + ENC_KDF_PARAMS_SIZE + 1 },
+        { "header nonce", 8 },
+    };
+    for (size_t i = 0; i < sizeof(flips) / sizeof(flips[0]); i++) {
+        memcpy(bad, enc, enc_size);
+        bad[flips[i].pos] ^= 0x01;
+        failed |= fc_expect_rejected(flips[i].name, bad, enc_size);
+    }
+
+    // 잘림 (마지막 바이트, 트레일러 전체, 청크 파라미터까지만) 및 덧붙임
+    failed |= fc_expect_rejected("truncated by 1 byte", enc, enc_size - 1);
+    failed |= fc_expect_rejected("truncated trailer", enc, trailer_pos);
+    failed |= fc_expect_rejected("truncated to header", enc, data_pos);
+    memcpy(bad, enc, enc_size);
+    bad[enc_size] = 0;
+    failed |= fc_expect_rejected("appended byte", bad, enc_size + 1);
+
+    // 틀린 패스워드 (원본 파일 그대로)
+    fc_store(FC_OUT, plain, 16);
+    if (fc_decrypt(FC_ENC, FC_OUT, "Wrong1234") || verify_encrypted_file(FC_ENC, "Wrong1234") ||
+        enc_range_open(FC_ENC, "Wrong1234") || !fc_same(FC_OUT, plain, 16)) {
+        printf("Wrong password accepted\n");
+        failed = 1;
+    }
+
+    platform_remove(FC_PLAIN);
+    platform_remove(FC_ENC);
+    platform_remove(FC_OUT);
+    free(plain);
+    free(enc);
+    free(bad);
+    return failed;
+}
+
+// v1/v2 파일을 직접 만듦 (암호화 함수는 v3/v4만 기록하므로 호환성 테스트용, AES-256)
+// v1 = 헤더 | HMAC | 암호문 (고정 솔트, 반복 10000회), v2 = 헤더 | 파라미터 | HMAC | 암호문. HMAC은 평문을 덮음
+static int fc_write_legacy(const char* path, uint8_t version, const uint8_t* plain, size_t size, uint32_t iterations) {
+    EncFileHeader header;
+    EncKdfParams kdf;
+    HMAC_SHA512_CTX mac_ctx;
+    AES_CTX aes_ctx;
+    uint8_t key[64], mac[ENC_HMAC_SIZE], counter[AES_BLOCK_SIZE];
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.signature, ENC_SIGNATURE, 4);
+    header.version = version;
+    header.key_length_code = 0x03;
+    header.mode_code = ENC_MODE_CTR;
+    header.hmac_enabled = ENC_HMAC_ENABLED;
+    for (int i = 0; i < ENC_NONCE_SIZE; i++) header.nonce[i] = (uint8_t)(0xA0 + i);
+    memcpy(header.format, ".bin", 4);
+    memset(&kdf, 0, sizeof(kdf));
+    for (int i = 0; i < ENC_KDF_SALT_SIZE; i++) kdf.salt[i] = (uint8_t)(0x50 + i);
+    for (int i = 0; i < 4; i++) kdf.iterations[i] = (uint8_t)(iterations >> (24 - 8 * i));
+
+    // 키 = PBKDF2 출력의 앞 32바이트(AES), 32~56바이트(HMAC)
+    if (version == ENC_VERSION) {
+        pbkdf2_sha512((const uint8_t*)FC_PASSWORD, strlen(FC_PASSWORD), NULL, 0, KDF_DEFAULT_ITERATIONS, key, 64);
+    } else {
+        pbkdf2_sha512((const uint8_t*)FC_PASSWORD, strlen(FC_PASSWORD), kdf.salt, ENC_KDF_SALT_SIZE, iterations, key, 64);
+    }
+    hmac_sha512_init(&mac_ctx, key + 32, 24);
+    hmac_sha512_update(&mac_ctx, (const uint8_t*)&header, sizeof(header));
+    if (version != ENC_VERSION) hmac_sha512_update(&mac_ctx, (const uint8_t*)&kdf, sizeof(kdf));
+    hmac_sha512_update(&mac_ctx, plain, size);
+    hmac_sha512_final(&mac_ctx, mac);
+
+    uint8_t* ct = (uint8_t*)malloc(size > 0 ? size : 1);
+    if (!ct) return 0;
+    memcpy(counter, header.nonce, 8);
+    memset(counter + 8, 0, 8);
+    AES_set_key(&aes_ctx, key, 256);
+    AES_CTR_crypt(&aes_ctx, plain, size, ct, counter);
+
+    FILE* f = fopen(path, "wb");
+    int ok = f != NULL;
+    if (ok) {
+        ok = fwrite(&header, 1, sizeof(header), f) == sizeof(header) &&
+             (version == ENC_VERSION || fwrite(&kdf, 1, sizeof(kdf), f) == sizeof(kdf)) &&
+             fwrite(mac, 1, sizeof(mac), f) == sizeof(mac) &&
+             fwrite(ct, 1, size, f) == size;
+        ok = (fclose(f) == 0) && ok;
+    }
+    free(ct);
+    return ok;
+}
+
+// v1/v2 헤더 읽기: 정상 파일은 복호화/검증되고, 범위를 벗어난 반복 횟수와 모르는 플래그는 키 도출 전에 거부
+static int test_file_v2_header(void) {
+    const size_t sizes[] = { 0, 1, 100000 };
+    const size_t iter_pos = ENC_HEADER_SIZE + ENC_KDF_SALT_SIZE;
+    const size_t flags_pos = iter_pos + 4;
+    uint8_t* plain = (uint8_t*)malloc(100000);
+    uint8_t* enc = NULL;
+    size_t enc_size = 0;
+    int failed = 0;
+    if (!plain) return 1;
+    for (size_t i = 0; i < 100000; i++) plain[i] = test_rand_byte();
+
+    if (!fc_write_legacy(FC_ENC, ENC_VERSION, plain, 100000, 0) || read_aes_key_length(FC_ENC) != 256 ||
+        !verify_encrypted_file(FC_ENC, FC_PASSWORD) || !fc_decrypt(FC_ENC, FC_OUT, FC_PASSWORD) ||
+        !fc_same(FC_OUT, plain, 100000)) {
+        printf("v1 file not decrypted\n");
+        failed = 1;
+    }
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        if (!fc_write_legacy(FC_ENC, ENC_VERSION_2, plain, sizes[i], ENC_KDF_MIN_ITERATIONS) ||
+            read_aes_key_length(FC_ENC) != 256 || !verify_encrypted_file(FC_ENC, FC_PASSWORD) ||
+            !fc_decrypt(FC_ENC, FC_OUT, FC_PASSWORD) || !fc_same(FC_OUT, plain, sizes[i])) {
+            printf("v2 file not decrypted, %zu bytes\n", sizes[i]);
+            failed = 1;
+        }
+    }
+
+    // 아래는 100000바이트 v2 파일의 파라미터를 바꿈
+    if (!fc_write_legacy(FC_ENC, ENC_VERSION_2, plain, 100000, ENC_KDF_MIN_ITERATIONS) ||
+        !(enc = fc_load(FC_ENC, &enc_size))) {
+        free(plain);
+        return 1;
+    }
+    const uint32_t bad_iterations[] = { 0, ENC_KDF_MIN_ITERATIONS - 1, ENC_KDF_MAX_ITERATIONS + 1, 0xFFFFFFFFu };
+    const uint8_t bad_flags[] = { 0x02, 0x80, ENC_KDF_FLAG_SUBKEYS | 0x04 };
+    for (size_t i = 0; i < sizeof(bad_iterations) / sizeof(bad_iterations[0]); i++) {
+        for (int b = 0; b < 4; b++) enc[iter_pos + b] = (uint8_t)(bad_iterations[i] >> (24 - 8 * b));
+        fc_store(FC_BAD, enc, enc_size);
+        if (read_aes_key_length(FC_BAD) != 0) {
+            printf("v2 iteration count %u accepted by header reader\n", (unsigned)bad_iterations[i]);
+            failed = 1;
+        }
+        failed |= fc_expect_rejected("v2 iteration count out of range", enc, enc_size);
+    }
+    // 범위 안의 다른 반복 횟수는 헤더는 통과하지만 키가 달라져 HMAC에서 실패
+    for (int b = 0; b < 4; b++) enc[iter_pos + b] = (uint8_t)((ENC_KDF_MIN_ITERATIONS + 1) >> (24 - 8 * b));
+    failed |= fc_expect_rejected("v2 iteration count edited", enc, enc_size);
+    for (int b = 0; b < 4; b++) enc[iter_pos + b] = (uint8_t)(ENC_KDF_MIN_ITERATIONS >> (24 - 8 * b));
+
+    for (size_t i = 0; i < sizeof(bad_flags) / sizeof(bad_flags[0]); i++) {
+        enc[flags_pos] = bad_flags[i];
+        fc_store(FC_BAD, enc, enc_size);
+        if (read_aes_key_length(FC_BAD) != 0) {
+            printf("v2 flags 0x%02x accepted by header reader\n", bad_flags[i]);
+            failed = 1;
+        }
+        failed |= fc_expect_rejected("v2 unknown KDF flags", enc, enc_size);
+    }
+    enc[flags_pos] = 0;
+    enc[flags_pos + 1] ^= 0x01;   // 파라미터의 예약 바이트도 HMAC에 포함됨
+    failed |= fc_expect_rejected("v2 KDF reserved byte", enc, enc_size);
+
+    platform_remove(FC_ENC);
+    platform_remove(FC_OUT);
+    free(plain);
+    free(enc);
+    return failed;
+}
+
+// v1/v2/v3 파일을 씀 (v3는 청크 크기 0으로 암호화 함수가 기록, AES-256)
+static int fc_write_unchunked(uint8_t version, const uint8_t* plain, size_t size) {
+    if (version != ENC_VERSION_3) {
+        return fc_write_legacy(FC_ENC, version, plain, size, ENC_KDF_MIN_ITERATIONS);
+    }
+    set_encrypt_chunk_size(0);
+    int ok = fc_store(FC_PLAIN, plain, size) && fc_encrypt(FC_PLAIN, FC_ENC, 256, FC_PASSWORD);
+    set_encrypt_chunk_size(FC_CHUNK);
+    platform_remove(FC_PLAIN);
+    return ok;
+}
+
+// v1/v2/v3 복호화를 파이프라인(작업자 3)과 순차 처리(작업자 1)로 각각 확인
+// 파이프라인 링이 여러 번 돌도록 수 MB 파일을 포함하고, 암호문/HMAC이 변조되면 출력 없이 실패해야 함
+static int test_file_legacy_pipeline(void) {
+    const size_t sizes[] = { 0, 1, 512 * 1024 + 1, 5 * 1024 * 1024 + 33 };
+    const int workers[] = { 3, 1 };
+    const char* names[] = { "v1 HMAC mismatch", "v2 HMAC mismatch", "v3 HMAC mismatch" };
+    const size_t max_size = 5 * 1024 * 1024 + 33;
+    const int saved_workers = get_file_crypto_workers();
+    uint8_t* plain = (uint8_t*)malloc(max_size);
+    uint8_t* enc = NULL;
+    size_t enc_size = 0;
+    int failed = 0;
+    if (!plain) return 1;
+    for (size_t i = 0; i < max_size; i++) plain[i] = test_rand_byte();
+
+    for (size_t w = 0; w < sizeof(workers) / sizeof(workers[0]); w++) {
+        set_file_crypto_workers(workers[w]);
+        for (int version = ENC_VERSION; version <= ENC_VERSION_3; version++) {
+            for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+                if (!fc_write_unchunked((uint8_t)version, plain, sizes[i]) ||
+                    !verify_encrypted_file(FC_ENC, FC_PASSWORD) || !fc_decrypt(FC_ENC, FC_OUT, FC_PASSWORD) ||
+                    !fc_same(FC_OUT, plain, sizes[i])) {
+                    printf("v%d file not decrypted, %zu bytes, %d workers\n", version, sizes[i], workers[w]);
+                    failed = 1;
+                }
+            }
+
+            // 변조: 마지막 슬롯의 암호문, 앞쪽 암호문, 저장된 HMAC
+            if (!fc_write_unchunked((uint8_t)version, plain, max_size) || !(enc = fc_load(FC_ENC, &enc_size))) {
+                failed = 1;
+                continue;
+            }
+            const size_t hmac_pos = (version == ENC_VERSION) ? ENC_HEADER_SIZE : ENC_HEADER_SIZE + ENC_KDF_PARAMS_SIZE;
+            const size_t flips[] = { enc_size - 1, hmac_pos + ENC_HMAC_SIZE + 100, hmac_pos + 5 };
+            for (size_t i = 0; i < sizeof(flips) / sizeof(flips[0]); i++) {
+                enc[flips[i]] ^= 0x01;
+                failed |= fc_expect_rejected(names[version - ENC_VERSION], enc, enc_size);
+                enc[flips[i]] ^= 0x01;
+            }
+            free(enc);
+            enc = NULL;
+        }
+    }
+
+    set_file_crypto_workers(saved_workers);
+    platform_remove(FC_ENC);
+    platform_remove(FC_OUT);
+    free(plain);
+    return failed;
+}
+
+// 부분 복호화 (인증 없음): v1/v2/v3 파일에서 블록 경계가 아닌 구간과 파일 끝을 넘는 구간을 평문과 비교
+static int test_file_range_unauthenticated(void) {
+    const size_t size = 300 * 1024 + 7;
+    const uint64_t offsets[] = { 0, 5, 100003, size - 9, size };
+    const size_t length = 5000;
+    uint8_t* plain = (uint8_t*)malloc(size);
+    uint8_t* out = (uint8_t*)malloc(length);
+    int failed = 0;
+    if (!plain || !out) {
+        free(plain);
+        free(out);
+        return 1;
+    }
+    for (size_t i = 0; i < size; i++) plain[i] = test_rand_byte();
+    fc_store(FC_PLAIN, plain, size);
+
+    for (int version = ENC_VERSION; version <= ENC_VERSION_3; version++) {
+        int written;
+        if (version == ENC_VERSION_3) {
+            set_encrypt_chunk_size(0);
+            written = fc_encrypt(FC_PLAIN, FC_ENC, 128, FC_PASSWORD);
+            set_encrypt_chunk_size(FC_CHUNK);
+        } else {
+            written = fc_write_legacy(FC_ENC, (uint8_t)version, plain, size, ENC_KDF_MIN_ITERATIONS);
+        }
+        if (!written) {
+            printf("v%d file not written\n", version);
+            failed = 1;
+            continue;
+        }
+        for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+            const size_t expected = (size - offsets[i] < length) ? (size_t)(size - offsets[i]) : length;
+            size_t got = 0;
+            if (!decrypt_file_range_unauthenticated(FC_ENC, FC_PASSWORD, offsets[i], length, out, &got) ||
+                got != expected || memcmp(out, plain + offsets[i], got) != 0) {
+                printf("v%d range at %llu not decrypted\n", version, (unsigned long long)offsets[i]);
+                failed = 1;
+            }
+        }
+        size_t got = 1;
+        if (decrypt_file_range_unauthenticated(FC_ENC, FC_PASSWORD, (uint64_t)size + 1, 1, out, &got) || got != 0) {
+            printf("v%d range past the end accepted\n", version);
+            failed = 1;
+        }
+    }
+
+    platform_remove(FC_PLAIN);
+    platform_remove(FC_ENC);
+    free(plain);
+    free(out);
+    return failed;
+}
+
+// 일괄 암호화한 파일의 키를 헤더에서 직접 계산: 마스터 키 = PBKDF2(salt, iterations), 키 = HKDF(reserved || nonce, 마스터 키)
+static void fc_batch_keys(const uint8_t* enc, uint8_t key[64]) {
+    static const char info[] = "AESC file subkeys";
+    EncFileHeader header;
+    EncKdfParams kdf;
+    uint8_t master[64], salt[ENC_KDF_SALT_SIZE + ENC_NONCE_SIZE];
+    memcpy(&header, enc, sizeof(header));
+    memcpy(&kdf, enc + ENC_HEADER_SIZE, sizeof(kdf));
+    uint32_t iterations = ((uint32_t)kdf.iterations[0] << 24) | ((uint32_t)kdf.iterations[1] << 16) |
+                          ((uint32_t)kdf.iterations[2] << 8) | (uint32_t)kdf.iterations[3];
+    pbkdf2_sha512((const uint8_t*)FC_PASSWORD, strlen(FC_PASSWORD), kdf.salt, ENC_KDF_SALT_SIZE, iterations, master, 64);
+    memcpy(salt, header.reserved, ENC_KDF_SALT_SIZE);
+    memcpy(salt + ENC_KDF_SALT_SIZE, header.nonce, ENC_NONCE_SIZE);
+    hkdf_sha512(salt, sizeof(salt), master, 64, (const uint8_t*)info, sizeof(info) - 1, key, 64);
+}
+
+// 일괄 암호화 세션: 같은 패스워드로 암호화한 두 파일은 ENC_KDF_FLAG_SUBKEYS와 세션 공통 솔트,
+// 파일별 솔트(헤더 reserved)를 기록해 서로 다른 키를 쓰고 각각 따로 복호화됨
+// 세션 중 다른 패스워드로 암호화한 파일은 세션을 쓰지 않고 파일별 PBKDF2로 돌아감
+static int test_file_batch_session(void) {
+    const size_t size = FC_CHUNK + 1000;
+    const size_t data_pos = ENC_HEADER_SIZE + ENC_KDF_PARAMS_SIZE + ENC_CHUNK_PARAMS_SIZE;
+    static const uint8_t zero[ENC_KDF_SALT_SIZE] = { 0 };
+    uint8_t* plain = (uint8_t*)malloc(size);
+    uint8_t *a = NULL, *b = NULL, *c = NULL;
+    size_t a_size = 0, b_size = 0, c_size = 0;
+    int failed = 0;
+    if (!plain) return 1;
+    for (size_t i = 0; i < size; i++) plain[i] = test_rand_byte();
+
+    int ok = fc_store(FC_PLAIN, plain, size) && encrypt_batch_begin(FC_PASSWORD);
+    ok = ok && fc_encrypt(FC_PLAIN, FC_ENC, 256, FC_PASSWORD) && fc_encrypt(FC_PLAIN, FC_ENC2, 256, FC_PASSWORD) &&
+         fc_encrypt(FC_PLAIN, FC_ENC3, 256, "Other1234");
+    encrypt_batch_end();
+    kdf_cache_wipe();   // 복호화는 세션이나 캐시 없이 헤더만으로 키를 도출해야 함
+    if (!ok || !(a = fc_load(FC_ENC, &a_size)) || !(b = fc_load(FC_ENC2, &b_size)) || !(c = fc_load(FC_ENC3, &c_size))) {
+        printf("Batch session encryption failed\n");
+        failed = 1;
+    } else {
+        EncFileHeader ha, hb, hc;
+        EncKdfParams ka, kb, kc;
+        memcpy(&ha, a, sizeof(ha));
+        memcpy(&hb, b, sizeof(hb));
+        memcpy(&hc, c, sizeof(hc));
+        memcpy(&ka, a + ENC_HEADER_SIZE, sizeof(ka));
+        memcpy(&kb, b + ENC_HEADER_SIZE, sizeof(kb));
+        memcpy(&kc, c + ENC_HEADER_SIZE, sizeof(kc));
+        if (ka.flags != ENC_KDF_FLAG_SUBKEYS || kb.flags != ENC_KDF_FLAG_SUBKEYS ||
+            memcmp(ka.salt, kb.salt, ENC_KDF_SALT_SIZE) != 0 ||
+            memcmp(ha.reserved, hb.reserved, ENC_KDF_SALT_SIZE) == 0 ||
+            memcmp(ha.reserved, zero, ENC_KDF_SALT_SIZE) == 0 || memcmp(hb.reserved, zero, ENC_KDF_SALT_SIZE) == 0) {
+            printf("Batch files missing subkey flag or per-file salt\n");
+            failed = 1;
+        }
+        if (kc.flags != 0 || memcmp(hc.reserved, zero, ENC_KDF_SALT_SIZE) != 0 ||
+            memcmp(kc.salt, ka.salt, ENC_KDF_SALT_SIZE) == 0) {
+            printf("Other password did not fall back to per-file PBKDF2\n");
+            failed = 1;
+        }
+
+        // 두 파일의 키가 다르고, 계산한 키로 첫 블록이 평문으로 복호화되는지
+        uint8_t key_a[64], key_b[64], counter[AES_BLOCK_SIZE], block[AES_BLOCK_SIZE];
+        AES_CTX aes_ctx;
+        fc_batch_keys(a, key_a);
+        fc_batch_keys(b, key_b);
+        memcpy(counter, ha.nonce, 8);
+        memset(counter + 8, 0, 8);
+        AES_set_key(&aes_ctx, key_a, 256);
+        AES_CTR_crypt(&aes_ctx, a + data_pos, AES_BLOCK_SIZE, block, counter);
+        if (memcmp(key_a, key_b, 32) == 0 || memcmp(key_a + 32, key_b + 32, 24) == 0 ||
+            memcmp(block, plain, AES_BLOCK_SIZE) != 0) {
+            printf("Batch files do not use distinct per-file keys\n");
+            failed = 1;
+        }
+    }
+
+    if (!fc_decrypt(FC_ENC, FC_OUT, FC_PASSWORD) || !fc_same(FC_OUT, plain, size) ||
+        !fc_decrypt(FC_ENC2, FC_OUT, FC_PASSWORD) || !fc_same(FC_OUT, plain, size) ||
+        !fc_decrypt(FC_ENC3, FC_OUT, "Other1234") || !fc_same(FC_OUT, plain, size) ||
+        !verify_encrypted_file(FC_ENC, FC_PASSWORD) || !verify_encrypted_file(FC_ENC2, FC_PASSWORD) ||
+        verify_encrypted_file(FC_ENC3, FC_PASSWORD)) {
+        printf("Batch files not decrypted individually\n");
+        failed = 1;
+    }
+
+    platform_remove(FC_PLAIN);
+    platform_remove(FC_ENC);
+    platform_remove(FC_ENC2);
+    platform_remove(FC_ENC3);
+    platform_remove(FC_OUT);
+    free(plain);
+    free(a);
+    free(b);
+    free(c);
+    return failed;
+}
+
+// v4 청크 엔진 작업자 수 1, 3, 0(CPU 수)으로 왕복 (청크 2개, 11개: 작업자 수로 나누어떨어지지 않음)
+// 청크 하나가 변조되면 엔진이 남은 청크를 가져가지 않고 멈추며, 출력 없이 임시 파일을 지우는지 확인
+static int test_file_workers(void) {
+    const int workers[] = { 1, 3, 0 };
+    const size_t sizes[] = { FC_CHUNK + 1, 10 * FC_CHUNK + 77 };
+    const size_t size = 10 * FC_CHUNK + 77;
+    const size_t data_pos = ENC_HEADER_SIZE + ENC_KDF_PARAMS_SIZE + ENC_CHUNK_PARAMS_SIZE;
+    const int saved_workers = get_file_crypto_workers();
+    uint8_t* plain = (uint8_t*)malloc(size);
+    uint8_t* enc = NULL;
+    size_t enc_size = 0;
+    int failed = 0;
+    if (!plain) return 1;
+
+    for (size_t w = 0; w < sizeof(workers) / sizeof(workers[0]); w++) {
+        set_file_crypto_workers(workers[w]);
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            if (test_file_roundtrip(sizes[i], 256)) {
+                printf("Round trip failed with %d workers\n", workers[w]);
+                failed = 1;
+            }
+        }
+    }
+
+    // 3개로 암호화한 파일의 청크 2를 변조해 작업자 수마다 복호화/검증
+    for (size_t i = 0; i < size; i++) plain[i] = test_rand_byte();
+    set_file_crypto_workers(3);
+    if (!fc_store(FC_PLAIN, plain, size) || !fc_encrypt(FC_PLAIN, FC_ENC, 256, FC_PASSWORD) ||
+        !(enc = fc_load(FC_ENC, &enc_size))) {
+        set_file_crypto_workers(saved_workers);
+        free(plain);
+        return 1;
+    }
+    enc[data_pos + 2 * FC_CHUNK + 5] ^= 0x01;
+    for (size_t w = 0; w < sizeof(workers) / sizeof(workers[0]); w++) {
+        set_file_crypto_workers(workers[w]);
+        failed |= fc_expect_rejected("corrupted chunk", enc, enc_size);
+    }
+
+    // 작업자 1개는 청크 0, 1만 처리하고 청크 2에서 멈춰야 함 (진행률은 2청크에서 끝남)
+    FcProgress p = { 0, 0 };
+    char final_path[512];
+    set_file_crypto_workers(1);
+    fc_store(FC_BAD, enc, enc_size);
+    if (decrypt_file_with_progress(FC_BAD, FC_OUT, FC_PASSWORD, final_path, sizeof(final_path), fc_progress, &p) ||
+        p.processed != 2 * FC_CHUNK || fc_exists(FC_OUT) || fc_temp_left(FC_OUT)) {
+        printf("Chunk engine did not stop at the corrupted chunk (processed %ld)\n", p.processed);
+        failed = 1;
+    }
+
+    set_file_crypto_workers(saved_workers);
+    platform_remove(FC_PLAIN);
+    platform_remove(FC_ENC);
+    platform_remove(FC_BAD);
+    free(plain);
+    free(enc);
+    return failed;
+}
+
+// 파일 계층 테스트: 크기별 왕복과 구간 읽기, 변조된 파일 거부, 청크 엔진 작업자 수, v1/v2 헤더와 파이프라인, 일괄 암호화 세션
+int test_file_crypto(void) {
+    const size_t sizes[] = { 0, 1, FC_CHUNK - 1, FC_CHUNK, FC_CHUNK + 1, 3 * 1024 * 1024 + 123 };
+    const int key_bits[] = { 128, 192, 256 };
+    uint32_t saved_iterations = get_encrypt_kdf_iterations();
+    size_t saved_chunk_size = get_encrypt_chunk_size();
+    int failed = 0;
+
+    printf("=======================================\n");
+    printf("  File Encryption Layer\n");
+    printf("=======================================\n");
+
+    set_encrypt_kdf_iterations(ENC_KDF_MIN_ITERATIONS);   // 테스트 시간 단축
+    set_encrypt_chunk_size(FC_CHUNK);
+
+    int mismatch = 0;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        mismatch |= test_file_roundtrip(sizes[i], key_bits[i % 3]);
+    }
+    printf("v4 round trip and range reads: %s\n", mismatch ? "FAIL" : "PASS");
+    failed |= mismatch;
+
+    // v3 (청크 없음). 빈 파일은 HMAC이 헤더와 파라미터만 덮음
+    set_encrypt_chunk_size(0);
+    mismatch = 0;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        mismatch |= test_file_roundtrip(sizes[i], key_bits[i % 3]);
+    }
+    set_encrypt_chunk_size(FC_CHUNK);
+    printf("v3 round trip: %s\n", mismatch ? "FAIL" : "PASS");
+    failed |= mismatch;
+
+    mismatch = test_file_tamper();
+    printf("v4 tampered files rejected: %s\n", mismatch ? "FAIL" : "PASS");
+    failed |= mismatch;
+
+    mismatch = test_file_workers();
+    printf("v4 chunk engine with 1/3/auto workers: %s\n", mismatch ? "FAIL" : "PASS");
+    failed |= mismatch;
+
+    mismatch = test_file_v2_header();
+    printf("v1/v2 headers, bad iteration counts and flags: %s\n", mismatch ? "FAIL" : "PASS");
+    failed |= mismatch;
+
+    mismatch = test_file_legacy_pipeline();
+    printf("v1/v2/v3 pipelined and serial decryption: %s\n", mismatch ? "FAIL" : "PASS");
+    failed |= mismatch;
+
+    mismatch = test_file_range_unauthenticated();
+    printf("v1/v2/v3 unauthenticated range decryption: %s\n", mismatch ? "FAIL" : "PASS");
+    failed |= mismatch;
+
+    mismatch = test_file_batch_session();
+    printf("Batch session per-file keys: %s\n", mismatch ? "FAIL" : "PASS");
+    failed |= mismatch;
+
+    set_encrypt_kdf_iterations(saved_iterations);
+    set_encrypt_chunk_size(saved_chunk_size);
+    printf("\n");
+    return failed ? 1 : 0;
+}
+
 //int main(void) {
 //    printf("=======================================\n");
 //    printf("  Cryptographic Functions Test Suite\n");
@@ -350,6 +1778,7 @@ int test_aes(void) {
 //    int hmac_result = test_hmac_sha512();
 //    int pbkdf2_result = test_pbkdf2_sha512();
 //    int aes_result = test_aes();
+//    int file_result = test_file_crypto();
 //    
 //    printf("=======================================\n");
 //    printf("  Test Summary\n");
@@ -358,9 +1787,10 @@ int test_aes(void) {
 //    printf("HMAC-SHA512:  %s\n", hmac_result == 0 ? "PASS" : "FAIL");
 //    printf("PBKDF2-SHA512: %s\n", pbkdf2_result == 0 ? "PASS" : "FAIL");
 //    printf("AES:          %s\n", aes_result == 0 ? "PASS" : "FAIL");
+//    printf("File layer:   %s\n", file_result == 0 ? "PASS" : "FAIL");
 //    printf("=======================================\n");
 //    
-//    if (sha512_result == 0 && hmac_result == 0 && pbkdf2_result == 0 && aes_result == 0) {
+//    if (sha512_result == 0 && hmac_result == 0 && pbkdf2_result == 0 && aes_result == 0 && file_result == 0) {
 //        printf("All tests PASSED!\n");
 //        return 0;
 //    } else {